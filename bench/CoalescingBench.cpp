@@ -0,0 +1,95 @@
+#include "core/CommandCoalescing.hpp"
+#include "core/SerialDevices.hpp"
+#include "mock/FirmwareEmulator.hpp"
+#include "mock/MockMotor.hpp"
+#include "mock/SimulationEngine.hpp"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+using namespace FingerFlexAid;
+
+namespace
+{
+
+constexpr uint8_t kMotors = 5;
+constexpr int kUpdatesPerTick = 8; // a planner refining its setpoints several times per control period
+
+enum class Backend
+{
+    Mock,  // MockMotor on a local engine
+    Serial // SerialMotor over the loopback firmware emulator
+};
+
+struct Rig
+{
+    explicit Rig(Backend backend)
+    {
+        if (backend == Backend::Serial)
+        {
+            int hostFd = -1;
+            emulator = FirmwareEmulator::createLoopback({kMotors, 0}, hostFd);
+            auto bus = std::make_shared<SerialBus>(SerialLink::adopt(hostFd));
+            for (uint8_t i = 0; i < kMotors; ++i)
+                motors.push_back(std::make_shared<SerialMotor>(bus, i));
+            return;
+        }
+        for (uint8_t i = 0; i < kMotors; ++i)
+        {
+            auto motor = std::make_shared<MockMotor>(std::string("m").append(std::to_string(i)), engine);
+            motor->simulateHardwareDelay(std::chrono::milliseconds(0));
+            motors.push_back(std::move(motor));
+        }
+    }
+
+    SimulationEngine engine;
+    std::unique_ptr<FirmwareEmulator> emulator;
+    std::vector<std::shared_ptr<MotorController>> motors;
+};
+
+} // namespace
+
+static void BM_PlannerDirect(benchmark::State &state)
+{
+    Rig rig(static_cast<Backend>(state.range(0)));
+    int32_t step = 0;
+    for (auto _ : state)
+    {
+        ++step;
+        for (int update = 0; update < kUpdatesPerTick; ++update)
+            for (auto &motor : rig.motors)
+                benchmark::DoNotOptimize(motor->setPosition(step * 100 + update));
+    }
+    state.counters["writes_per_tick"] = kUpdatesPerTick * kMotors;
+}
+BENCHMARK(BM_PlannerDirect)->Arg(static_cast<int>(Backend::Mock))->Arg(static_cast<int>(Backend::Serial))
+    ->UseRealTime();
+
+static void BM_PlannerCoalesced(benchmark::State &state)
+{
+    Rig rig(static_cast<Backend>(state.range(0)));
+    CoalescingOptions options;
+    options.motorPositionThreshold = CoalescingOptions::kNever;
+    CoalescingGroup group;
+    std::vector<std::shared_ptr<CoalescingMotor>> motors;
+    for (auto &inner : rig.motors)
+    {
+        motors.push_back(std::make_shared<CoalescingMotor>(inner, options));
+        group.add(motors.back());
+    }
+    int32_t step = 0;
+    for (auto _ : state)
+    {
+        ++step;
+        for (int update = 0; update < kUpdatesPerTick; ++update)
+            for (auto &motor : motors)
+                benchmark::DoNotOptimize(motor->setPosition(step * 100 + update));
+        group.flush();
+    }
+    auto stats = group.getStats();
+    state.counters["writes_per_tick"] =
+        static_cast<double>(stats.sent) / static_cast<double>(std::max<int64_t>(state.iterations(), 1));
+    state.counters["dropped"] = static_cast<double>(stats.dropped);
+}
+BENCHMARK(BM_PlannerCoalesced)->Arg(static_cast<int>(Backend::Mock))->Arg(static_cast<int>(Backend::Serial))
+    ->UseRealTime();
@@ -0,0 +1,232 @@
+#include "mock/MockMotor.hpp"
+#include "mock/MockServo.hpp"
+#include "mock/SimulationEngine.hpp"
+#include "models/Motor.hpp"
+#include "models/Servo.hpp"
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace FingerFlexAid;
+
+// Setter/getter round trips on each device implementation, alternating targets so no call is a no-op
+
+static void BM_MotorSetGet(benchmark::State &state)
+{
+    Motor motor("m", 1000, 10);
+    double speed = 100;
+    for (auto _ : state)
+    {
+        speed = -speed;
+        motor.setSpeed(speed);
+        benchmark::DoNotOptimize(motor.getSpeed());
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_MotorSetGet);
+
+static void BM_ServoImplSetGet(benchmark::State &state)
+{
+    ServoImpl servo(0, 180, 50);
+    double angle = 45;
+    for (auto _ : state)
+    {
+        angle = 180 - angle;
+        servo.setAngle(angle);
+        benchmark::DoNotOptimize(servo.getAngle());
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_ServoImplSetGet);
+
+static void BM_MockMotorSetGet(benchmark::State &state)
+{
+    SimulationEngine engine;
+    MockMotor motor("m", engine);
+    int16_t speed = 100;
+    for (auto _ : state)
+    {
+        speed = static_cast<int16_t>(-speed);
+        benchmark::DoNotOptimize(motor.setSpeed(speed));
+        benchmark::DoNotOptimize(motor.getCurrentSpeed());
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_MockMotorSetGet);
+
+static void BM_MockServoSetGet(benchmark::State &state)
+{
+    SimulationEngine engine;
+    MockServo servo("s", engine);
+    uint16_t angle = 45;
+    for (auto _ : state)
+    {
+        angle = static_cast<uint16_t>(180 - angle);
+        benchmark::DoNotOptimize(servo.setAngle(angle));
+        benchmark::DoNotOptimize(servo.getCurrentAngle());
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_MockServoSetGet);
+
+// Consistent multi-field reads, compared with reading the same fields one getter at a time
+static void BM_MotorSnapshot(benchmark::State &state)
+{
+    Motor motor("m", 1000, 10);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(motor.getSnapshot());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MotorSnapshot);
+
+static void BM_ServoImplSnapshot(benchmark::State &state)
+{
+    ServoImpl servo(0, 180, 50);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(servo.getSnapshot());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ServoImplSnapshot);
+
+static void BM_ServoImplGetters(benchmark::State &state)
+{
+    ServoImpl servo(0, 180, 50);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(servo.getAngle());
+        benchmark::DoNotOptimize(servo.getSpeed());
+        benchmark::DoNotOptimize(servo.isMoving());
+        benchmark::DoNotOptimize(servo.hasError());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ServoImplGetters);
+
+// Mock lifetime: a view attached to a shared engine, and a standalone mock that owns its engine thread
+static void BM_MockMotorLifetimeShared(benchmark::State &state)
+{
+    SimulationEngine engine;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::make_unique<MockMotor>("m", engine));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MockMotorLifetimeShared);
+
+static void BM_MockServoLifetimeShared(benchmark::State &state)
+{
+    SimulationEngine engine;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::make_unique<MockServo>("s", engine));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MockServoLifetimeShared);
+
+static void BM_MockMotorLifetimeStandalone(benchmark::State &state)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::make_unique<MockMotor>("m"));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MockMotorLifetimeStandalone)->UseRealTime();
+
+static void BM_MockServoLifetimeStandalone(benchmark::State &state)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::make_unique<MockServo>("s"));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MockServoLifetimeStandalone)->UseRealTime();
+
+// Hand-off latency between two threads that each wait for the other's motor to report an error: the
+// futex-backed waitForError() against the isError()/sleep_for() loop callers used before it existed
+namespace
+{
+
+bool pollForError(const Motor &motor, const std::atomic<bool> &running)
+{
+    while (!motor.isError())
+    {
+        if (!running.load(std::memory_order_relaxed))
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+template <typename Wait> void runErrorPingPong(benchmark::State &state, Wait wait)
+{
+    Motor ping("ping", 1000, 10);
+    Motor pong("pong", 1000, 10);
+    std::atomic<bool> running{true};
+    std::thread responder([&] {
+        while (wait(ping, running))
+        {
+            ping.clearError();
+            pong.simulateError("pong");
+        }
+    });
+    for (auto _ : state)
+    {
+        ping.simulateError("ping");
+        wait(pong, running);
+        pong.clearError();
+    }
+    running = false;
+    ping.simulateError("shutdown");
+    responder.join();
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+static void BM_ErrorHandoffPolled(benchmark::State &state)
+{
+    runErrorPingPong(state, pollForError);
+}
+BENCHMARK(BM_ErrorHandoffPolled)->UseRealTime();
+
+static void BM_ErrorHandoffWaited(benchmark::State &state)
+{
+    runErrorPingPong(state, [](const Motor &motor, const std::atomic<bool> &running) {
+        while (!motor.waitForError(std::chrono::milliseconds(100)))
+            if (!running.load(std::memory_order_relaxed))
+                return false;
+        return running.load(std::memory_order_relaxed);
+    });
+}
+BENCHMARK(BM_ErrorHandoffWaited)->UseRealTime();
+
+// Fault storm: a rejected setpoint raises an error, which is read back and cleared
+static void BM_MockMotorFaultStorm(benchmark::State &state)
+{
+    SimulationEngine engine;
+    MockMotor motor("m", engine);
+    motor.simulateHardwareDelay(std::chrono::milliseconds(0));
+    int16_t speed = 2000;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(motor.setSpeed(++speed > 30000 ? speed = 2000 : speed));
+        benchmark::DoNotOptimize(motor.getLastErrorRecord());
+        motor.clearError();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MockMotorFaultStorm);
+
+static void BM_MockMotorFaultStormMessage(benchmark::State &state)
+{
+    SimulationEngine engine;
+    MockMotor motor("m", engine);
+    motor.simulateHardwareDelay(std::chrono::milliseconds(0));
+    int16_t speed = 2000;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(motor.setSpeed(++speed > 30000 ? speed = 2000 : speed));
+        benchmark::DoNotOptimize(motor.getLastError());
+        motor.clearError();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MockMotorFaultStormMessage);
@@ -0,0 +1,314 @@
+#include "core/DeviceManagerImpl.hpp"
+#include "mock/MockMotor.hpp"
+#include "mock/SimulationEngine.hpp"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace FingerFlexAid;
+
+namespace
+{
+
+constexpr int kDeviceCount = 64;
+
+std::string motorId(int i)
+{
+    return std::string("m").append(std::to_string(i));
+}
+
+// The registry as it was before the snapshot read path: every lookup takes one shared mutex.
+class MutexRegistry
+{
+  public:
+    void registerMotor(const std::string &id, std::shared_ptr<MotorController> motor)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        motors_[id] = std::move(motor);
+    }
+
+    std::shared_ptr<MotorController> getMotor(const std::string &id) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = motors_.find(id);
+        return it != motors_.end() ? it->second : nullptr;
+    }
+
+    bool isAnyDeviceMoving() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &kv : motors_)
+            if (kv.second->isMoving())
+                return true;
+        return false;
+    }
+
+  private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<MotorController>> motors_;
+};
+
+struct Fleet
+{
+    SimulationEngine engine;
+    std::vector<std::shared_ptr<MockMotor>> motors;
+    std::vector<std::string> ids;
+    std::vector<MotorHandle> handles;
+    DeviceManagerImpl snapshotManager;
+    MutexRegistry mutexManager;
+
+    Fleet()
+    {
+        for (int i = 0; i < kDeviceCount; ++i)
+        {
+            ids.push_back(motorId(i));
+            motors.push_back(std::make_shared<MockMotor>(ids.back(), engine));
+            handles.push_back(snapshotManager.registerMotor(ids.back(), motors.back()));
+            mutexManager.registerMotor(ids.back(), motors.back());
+        }
+    }
+};
+
+Fleet &fleet()
+{
+    static Fleet instance;
+    return instance;
+}
+
+// Registries of a given size, every tenth motor in error, spread over engines of 256 motors each
+struct ScaledFleet
+{
+    std::vector<std::unique_ptr<SimulationEngine>> engines;
+    std::vector<std::shared_ptr<MockMotor>> motors;
+    std::vector<MotorHandle> handles;
+    DeviceManagerImpl manager;
+
+    explicit ScaledFleet(int64_t count)
+    {
+        for (int64_t i = 0; i < count; ++i)
+        {
+            if (i % 256 == 0)
+                engines.push_back(std::make_unique<SimulationEngine>());
+            std::string id = motorId(static_cast<int>(i));
+            motors.push_back(std::make_shared<MockMotor>(id, *engines.back()));
+            handles.push_back(manager.registerMotor(id, motors.back()));
+            if (i % 10 == 9)
+                motors.back()->simulateError("bench");
+        }
+    }
+};
+
+ScaledFleet &scaledFleet(int64_t count)
+{
+    static std::mutex mutex;
+    static std::map<int64_t, std::unique_ptr<ScaledFleet>> fleets;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &entry = fleets[count];
+    if (!entry)
+        entry = std::make_unique<ScaledFleet>(count);
+    return *entry;
+}
+
+void fleetSizes(benchmark::internal::Benchmark *bench)
+{
+    bench->Arg(16)->Arg(256)->Arg(4096)->ThreadRange(1, 8)->UseRealTime();
+}
+
+} // namespace
+
+// N reader threads polling lookups, as the UI, logger and control loop do
+static void BM_SnapshotGetMotor(benchmark::State &state)
+{
+    auto &f = fleet();
+    size_t i = static_cast<size_t>(state.thread_index());
+    for (auto _ : state)
+        benchmark::DoNotOptimize(f.snapshotManager.getMotor(f.ids[i++ % kDeviceCount]));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SnapshotGetMotor)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_MutexGetMotor(benchmark::State &state)
+{
+    auto &f = fleet();
+    size_t i = static_cast<size_t>(state.thread_index());
+    for (auto _ : state)
+        benchmark::DoNotOptimize(f.mutexManager.getMotor(f.ids[i++ % kDeviceCount]));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MutexGetMotor)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_SnapshotIsAnyDeviceMoving(benchmark::State &state)
+{
+    auto &f = fleet();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(f.snapshotManager.isAnyDeviceMoving());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SnapshotIsAnyDeviceMoving)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_MutexIsAnyDeviceMoving(benchmark::State &state)
+{
+    auto &f = fleet();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(f.mutexManager.isAnyDeviceMoving());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MutexIsAnyDeviceMoving)->ThreadRange(1, 8)->UseRealTime();
+
+// Single-threaded lookup cost: string hashing against dense handle indexing
+static void BM_GetMotorByName(benchmark::State &state)
+{
+    auto &f = fleet();
+    size_t i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(f.snapshotManager.getMotor(f.ids[i++ % kDeviceCount]));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetMotorByName);
+
+// Names held as views into a larger buffer, such as a parsed config line
+static void BM_GetMotorByView(benchmark::State &state)
+{
+    auto &f = fleet();
+    std::string line;
+    std::vector<std::pair<size_t, size_t>> spans;
+    for (const auto &id : f.ids)
+    {
+        spans.emplace_back(line.size(), id.size());
+        line.append(id).push_back(',');
+    }
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        auto [offset, length] = spans[i++ % kDeviceCount];
+        benchmark::DoNotOptimize(f.snapshotManager.getMotor(std::string_view(line).substr(offset, length)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetMotorByView);
+
+static void BM_GetMotorByHandle(benchmark::State &state)
+{
+    auto &f = fleet();
+    size_t i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(f.snapshotManager.getMotor(f.handles[i++ % kDeviceCount]));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetMotorByHandle);
+
+// Commanding the whole fleet: one setter call per motor against one batch for all of them
+static void BM_SingleCallCommands(benchmark::State &state)
+{
+    auto &f = fleet();
+    int16_t speed = 100;
+    for (auto _ : state)
+    {
+        speed = static_cast<int16_t>(-speed);
+        for (const auto &handle : f.handles)
+            benchmark::DoNotOptimize(f.snapshotManager.getMotor(handle)->setSpeed(speed));
+    }
+    state.SetItemsProcessed(state.iterations() * kDeviceCount);
+}
+BENCHMARK(BM_SingleCallCommands);
+
+static void BM_BatchCommands(benchmark::State &state)
+{
+    auto &f = fleet();
+    CommandBatch batch;
+    int16_t speed = 100;
+    for (auto _ : state)
+    {
+        speed = static_cast<int16_t>(-speed);
+        batch.clear();
+        for (const auto &handle : f.handles)
+            batch.add(handle, MotorCommand::speed(speed));
+        benchmark::DoNotOptimize(f.snapshotManager.applyBatch(batch));
+    }
+    state.SetItemsProcessed(state.iterations() * kDeviceCount);
+}
+BENCHMARK(BM_BatchCommands);
+
+// Scaling with registry size and reader threads
+static void BM_ScaledGetMotorByHandle(benchmark::State &state)
+{
+    auto &f = scaledFleet(state.range(0));
+    size_t i = static_cast<size_t>(state.thread_index());
+    for (auto _ : state)
+        benchmark::DoNotOptimize(f.manager.getMotor(f.handles[i++ % f.handles.size()]));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScaledGetMotorByHandle)->Apply(fleetSizes);
+
+static void BM_ScaledIsAnyDeviceInError(benchmark::State &state)
+{
+    auto &f = scaledFleet(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(f.manager.isAnyDeviceInError());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScaledIsAnyDeviceInError)->Apply(fleetSizes);
+
+static void BM_ScaledGetDevicesInError(benchmark::State &state)
+{
+    auto &f = scaledFleet(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(f.manager.getDevicesInError());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScaledGetDevicesInError)->Apply(fleetSizes);
+
+static void BM_ScaledGetMotorIds(benchmark::State &state)
+{
+    auto &f = scaledFleet(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(f.manager.getMotorIds());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScaledGetMotorIds)->Apply(fleetSizes);
+
+// The same polls into a buffer reused across iterations, as a monitor would keep one
+static void BM_ScaledFillDevicesInError(benchmark::State &state)
+{
+    auto &f = scaledFleet(state.range(0));
+    std::vector<std::string> ids;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(f.manager.fillDevicesInError(ids));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScaledFillDevicesInError)->Apply(fleetSizes);
+
+static void BM_ScaledFillMotorIds(benchmark::State &state)
+{
+    auto &f = scaledFleet(state.range(0));
+    std::vector<std::string> ids;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(f.manager.fillMotorIds(ids));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScaledFillMotorIds)->Apply(fleetSizes);
+
+// Teardown of a fleet of standalone mocks, each owning an engine thread: shutdownAll() followed by
+// dropping the manager and the devices, which joins every thread
+static void BM_StandaloneFleetTeardown(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto manager = std::make_unique<DeviceManagerImpl>();
+        for (int i = 0; i < state.range(0); ++i)
+            manager->registerMotor(motorId(i), std::make_shared<MockMotor>(motorId(i)));
+        state.ResumeTiming();
+
+        manager->shutdownAll();
+        manager.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StandaloneFleetTeardown)->Arg(16)->Arg(256)->Iterations(3)->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,137 @@
+#include "core/DeviceManagerImpl.hpp"
+#include "mock/MockMotor.hpp"
+#include "mock/SimulationEngine.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace FingerFlexAid;
+
+namespace
+{
+
+// Devices per simulation engine, i.e. per batch domain the e-stop holds once
+constexpr int kDevicesPerEngine = 256;
+// Devices without a domain, each stopped as a task of its own
+constexpr int kLooseDevices = 32;
+// Round-trip of the one slow device in the slow fleet, e.g. a serial bridge
+constexpr std::chrono::milliseconds kSlowStop{5};
+
+// A motor with no batch domain, like a device behind its own link; `delay` models that link's round-trip.
+class LooseMotor : public MockMotor
+{
+  public:
+    LooseMotor(const std::string &id, SimulationEngine &engine, std::chrono::microseconds delay)
+        : MockMotor(id, engine), delay_(delay)
+    {
+    }
+    BatchDomain *getBatchDomain() override
+    {
+        return nullptr;
+    }
+    bool applyCommand(const MotorCommand &command) override
+    {
+        if (command.type != MotorCommand::Type::EmergencyStop)
+            return false;
+        if (delay_.count() > 0)
+            std::this_thread::sleep_for(delay_);
+        return emergencyStop();
+    }
+
+  private:
+    std::chrono::microseconds delay_;
+};
+
+enum class Loose
+{
+    None, // every device shares an engine's domain
+    Fast, // plus kLooseDevices devices without a domain
+    Slow  // the same, one of which takes kSlowStop to stop
+};
+
+struct StopFleet
+{
+    std::vector<std::unique_ptr<SimulationEngine>> engines;
+    std::vector<std::shared_ptr<MockMotor>> motors;
+    DeviceManagerImpl manager;
+
+    explicit StopFleet(int count, Loose loose = Loose::None)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            if (i % kDevicesPerEngine == 0)
+                engines.push_back(std::make_unique<SimulationEngine>());
+            std::string id = std::string("m").append(std::to_string(i));
+            motors.push_back(std::make_shared<MockMotor>(id, *engines.back()));
+            manager.registerMotor(id, motors.back());
+        }
+        if (loose == Loose::None)
+            return;
+        // The loose motors live in an engine of their own, but the manager sees no domain for them
+        engines.push_back(std::make_unique<SimulationEngine>());
+        for (int i = 0; i < kLooseDevices; ++i)
+        {
+            std::string id = std::string("loose").append(std::to_string(i));
+            auto delay = loose == Loose::Slow && i == 0 ? kSlowStop : std::chrono::microseconds{0};
+            motors.push_back(std::make_shared<LooseMotor>(id, *engines.back(), delay));
+            manager.registerMotor(id, motors.back());
+        }
+    }
+
+    void rearm()
+    {
+        for (auto &motor : motors)
+        {
+            motor->clearError();
+            motor->setSpeed(500);
+        }
+    }
+
+    bool allStopped() const
+    {
+        return std::none_of(motors.begin(), motors.end(), [](const auto &motor) { return motor->isMoving(); });
+    }
+};
+
+double percentile(std::vector<double> &samples, double p)
+{
+    auto index = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(index), samples.end());
+    return samples[index];
+}
+
+} // namespace
+
+// Time from emergencyStopAll() until every device has stopped; the call returns only once they all have.
+// Reports p50/p99/max in microseconds.
+static void BM_EmergencyStopAll(benchmark::State &state)
+{
+    StopFleet fleet(static_cast<int>(state.range(0)), static_cast<Loose>(state.range(1)));
+    std::vector<double> samples;
+    for (auto _ : state)
+    {
+        fleet.rearm();
+        auto begin = std::chrono::steady_clock::now();
+        fleet.manager.emergencyStopAll();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        state.SetIterationTime(elapsed.count());
+        samples.push_back(elapsed.count() * 1e6);
+        if (!fleet.allStopped())
+            state.SkipWithError("device still moving after emergencyStopAll");
+    }
+    if (samples.empty())
+        return;
+    state.counters["p50_us"] = percentile(samples, 0.50);
+    state.counters["p99_us"] = percentile(samples, 0.99);
+    state.counters["max_us"] = *std::max_element(samples.begin(), samples.end());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+// Second argument: 0 domain groups only, 1 with kLooseDevices devices without a domain, 2 with one of those slow
+BENCHMARK(BM_EmergencyStopAll)
+    ->ArgsProduct({{10, 100, 1000, 10000}, {0, 1, 2}})
+    ->ArgNames({"devices", "loose"})
+    ->UseManualTime();
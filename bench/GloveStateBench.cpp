@@ -0,0 +1,250 @@
+#include "mock/MockMotor.hpp"
+#include "mock/MockServo.hpp"
+#include "mock/SimulationEngine.hpp"
+#include "models/GloveState.hpp"
+#include "models/StaticGlove.hpp"
+#include "utils/EventLog.hpp"
+#include "utils/SessionRecording.hpp"
+#include <array>
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace FingerFlexAid;
+
+namespace
+{
+
+// A glove of mock devices on one engine; if faulty, every tenth one is in error. The log discards what it
+// drains.
+struct Glove
+{
+    SimulationEngine engine;
+    std::vector<std::shared_ptr<MockMotor>> motors;
+    std::vector<std::shared_ptr<MockServo>> servos;
+    EventLog log{1024, nullptr};
+    GloveState glove{log};
+
+    Glove(int64_t devices, bool faulty)
+    {
+        for (int64_t i = 0; i < devices / 2; ++i)
+        {
+            motors.push_back(std::make_shared<MockMotor>(std::string("m").append(std::to_string(i)), engine));
+            servos.push_back(std::make_shared<MockServo>(std::string("s").append(std::to_string(i)), engine));
+            if (faulty && i % 10 == 9)
+            {
+                motors.back()->simulateError("bench");
+                servos.back()->simulateError("bench");
+            }
+            glove.addMotor(motors.back());
+            glove.addServo(servos.back());
+        }
+    }
+};
+
+void gloveSizes(benchmark::internal::Benchmark *bench)
+{
+    bench->Arg(16)->Arg(256)->Arg(4096);
+}
+
+} // namespace
+
+static void BM_GloveStateUpdate(benchmark::State &state)
+{
+    Glove glove(state.range(0), true);
+    for (auto _ : state)
+        glove.glove.update();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["dropped"] = static_cast<double>(glove.log.getDroppedCount());
+}
+BENCHMARK(BM_GloveStateUpdate)->Apply(gloveSizes);
+
+// The same update with every device state appended to a session recording
+static void BM_GloveStateUpdateRecorded(benchmark::State &state)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "fingerflexaid-bench-glove.ffs").string();
+    {
+        Glove glove(state.range(0), true);
+        auto recorder = SessionRecorder::create(path);
+        glove.glove.setRecorder(recorder.get());
+        for (auto _ : state)
+            glove.glove.update();
+        glove.glove.setRecorder(nullptr);
+        state.counters["dropped"] = static_cast<double>(recorder->getDroppedCount());
+    }
+    std::filesystem::remove(path);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GloveStateUpdateRecorded)->Apply(gloveSizes);
+
+// Worst case: a healthy glove, where no early exit is possible
+static void BM_GloveStateHasError(benchmark::State &state)
+{
+    Glove glove(state.range(0), false);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(glove.glove.hasError());
+}
+BENCHMARK(BM_GloveStateHasError)->Apply(gloveSizes);
+
+namespace
+{
+
+// A five-finger glove of mock devices on one engine, driven both through GloveState and the virtual
+// controller interfaces and through a StaticGlove over the same devices.
+struct FiveFingerGlove
+{
+    using MockFinger = Finger<MockMotor, MockServo>;
+    using Static = StaticGlove<MockFinger, MockFinger, MockFinger, MockFinger, MockFinger>;
+
+    SimulationEngine engine;
+    std::vector<std::shared_ptr<MockMotor>> motors;
+    std::vector<std::shared_ptr<MockServo>> servos;
+    std::vector<std::shared_ptr<MotorController>> motorControllers;
+    std::vector<std::shared_ptr<Servo>> servoControllers;
+    EventLog log{1024, nullptr};
+    GloveState dynamicGlove{log};
+
+    FiveFingerGlove()
+    {
+        for (int i = 0; i < 5; ++i)
+        {
+            motors.push_back(std::make_shared<MockMotor>(std::string("m").append(std::to_string(i)), engine));
+            servos.push_back(std::make_shared<MockServo>(std::string("s").append(std::to_string(i)), engine));
+            motors.back()->simulateHardwareDelay(std::chrono::milliseconds(0));
+            motors.back()->setMaxSpeed(1000);
+            motorControllers.push_back(motors.back());
+            servoControllers.push_back(servos.back());
+            dynamicGlove.addMotor(motors.back());
+            dynamicGlove.addServo(servos.back());
+        }
+    }
+
+    Static makeStatic()
+    {
+        return Static(log, MockFinger{*motors[0], *servos[0]}, MockFinger{*motors[1], *servos[1]},
+                      MockFinger{*motors[2], *servos[2]}, MockFinger{*motors[3], *servos[3]},
+                      MockFinger{*motors[4], *servos[4]});
+    }
+};
+
+// The same with the Motor and ServoImpl models, which keep their state in the device itself
+struct FiveFingerModelGlove
+{
+    using ModelFinger = Finger<Motor, ServoImpl>;
+    using Static = StaticGlove<ModelFinger, ModelFinger, ModelFinger, ModelFinger, ModelFinger>;
+
+    std::vector<std::shared_ptr<Motor>> motors;
+    std::vector<std::shared_ptr<ServoImpl>> servos;
+    std::vector<std::shared_ptr<Servo>> servoControllers;
+    EventLog log{1024, nullptr};
+    GloveState dynamicGlove{log};
+
+    FiveFingerModelGlove()
+    {
+        for (int i = 0; i < 5; ++i)
+        {
+            motors.push_back(std::make_shared<Motor>(std::string("m").append(std::to_string(i)), 1000, 10));
+            servos.push_back(std::make_shared<ServoImpl>(0, 180, 50));
+            servoControllers.push_back(servos.back());
+            dynamicGlove.addMotor(motors.back());
+            dynamicGlove.addServo(servos.back());
+        }
+    }
+
+    Static makeStatic()
+    {
+        return Static(log, ModelFinger{*motors[0], *servos[0]}, ModelFinger{*motors[1], *servos[1]},
+                      ModelFinger{*motors[2], *servos[2]}, ModelFinger{*motors[3], *servos[3]},
+                      ModelFinger{*motors[4], *servos[4]});
+    }
+};
+
+std::array<int16_t, 5> tickSpeeds(int64_t tick)
+{
+    std::array<int16_t, 5> speeds;
+    for (size_t i = 0; i < speeds.size(); ++i)
+        speeds[i] = static_cast<int16_t>(100 + (tick + static_cast<int64_t>(i)) % 50);
+    return speeds;
+}
+
+std::array<uint16_t, 5> tickAngles(int64_t tick)
+{
+    std::array<uint16_t, 5> angles;
+    for (size_t i = 0; i < angles.size(); ++i)
+        angles[i] = static_cast<uint16_t>(30 + (tick + static_cast<int64_t>(i)) % 90);
+    return angles;
+}
+
+} // namespace
+
+// One control tick: update() plus a speed and an angle for every finger, through the virtual interfaces
+static void BM_GloveTickVirtual(benchmark::State &state)
+{
+    FiveFingerGlove glove;
+    int64_t tick = 0;
+    for (auto _ : state)
+    {
+        glove.dynamicGlove.update();
+        const auto speeds = tickSpeeds(tick);
+        const auto angles = tickAngles(tick++);
+        for (size_t i = 0; i < speeds.size(); ++i)
+        {
+            glove.motorControllers[i]->setSpeed(speeds[i]);
+            glove.servoControllers[i]->setAngle(angles[i]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 5);
+}
+BENCHMARK(BM_GloveTickVirtual);
+
+// The same tick through a StaticGlove, with every call resolved at compile time
+static void BM_GloveTickStatic(benchmark::State &state)
+{
+    FiveFingerGlove glove;
+    auto staticGlove = glove.makeStatic();
+    int64_t tick = 0;
+    for (auto _ : state)
+    {
+        staticGlove.update();
+        const auto speeds = tickSpeeds(tick);
+        staticGlove.command(speeds, tickAngles(tick++));
+    }
+    state.SetItemsProcessed(state.iterations() * 5);
+}
+BENCHMARK(BM_GloveTickStatic);
+
+static void BM_GloveTickVirtualModels(benchmark::State &state)
+{
+    FiveFingerModelGlove glove;
+    int64_t tick = 0;
+    for (auto _ : state)
+    {
+        glove.dynamicGlove.update();
+        const auto speeds = tickSpeeds(tick);
+        const auto angles = tickAngles(tick++);
+        for (size_t i = 0; i < speeds.size(); ++i)
+        {
+            glove.motors[i]->setSpeed(speeds[i]);
+            glove.servoControllers[i]->setAngle(angles[i]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 5);
+}
+BENCHMARK(BM_GloveTickVirtualModels);
+
+static void BM_GloveTickStaticModels(benchmark::State &state)
+{
+    FiveFingerModelGlove glove;
+    auto staticGlove = glove.makeStatic();
+    int64_t tick = 0;
+    for (auto _ : state)
+    {
+        staticGlove.update();
+        const auto speeds = tickSpeeds(tick);
+        staticGlove.command(speeds, tickAngles(tick++));
+    }
+    state.SetItemsProcessed(state.iterations() * 5);
+}
+BENCHMARK(BM_GloveTickStaticModels);
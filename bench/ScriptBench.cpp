@@ -0,0 +1,106 @@
+#include "core/Script.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+
+using namespace FingerFlexAid;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+ScriptTask oneShot(int64_t &counter)
+{
+    ++counter;
+    co_return;
+}
+
+ScriptTask periodic(int64_t &counter)
+{
+    for (;;)
+    {
+        co_await sleepFor(1ms);
+        ++counter;
+    }
+}
+
+ScriptTask polling(const int64_t &now, int64_t &counter, int64_t phase)
+{
+    for (;;)
+    {
+        const int64_t until = now + phase % 7 + 1;
+        co_await waitUntil([&] { return now >= until; });
+        ++counter;
+    }
+}
+
+} // namespace
+
+// Starting and finishing a script: frame allocation from the pool, one resume, reaping
+static void BM_ScriptSpawnAndComplete(benchmark::State &state)
+{
+    ScriptScheduler scheduler;
+    int64_t counter = 0;
+    auto now = 0ns;
+    for (auto _ : state)
+    {
+        scheduler.spawn(oneShot(counter));
+        scheduler.tick(now += 1ms);
+    }
+    state.SetItemsProcessed(counter);
+}
+BENCHMARK(BM_ScriptSpawnAndComplete);
+
+// One tick resuming every script from the timer heap; items are resumes
+static void BM_ScriptTickTimers(benchmark::State &state)
+{
+    ScriptScheduler scheduler;
+    int64_t counter = 0;
+    for (int64_t i = 0; i < state.range(0); ++i)
+        scheduler.spawn(periodic(counter));
+    auto now = 0ns;
+    scheduler.tick(now);
+    for (auto _ : state)
+        scheduler.tick(now += 1ms);
+    state.SetItemsProcessed(counter);
+}
+BENCHMARK(BM_ScriptTickTimers)->Arg(100)->Arg(1000)->Arg(10000);
+
+// One tick polling every script's device condition, about a quarter of which come true
+static void BM_ScriptTickConditions(benchmark::State &state)
+{
+    ScriptScheduler scheduler;
+    int64_t now = 0;
+    int64_t counter = 0;
+    for (int64_t i = 0; i < state.range(0); ++i)
+        scheduler.spawn(polling(now, counter, i));
+    scheduler.tick(std::chrono::milliseconds(now));
+    for (auto _ : state)
+        scheduler.tick(std::chrono::milliseconds(++now));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["resumes_per_tick"] = static_cast<double>(counter) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_ScriptTickConditions)->Arg(100)->Arg(1000)->Arg(10000);
+
+// Frame allocation alone, pooled against the global allocator, for a typical 256-byte frame
+static void BM_FramePoolAllocate(benchmark::State &state)
+{
+    FramePool pool;
+    for (auto _ : state)
+    {
+        void *frame = pool.allocate(256);
+        benchmark::DoNotOptimize(frame);
+        pool.deallocate(frame, 256);
+    }
+}
+BENCHMARK(BM_FramePoolAllocate);
+
+static void BM_GlobalNewFrame(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        void *frame = ::operator new(256);
+        benchmark::DoNotOptimize(frame);
+        ::operator delete(frame);
+    }
+}
+BENCHMARK(BM_GlobalNewFrame);
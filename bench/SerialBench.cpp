@@ -0,0 +1,156 @@
+#include "core/DeviceManagerImpl.hpp"
+#include "core/SerialDevices.hpp"
+#include "mock/FirmwareEmulator.hpp"
+#include "utils/SerialLink.hpp"
+#include "utils/SerialProtocol.hpp"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+using namespace FingerFlexAid;
+
+namespace
+{
+
+// A full control-loop frame: a position for each of five motors and an angle for each of five servos
+void buildCommandFrame(FrameWriter &writer, int32_t step)
+{
+    writer.begin(FrameType::Request);
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+        writer.add(RecordType::MotorSetPosition, i, step + i);
+        writer.add(RecordType::ServoSetAngle, i, (step + i) % 180);
+    }
+}
+
+enum class Transport
+{
+    Loopback,
+    Pty
+};
+
+std::shared_ptr<SerialBus> connect(Transport transport, const FirmwareEmulator::Options &options,
+                                   std::unique_ptr<FirmwareEmulator> &emulator)
+{
+    if (transport == Transport::Pty)
+    {
+        emulator = FirmwareEmulator::createPty(options);
+        auto link = emulator ? SerialLink::open(emulator->getDevicePath()) : nullptr;
+        return link ? std::make_shared<SerialBus>(std::move(link)) : nullptr;
+    }
+    int hostFd = -1;
+    emulator = FirmwareEmulator::createLoopback(options, hostFd);
+    return emulator ? std::make_shared<SerialBus>(SerialLink::adopt(hostFd)) : nullptr;
+}
+
+} // namespace
+
+static void BM_SerialEncodeFrame(benchmark::State &state)
+{
+    FrameWriter writer;
+    int32_t step = 0;
+    for (auto _ : state)
+    {
+        buildCommandFrame(writer, ++step);
+        benchmark::DoNotOptimize(writer.finish(static_cast<uint8_t>(step)).data());
+    }
+    state.SetItemsProcessed(state.iterations() * 10);
+}
+BENCHMARK(BM_SerialEncodeFrame);
+
+static void BM_SerialParseFrame(benchmark::State &state)
+{
+    // A back-to-back stream of frames, parsed in place as the receive thread does
+    FrameWriter writer;
+    std::vector<uint8_t> stream;
+    for (int i = 0; i < 64; ++i)
+    {
+        buildCommandFrame(writer, i);
+        auto frame = writer.finish(static_cast<uint8_t>(i));
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    for (auto _ : state)
+    {
+        std::span<const uint8_t> remaining(stream);
+        FrameView frame;
+        size_t consumed = 0;
+        int64_t records = 0;
+        while (parseFrame(remaining, frame, consumed) == ParseStatus::Frame)
+        {
+            RecordReader reader(frame.payload);
+            for (Record record; reader.next(record);)
+                records += record.value;
+            remaining = remaining.subspan(consumed);
+        }
+        benchmark::DoNotOptimize(records);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(stream.size()));
+}
+BENCHMARK(BM_SerialParseFrame);
+
+static void BM_SerialCrc16(benchmark::State &state)
+{
+    std::vector<uint8_t> data(kMaxPayload, 0x5A);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(crc16(data));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+BENCHMARK(BM_SerialCrc16);
+
+// One command per frame, waiting for its ack: the round-trip latency of the link
+static void BM_SerialRoundTrip(benchmark::State &state)
+{
+    std::unique_ptr<FirmwareEmulator> emulator;
+    auto bus = connect(static_cast<Transport>(state.range(0)), {1, 1}, emulator);
+    if (!bus)
+    {
+        state.SkipWithError("transport unavailable");
+        return;
+    }
+    SerialMotor motor(bus, 0);
+    int32_t position = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(motor.setPosition(++position));
+    state.counters["timeouts"] = static_cast<double>(bus->getLink().getStats().timeouts);
+}
+BENCHMARK(BM_SerialRoundTrip)->Arg(static_cast<int>(Transport::Loopback))->Arg(static_cast<int>(Transport::Pty))
+    ->UseRealTime();
+
+// Ten devices commanded through DeviceManager::applyBatch, which the bus sends as one frame
+static void BM_SerialBatchThroughput(benchmark::State &state)
+{
+    std::unique_ptr<FirmwareEmulator> emulator;
+    auto bus = connect(static_cast<Transport>(state.range(0)), {5, 5}, emulator);
+    if (!bus)
+    {
+        state.SkipWithError("transport unavailable");
+        return;
+    }
+    DeviceManagerImpl manager;
+    std::vector<MotorHandle> motors;
+    std::vector<ServoHandle> servos;
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+        motors.push_back(manager.registerMotor(std::string("m").append(std::to_string(i)),
+                                               std::make_shared<SerialMotor>(bus, i)));
+        servos.push_back(manager.registerServo(std::string("s").append(std::to_string(i)),
+                                               std::make_shared<SerialServo>(bus, i)));
+    }
+    CommandBatch batch;
+    int32_t step = 0;
+    for (auto _ : state)
+    {
+        batch.clear();
+        ++step;
+        for (size_t i = 0; i < 5; ++i)
+        {
+            batch.add(motors[i], MotorCommand::position(step));
+            batch.add(servos[i], ServoCommand::angle(static_cast<uint16_t>(step % 180)));
+        }
+        benchmark::DoNotOptimize(manager.applyBatch(batch));
+    }
+    state.SetItemsProcessed(state.iterations() * 10);
+    state.counters["frames"] = static_cast<double>(emulator->getFramesReceived());
+}
+BENCHMARK(BM_SerialBatchThroughput)->Arg(static_cast<int>(Transport::Loopback))->Arg(static_cast<int>(Transport::Pty))
+    ->UseRealTime();
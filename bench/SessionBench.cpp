@@ -0,0 +1,56 @@
+#include "utils/SessionRecording.hpp"
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <random>
+
+using namespace FingerFlexAid;
+
+namespace
+{
+
+std::string benchPath(const char *name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+} // namespace
+
+// Cost on the recording thread: a slot claim and a copy into the mapped file
+static void BM_SessionRecord(benchmark::State &state)
+{
+    const std::string path = benchPath("fingerflexaid-bench-record.ffs");
+    {
+        auto recorder = SessionRecorder::create(path);
+        auto record = SessionRecord::state(SessionRecordType::MotorState, "motor", 100, 0, true, false);
+        for (auto _ : state)
+        {
+            record.position += 1;
+            benchmark::DoNotOptimize(recorder->record(record));
+        }
+        state.counters["dropped"] = static_cast<double>(recorder->getDroppedCount());
+    }
+    std::filesystem::remove(path);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SessionRecord);
+
+// Random seeks into a session of the given number of records, from a cold start of the reader
+static void BM_SessionSeek(benchmark::State &state)
+{
+    const std::string path = benchPath("fingerflexaid-bench-seek.ffs");
+    {
+        auto recorder = SessionRecorder::create(path);
+        auto record = SessionRecord::state(SessionRecordType::MotorState, "motor", 100, 0, true, false);
+        for (int64_t i = 0; i < state.range(0); ++i)
+            recorder->record(record);
+    }
+    auto session = SessionReader::open(path);
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<int64_t> time(0, session->getDuration().count());
+    for (auto _ : state)
+        benchmark::DoNotOptimize(session->seek(std::chrono::nanoseconds(time(random))));
+    session.reset();
+    std::filesystem::remove(path);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SessionSeek)->Arg(1 << 10)->Arg(1 << 20)->Arg(1 << 22);
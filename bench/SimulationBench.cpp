@@ -0,0 +1,76 @@
+#include "mock/ActuatorStore.hpp"
+#include "mock/MockMotor.hpp"
+#include "mock/MockServo.hpp"
+#include "mock/SimulationEngine.hpp"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace FingerFlexAid;
+
+namespace
+{
+
+void actuatorCounts(benchmark::internal::Benchmark *bench)
+{
+    bench->Arg(1000)->Arg(10000)->Arg(100000);
+}
+
+} // namespace
+
+// One integration step of the motor kernel across every slot in the store
+static void BM_MotorStoreStep(benchmark::State &state)
+{
+    MotorStateStore store;
+    for (int64_t i = 0; i < state.range(0); ++i)
+    {
+        uint32_t slot = store.acquire();
+        store.targetSpeed[slot] = static_cast<int32_t>(i % 2000) - 1000;
+        store.moving[slot] = 1;
+    }
+    for (auto _ : state)
+    {
+        store.step();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MotorStoreStep)->Apply(actuatorCounts);
+
+static void BM_ServoStoreStep(benchmark::State &state)
+{
+    ServoStateStore store;
+    for (int64_t i = 0; i < state.range(0); ++i)
+    {
+        uint32_t slot = store.acquire();
+        store.targetAngle[slot] = Fixed::fromInt(static_cast<int32_t>(i % 180));
+        store.moving[slot] = 1;
+    }
+    for (auto _ : state)
+    {
+        store.advance(ServoStateStore::kUpdatePeriod);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ServoStoreStep)->Apply(actuatorCounts);
+
+// A full engine tick with half motors and half servos attached as mock views
+static void BM_EngineTick(benchmark::State &state)
+{
+    SimulationEngine engine;
+    std::vector<std::unique_ptr<MockMotor>> motors;
+    std::vector<std::unique_ptr<MockServo>> servos;
+    for (int64_t i = 0; i < state.range(0) / 2; ++i)
+    {
+        motors.push_back(std::make_unique<MockMotor>(std::string("m").append(std::to_string(i)), engine));
+        motors.back()->setSpeed(static_cast<int16_t>(i % 1000));
+        servos.push_back(std::make_unique<MockServo>(std::string("s").append(std::to_string(i)), engine));
+        servos.back()->setAngle(static_cast<double>(i % 180));
+    }
+    for (auto _ : state)
+        engine.advance(engine.getTickPeriod());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EngineTick)->Apply(actuatorCounts);
@@ -0,0 +1,43 @@
+#include "utils/Telemetry.hpp"
+#include <benchmark/benchmark.h>
+
+using namespace FingerFlexAid;
+
+namespace
+{
+
+TelemetryRing &ring()
+{
+    static TelemetryRing instance(1 << 16);
+    return instance;
+}
+
+} // namespace
+
+// Publishers contending on one ring; readers cost them nothing, so none are attached
+static void BM_TelemetryPublish(benchmark::State &state)
+{
+    TelemetryRecord record;
+    record.speed = 100;
+    for (auto _ : state)
+    {
+        record.position += 1;
+        ring().publish(record);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TelemetryPublish)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_TelemetryPublishAndRead(benchmark::State &state)
+{
+    TelemetryRing local(1 << 12);
+    TelemetryReader reader(local);
+    TelemetryRecord record;
+    for (auto _ : state)
+    {
+        local.publish(record);
+        benchmark::DoNotOptimize(reader.next(record));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TelemetryPublishAndRead);
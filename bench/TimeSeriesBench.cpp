@@ -0,0 +1,127 @@
+#include "mock/MockMotor.hpp"
+#include "mock/MockServo.hpp"
+#include "mock/SimulationEngine.hpp"
+#include "models/Motor.hpp"
+#include "utils/TimeSeries.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace FingerFlexAid;
+
+namespace
+{
+
+constexpr size_t kSamples = 1 << 16;
+
+// Channels sampled the way a logger would: MockMotor::getCurrentPosition and MockServo::getCurrentAngle on
+// every tick of a manually advanced engine, and Motor::getPosition following a smooth finger trajectory.
+enum Channel
+{
+    MockMotorPosition,
+    MockServoAngle,
+    MotorPosition
+};
+
+const std::vector<TimeSample> &samples(int channel)
+{
+    static const std::vector<std::vector<TimeSample>> all = [] {
+        std::vector<std::vector<TimeSample>> channels(3);
+        SimulationEngine engine;
+        MockMotor mockMotor("bench_motor", engine);
+        MockServo mockServo("bench_servo", engine);
+        Motor motor("bench_finger", 1000, 10);
+        mockMotor.simulateHardwareDelay(std::chrono::milliseconds(0));
+
+        for (size_t i = 0; i < kSamples; ++i)
+        {
+            // Change direction every few seconds of simulated time, as a glove flexing would
+            if (i % 200 == 0)
+            {
+                mockMotor.setSpeed(static_cast<int16_t>((i / 200) % 2 ? -300 : 300));
+                mockServo.setAngle(static_cast<uint16_t>((i / 200) % 2 ? 20 : 160));
+            }
+            motor.setPosition(std::round(500 * std::sin(static_cast<double>(i) * 0.01) * 100) / 100);
+            engine.advance(engine.getTickPeriod());
+
+            const auto now = std::chrono::duration_cast<std::chrono::microseconds>(engine.now());
+            channels[MockMotorPosition].push_back({now, static_cast<double>(mockMotor.getCurrentPosition())});
+            channels[MockServoAngle].push_back({now, static_cast<double>(mockServo.getCurrentAngle())});
+            channels[MotorPosition].push_back({now, motor.getPosition()});
+        }
+        return channels;
+    }();
+    return all[static_cast<size_t>(channel)];
+}
+
+TimeSeries encode(const std::vector<TimeSample> &input)
+{
+    TimeSeries series;
+    for (const auto &sample : input)
+        series.append(sample.time, sample.value);
+    return series;
+}
+
+void channels(benchmark::internal::Benchmark *bench)
+{
+    bench->ArgName("channel")->Arg(MockMotorPosition)->Arg(MockServoAngle)->Arg(MotorPosition);
+}
+
+void reportSize(benchmark::State &state, const TimeSeries &series)
+{
+    const double bytes = static_cast<double>(series.getCompressedBytes());
+    state.counters["bytes_per_sample"] = bytes / static_cast<double>(series.getSampleCount());
+    state.counters["ratio"] = static_cast<double>(series.getSampleCount() * sizeof(TimeSample)) / bytes;
+}
+
+} // namespace
+
+static void BM_TimeSeriesEncode(benchmark::State &state)
+{
+    const auto &input = samples(static_cast<int>(state.range(0)));
+    for (auto _ : state)
+    {
+        TimeSeries series = encode(input);
+        benchmark::DoNotOptimize(series.getCompressedBytes());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(input.size()));
+    reportSize(state, encode(input));
+}
+BENCHMARK(BM_TimeSeriesEncode)->Apply(channels);
+
+static void BM_TimeSeriesDecodeAll(benchmark::State &state)
+{
+    const TimeSeries series = encode(samples(static_cast<int>(state.range(0))));
+    std::vector<TimeSample> out;
+    out.reserve(series.getSampleCount());
+    for (auto _ : state)
+    {
+        out.clear();
+        series.query(std::chrono::microseconds::min(), std::chrono::microseconds::max(), out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(series.getSampleCount()));
+    reportSize(state, series);
+}
+BENCHMARK(BM_TimeSeriesDecodeAll)->Apply(channels);
+
+// One second of samples from the middle of the series: a binary search and one or two block decodes
+static void BM_TimeSeriesRangeQuery(benchmark::State &state)
+{
+    const auto &input = samples(static_cast<int>(state.range(0)));
+    const TimeSeries series = encode(input);
+    const auto from = input[input.size() / 2].time;
+    const auto to = from + std::chrono::seconds(1);
+    std::vector<TimeSample> out;
+    size_t blocks = 0;
+    for (auto _ : state)
+    {
+        out.clear();
+        blocks = series.query(from, to, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.counters["blocks"] = static_cast<double>(blocks);
+    state.counters["samples"] = static_cast<double>(out.size());
+}
+BENCHMARK(BM_TimeSeriesRangeQuery)->Apply(channels);
@@ -0,0 +1,95 @@
+#include "core/Routine.hpp"
+#include "core/Trajectory.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace FingerFlexAid;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+// A flex-and-extend exercise repeated ten times on every actuator of a glove
+ExerciseRoutine routine(int64_t actuators)
+{
+    ExerciseRoutine result;
+    result.name = std::string("bench-").append(std::to_string(actuators));
+    for (int64_t i = 0; i < actuators; ++i)
+    {
+        RoutineTrack track{std::string("servo").append(std::to_string(i)), ActuatorKind::Servo, 90, {}};
+        for (int rep = 0; rep < 10; ++rep)
+        {
+            track.moves.push_back({160.0 - static_cast<double>(i % 10), 500ms});
+            track.moves.push_back({20.0 + static_cast<double>(i % 10), 300ms});
+        }
+        result.tracks.push_back(std::move(track));
+    }
+    return result;
+}
+
+std::vector<MotionLimits> limits(int64_t actuators)
+{
+    MotionLimits servo;
+    servo.maxVelocity = 500;
+    servo.maxAcceleration = 500;
+    servo.maxJerk = 5000;
+    servo.minPosition = 0;
+    servo.maxPosition = 180;
+    return std::vector<MotionLimits>(static_cast<size_t>(actuators), servo);
+}
+
+void actuatorCounts(benchmark::internal::Benchmark *bench)
+{
+    bench->Arg(5)->Arg(50)->Arg(500);
+}
+
+} // namespace
+
+// Cost of starting an exercise for the first time: compiling every track's S-curves
+static void BM_RoutineCompile(benchmark::State &state)
+{
+    const ExerciseRoutine exercise = routine(state.range(0));
+    const auto bounds = limits(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(CompiledRoutine::compile(exercise, bounds));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RoutineCompile)->Apply(actuatorCounts);
+
+// Starting it again: a cache hit
+static void BM_RoutineCacheHit(benchmark::State &state)
+{
+    const ExerciseRoutine exercise = routine(state.range(0));
+    const auto bounds = limits(state.range(0));
+    RoutineCache cache;
+    cache.get(exercise, bounds);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(cache.get(exercise, bounds));
+}
+BENCHMARK(BM_RoutineCacheHit)->Apply(actuatorCounts);
+
+// Per control tick: one setpoint per actuator at 1 kHz, resuming from each track's cursor
+static void BM_RoutineSampleTick(benchmark::State &state)
+{
+    auto compiled = CompiledRoutine::compile(routine(state.range(0)), limits(state.range(0)));
+    const auto &tracks = compiled->getTracks();
+    std::vector<size_t> cursors(tracks.size(), 0);
+    auto elapsed = 0ns;
+    for (auto _ : state)
+    {
+        elapsed += 1ms;
+        if (elapsed > compiled->getDuration())
+        {
+            elapsed = 0ns;
+            std::fill(cursors.begin(), cursors.end(), 0);
+        }
+        double sum = 0;
+        for (size_t i = 0; i < tracks.size(); ++i)
+            sum += tracks[i].trajectory.sample(elapsed, cursors[i]);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RoutineSampleTick)->Apply(actuatorCounts);
@@ -0,0 +1,599 @@
+#include "CommandCoalescing.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace FingerFlexAid
+{
+
+namespace
+{
+
+// Field indices of the two stages
+constexpr size_t kMotorSpeed = 0;
+constexpr size_t kMotorPosition = 1;
+constexpr size_t kServoAngle = 0;
+constexpr size_t kServoSpeed = 1;
+
+MotorCommand toMotorCommand(const CommandStage::Write &write)
+{
+    return write.field == kMotorSpeed ? MotorCommand::speed(static_cast<int16_t>(write.value))
+                                      : MotorCommand::position(write.value);
+}
+
+ServoCommand toServoCommand(const CommandStage::Write &write)
+{
+    return write.field == kServoAngle ? ServoCommand::angle(static_cast<uint16_t>(write.value))
+                                      : ServoCommand::speed(static_cast<uint8_t>(write.value));
+}
+
+// Makes `stage` forget what was written whenever the device stops moving or its error flag flips: a halt,
+// an emergency stop or clearError() on the device itself all change its target without going through the
+// stage. Returns the listener id, or 0 if the device does not publish its status.
+uint64_t forgetOnStatusChange(StatusPublisher *publisher, CommandStage &stage)
+{
+    if (!publisher)
+        return 0;
+    return publisher->addStatusListener([&stage, lastError = publisher->getPublishedError()](bool error,
+                                                                                           bool moving) mutable {
+        if (error != lastError || !moving)
+            stage.forget();
+        lastError = error;
+    });
+}
+
+void removeStatusListener(StatusPublisher *publisher, uint64_t id)
+{
+    if (publisher && id)
+        publisher->removeStatusListener(id);
+}
+
+} // namespace
+
+bool CommandStage::stage(size_t field, int32_t value)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    Field &f = fields_[field];
+    const Policy &policy = policies_[field];
+    ++stats_.requested;
+    if (f.pending)
+        ++stats_.dropped; // superseded before it was written
+    if (policy.dropRepeats && f.hasSent && value == f.sent)
+    {
+        f.pending = false;
+        ++stats_.dropped;
+        return false;
+    }
+    f.staged = value;
+    f.pending = true;
+    f.order = nextOrder_++;
+    if (!f.hasSent)
+        return policy.threshold == 0;
+    return policy.threshold != CoalescingOptions::kNever &&
+           std::abs(static_cast<int64_t>(value) - f.sent) >= policy.threshold;
+}
+
+void CommandStage::take(Writes &writes)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    writes.count = 0;
+    for (size_t i = 0; i < fields_.size(); ++i)
+    {
+        if (!fields_[i].pending)
+            continue;
+        fields_[i].pending = false;
+        writes.writes[writes.count++] = Write{i, fields_[i].staged};
+    }
+    if (writes.count == 2 && fields_[1].order < fields_[0].order)
+        std::swap(writes.writes[0], writes.writes[1]);
+}
+
+void CommandStage::written(const Write &write, bool accepted)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    Field &f = fields_[write.field];
+    if (accepted)
+    {
+        ++stats_.sent;
+        f.sent = write.value;
+        f.hasSent = true;
+    }
+    else
+        ++stats_.rejected;
+}
+
+void CommandStage::bypassed(size_t field, int32_t value, bool accepted, bool requested)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    Field &f = fields_[field];
+    if (f.pending)
+    {
+        f.pending = false;
+        ++stats_.dropped;
+    }
+    if (requested)
+    {
+        ++stats_.requested;
+        ++(accepted ? stats_.sent : stats_.rejected);
+    }
+    if (accepted)
+    {
+        f.sent = value;
+        f.hasSent = true;
+    }
+}
+
+void CommandStage::reset()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (Field &f : fields_)
+    {
+        stats_.dropped += f.pending;
+        f.pending = false;
+        f.hasSent = false;
+    }
+}
+
+void CommandStage::forget()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (Field &f : fields_)
+        f.hasSent = false;
+}
+
+bool CommandStage::hasPending() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return fields_[0].pending || fields_[1].pending;
+}
+
+CoalescingStats CommandStage::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return stats_;
+}
+
+CoalescingMotor::CoalescingMotor(std::shared_ptr<MotorController> inner, const CoalescingOptions &options)
+    : inner_(std::move(inner)), maxSpeed_(inner_->getMaxSpeed()),
+      stage_({options.motorSpeedThreshold, true}, {options.motorPositionThreshold, false}),
+      statusListener_(forgetOnStatusChange(inner_->getStatusPublisher(), stage_))
+{
+}
+
+CoalescingMotor::~CoalescingMotor()
+{
+    removeStatusListener(inner_->getStatusPublisher(), statusListener_);
+}
+
+bool CoalescingMotor::setSpeed(int16_t speed)
+{
+    if (std::abs(speed) > maxSpeed_.load(std::memory_order_relaxed))
+    {
+        // Let the device refuse it, and report that, as it would have without the stage
+        const bool accepted = inner_->setSpeed(speed);
+        stage_.bypassed(kMotorSpeed, speed, accepted, true);
+        return accepted;
+    }
+    return !stage_.stage(kMotorSpeed, speed) || flush();
+}
+
+bool CoalescingMotor::setPosition(int32_t position)
+{
+    return !stage_.stage(kMotorPosition, position) || flush();
+}
+
+bool CoalescingMotor::stop()
+{
+    stage_.reset();
+    return inner_->stop();
+}
+
+bool CoalescingMotor::emergencyStop()
+{
+    stage_.reset();
+    return inner_->emergencyStop();
+}
+
+int16_t CoalescingMotor::getCurrentSpeed() const
+{
+    return inner_->getCurrentSpeed();
+}
+
+int32_t CoalescingMotor::getCurrentPosition() const
+{
+    return inner_->getCurrentPosition();
+}
+
+bool CoalescingMotor::isMoving() const
+{
+    return inner_->isMoving();
+}
+
+bool CoalescingMotor::isError() const
+{
+    return inner_->isError();
+}
+
+std::optional<std::string> CoalescingMotor::getLastError() const
+{
+    return inner_->getLastError();
+}
+
+ErrorRecord CoalescingMotor::getLastErrorRecord() const
+{
+    return inner_->getLastErrorRecord();
+}
+
+bool CoalescingMotor::setMaxSpeed(int16_t maxSpeed)
+{
+    const bool accepted = inner_->setMaxSpeed(maxSpeed);
+    maxSpeed_.store(inner_->getMaxSpeed(), std::memory_order_relaxed);
+    return accepted;
+}
+
+bool CoalescingMotor::setAcceleration(uint16_t acceleration)
+{
+    return inner_->setAcceleration(acceleration);
+}
+
+int16_t CoalescingMotor::getMaxSpeed() const
+{
+    return maxSpeed_.load(std::memory_order_relaxed);
+}
+
+uint16_t CoalescingMotor::getAcceleration() const
+{
+    return inner_->getAcceleration();
+}
+
+StatusPublisher *CoalescingMotor::getStatusPublisher()
+{
+    return inner_->getStatusPublisher();
+}
+
+BatchDomain *CoalescingMotor::getBatchDomain()
+{
+    return inner_->getBatchDomain();
+}
+
+bool CoalescingMotor::checkCommand(const MotorCommand &command) const
+{
+    return inner_->checkCommand(command);
+}
+
+bool CoalescingMotor::applyCommand(const MotorCommand &command)
+{
+    const bool accepted = inner_->applyCommand(command);
+    switch (command.type)
+    {
+    case MotorCommand::Type::SetSpeed:
+        stage_.bypassed(kMotorSpeed, command.value, accepted, false);
+        break;
+    case MotorCommand::Type::SetPosition:
+        stage_.bypassed(kMotorPosition, command.value, accepted, false);
+        break;
+    case MotorCommand::Type::Stop:
+    case MotorCommand::Type::EmergencyStop:
+        stage_.reset();
+        break;
+    }
+    return accepted;
+}
+
+bool CoalescingMotor::applyPending(CommandStage::Writes &refused)
+{
+    CommandStage::Writes pending;
+    stage_.take(pending);
+    refused.count = 0;
+    bool accepted = true;
+    for (size_t i = 0; i < pending.count; ++i)
+    {
+        const auto &write = pending.writes[i];
+        const MotorCommand command = toMotorCommand(write);
+        if (!inner_->checkCommand(command))
+        {
+            refused.writes[refused.count++] = write;
+            continue;
+        }
+        const bool applied = inner_->applyCommand(command);
+        stage_.written(write, applied);
+        accepted &= applied;
+    }
+    return accepted;
+}
+
+bool CoalescingMotor::writeRefused(const CommandStage::Writes &refused)
+{
+    bool accepted = true;
+    for (size_t i = 0; i < refused.count; ++i)
+    {
+        const auto &write = refused.writes[i];
+        const bool applied = write.field == kMotorSpeed ? inner_->setSpeed(static_cast<int16_t>(write.value))
+                                                        : inner_->setPosition(write.value);
+        stage_.written(write, applied);
+        accepted &= applied;
+    }
+    return accepted;
+}
+
+bool CoalescingMotor::flush()
+{
+    if (!stage_.hasPending())
+        return true;
+    CommandStage::Writes refused;
+    bool accepted;
+    if (BatchDomain *domain = inner_->getBatchDomain())
+    {
+        domain->beginBatch();
+        accepted = applyPending(refused);
+        domain->endBatch();
+    }
+    else
+        accepted = applyPending(refused);
+    return writeRefused(refused) && accepted;
+}
+
+CoalescingStats CoalescingMotor::getStats() const
+{
+    return stage_.getStats();
+}
+
+CoalescingServo::CoalescingServo(std::shared_ptr<ServoController> inner, const CoalescingOptions &options)
+    : inner_(std::move(inner)), minAngle_(inner_->getAngleLimits().first), maxAngle_(inner_->getAngleLimits().second),
+      maxSpeed_(inner_->getMaxSpeed()), stage_({options.servoAngleThreshold, true}, {options.servoSpeedThreshold, true}),
+      statusListener_(forgetOnStatusChange(inner_->getStatusPublisher(), stage_))
+{
+}
+
+CoalescingServo::~CoalescingServo()
+{
+    removeStatusListener(inner_->getStatusPublisher(), statusListener_);
+}
+
+bool CoalescingServo::setAngle(uint16_t angle)
+{
+    if (angle < minAngle_.load(std::memory_order_relaxed) || angle > maxAngle_.load(std::memory_order_relaxed))
+    {
+        const bool accepted = inner_->setAngle(angle);
+        stage_.bypassed(kServoAngle, angle, accepted, true);
+        return accepted;
+    }
+    return !stage_.stage(kServoAngle, angle) || flush();
+}
+
+bool CoalescingServo::setSpeed(uint8_t speed)
+{
+    if (speed > maxSpeed_.load(std::memory_order_relaxed))
+    {
+        const bool accepted = inner_->setSpeed(speed);
+        stage_.bypassed(kServoSpeed, speed, accepted, true);
+        return accepted;
+    }
+    return !stage_.stage(kServoSpeed, speed) || flush();
+}
+
+bool CoalescingServo::stop()
+{
+    stage_.reset();
+    return inner_->stop();
+}
+
+bool CoalescingServo::emergencyStop()
+{
+    stage_.reset();
+    return inner_->emergencyStop();
+}
+
+uint16_t CoalescingServo::getCurrentAngle() const
+{
+    return inner_->getCurrentAngle();
+}
+
+uint8_t CoalescingServo::getCurrentSpeed() const
+{
+    return inner_->getCurrentSpeed();
+}
+
+bool CoalescingServo::isMoving() const
+{
+    return inner_->isMoving();
+}
+
+bool CoalescingServo::isError() const
+{
+    return inner_->isError();
+}
+
+std::optional<std::string> CoalescingServo::getLastError() const
+{
+    return inner_->getLastError();
+}
+
+ErrorRecord CoalescingServo::getLastErrorRecord() const
+{
+    return inner_->getLastErrorRecord();
+}
+
+bool CoalescingServo::setAngleLimits(uint16_t minAngle, uint16_t maxAngle)
+{
+    const bool accepted = inner_->setAngleLimits(minAngle, maxAngle);
+    auto [min, max] = inner_->getAngleLimits();
+    minAngle_.store(min, std::memory_order_relaxed);
+    maxAngle_.store(max, std::memory_order_relaxed);
+    return accepted;
+}
+
+bool CoalescingServo::setMaxSpeed(uint8_t maxSpeed)
+{
+    const bool accepted = inner_->setMaxSpeed(maxSpeed);
+    maxSpeed_.store(inner_->getMaxSpeed(), std::memory_order_relaxed);
+    return accepted;
+}
+
+std::pair<uint16_t, uint16_t> CoalescingServo::getAngleLimits() const
+{
+    return {minAngle_.load(std::memory_order_relaxed), maxAngle_.load(std::memory_order_relaxed)};
+}
+
+uint8_t CoalescingServo::getMaxSpeed() const
+{
+    return maxSpeed_.load(std::memory_order_relaxed);
+}
+
+StatusPublisher *CoalescingServo::getStatusPublisher()
+{
+    return inner_->getStatusPublisher();
+}
+
+BatchDomain *CoalescingServo::getBatchDomain()
+{
+    return inner_->getBatchDomain();
+}
+
+bool CoalescingServo::checkCommand(const ServoCommand &command) const
+{
+    return inner_->checkCommand(command);
+}
+
+bool CoalescingServo::applyCommand(const ServoCommand &command)
+{
+    const bool accepted = inner_->applyCommand(command);
+    switch (command.type)
+    {
+    case ServoCommand::Type::SetAngle:
+        stage_.bypassed(kServoAngle, command.value, accepted, false);
+        break;
+    case ServoCommand::Type::SetSpeed:
+        stage_.bypassed(kServoSpeed, command.value, accepted, false);
+        break;
+    case ServoCommand::Type::Stop:
+    case ServoCommand::Type::EmergencyStop:
+        stage_.reset();
+        break;
+    }
+    return accepted;
+}
+
+bool CoalescingServo::applyPending(CommandStage::Writes &refused)
+{
+    CommandStage::Writes pending;
+    stage_.take(pending);
+    refused.count = 0;
+    bool accepted = true;
+    for (size_t i = 0; i < pending.count; ++i)
+    {
+        const auto &write = pending.writes[i];
+        const ServoCommand command = toServoCommand(write);
+        if (!inner_->checkCommand(command))
+        {
+            refused.writes[refused.count++] = write;
+            continue;
+        }
+        const bool applied = inner_->applyCommand(command);
+        stage_.written(write, applied);
+        accepted &= applied;
+    }
+    return accepted;
+}
+
+bool CoalescingServo::writeRefused(const CommandStage::Writes &refused)
+{
+    bool accepted = true;
+    for (size_t i = 0; i < refused.count; ++i)
+    {
+        const auto &write = refused.writes[i];
+        const bool applied = write.field == kServoAngle ? inner_->setAngle(static_cast<uint16_t>(write.value))
+                                                        : inner_->setSpeed(static_cast<uint8_t>(write.value));
+        stage_.written(write, applied);
+        accepted &= applied;
+    }
+    return accepted;
+}
+
+bool CoalescingServo::flush()
+{
+    if (!stage_.hasPending())
+        return true;
+    CommandStage::Writes refused;
+    bool accepted;
+    if (BatchDomain *domain = inner_->getBatchDomain())
+    {
+        domain->beginBatch();
+        accepted = applyPending(refused);
+        domain->endBatch();
+    }
+    else
+        accepted = applyPending(refused);
+    return writeRefused(refused) && accepted;
+}
+
+CoalescingStats CoalescingServo::getStats() const
+{
+    return stage_.getStats();
+}
+
+void CoalescingGroup::add(std::shared_ptr<CoalescingMotor> motor)
+{
+    BatchDomain *domain = motor->getBatchDomain();
+    auto at = std::upper_bound(members_.begin(), members_.end(), domain,
+                               [](BatchDomain *d, const Member &member) { return d < member.domain; });
+    members_.insert(at, Member{domain, std::move(motor), nullptr});
+    refused_.resize(members_.size());
+}
+
+void CoalescingGroup::add(std::shared_ptr<CoalescingServo> servo)
+{
+    BatchDomain *domain = servo->getBatchDomain();
+    auto at = std::upper_bound(members_.begin(), members_.end(), domain,
+                               [](BatchDomain *d, const Member &member) { return d < member.domain; });
+    members_.insert(at, Member{domain, nullptr, std::move(servo)});
+    refused_.resize(members_.size());
+}
+
+bool CoalescingGroup::flush()
+{
+    auto pending = [](const Member &member) {
+        return member.motor ? member.motor->stage_.hasPending() : member.servo->stage_.hasPending();
+    };
+    bool accepted = true;
+    for (size_t first = 0; first < members_.size();)
+    {
+        BatchDomain *domain = members_[first].domain;
+        size_t last = first;
+        bool any = false;
+        while (last < members_.size() && members_[last].domain == domain)
+            any |= pending(members_[last++]);
+        if (!any)
+        {
+            first = last;
+            continue;
+        }
+
+        // One hold of the domain for all of its devices; devices without one are flushed on their own
+        if (domain)
+            domain->beginBatch();
+        for (size_t i = first; i < last; ++i)
+        {
+            const Member &member = members_[i];
+            accepted &= member.motor ? member.motor->applyPending(refused_[i]) : member.servo->applyPending(refused_[i]);
+        }
+        if (domain)
+            domain->endBatch();
+        for (size_t i = first; i < last; ++i)
+        {
+            const Member &member = members_[i];
+            accepted &= member.motor ? member.motor->writeRefused(refused_[i]) : member.servo->writeRefused(refused_[i]);
+        }
+        first = last;
+    }
+    return accepted;
+}
+
+CoalescingStats CoalescingGroup::getStats() const
+{
+    CoalescingStats stats;
+    for (const Member &member : members_)
+        stats += member.motor ? member.motor->getStats() : member.servo->getStats();
+    return stats;
+}
+
+} // namespace FingerFlexAid
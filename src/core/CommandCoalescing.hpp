@@ -0,0 +1,244 @@
+#pragma once
+
+#include "MotorController.hpp"
+#include "ServoController.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace FingerFlexAid
+{
+
+// How far a staged value may move from the last one written before it is written at once rather than at the
+// next flush. A threshold of 0 writes every change immediately; the maximum defers everything to flush().
+struct CoalescingOptions
+{
+    int32_t motorSpeedThreshold = 200;     // RPM
+    int32_t motorPositionThreshold = 2000; // steps
+    int32_t servoAngleThreshold = 30;      // degrees
+    int32_t servoSpeedThreshold = 50;      // 0-100 scale
+
+    static constexpr int32_t kNever = std::numeric_limits<int32_t>::max();
+};
+
+// Every setter call ends up in exactly one of sent, dropped or rejected, or is still pending.
+struct CoalescingStats
+{
+    uint64_t requested = 0; // setSpeed/setPosition/setAngle calls
+    uint64_t sent = 0;      // writes that reached the device
+    uint64_t dropped = 0;   // superseded by a later value before a flush, or equal to the value last written
+    uint64_t rejected = 0;  // written, but refused by the device
+
+    CoalescingStats &operator+=(const CoalescingStats &other)
+    {
+        requested += other.requested;
+        sent += other.sent;
+        dropped += other.dropped;
+        rejected += other.rejected;
+        return *this;
+    }
+};
+
+// The latest staged value of each of a device's two setpoint fields, and the value last written to each.
+class CommandStage
+{
+  public:
+    struct Policy
+    {
+        int32_t threshold = CoalescingOptions::kNever;
+        // Drop values equal to the one last written. Off for fields the device moves away from on its own.
+        bool dropRepeats = true;
+    };
+
+    struct Write
+    {
+        size_t field;
+        int32_t value;
+    };
+    struct Writes
+    {
+        std::array<Write, 2> writes;
+        size_t count = 0;
+    };
+
+    CommandStage(Policy field0, Policy field1) : policies_{field0, field1}
+    {
+    }
+
+    // Stages a requested value; true if it has moved past the threshold and should be flushed now.
+    bool stage(size_t field, int32_t value);
+    // Takes the pending writes in the order they were staged.
+    void take(Writes &writes);
+    // Records the outcome of a write taken by take().
+    void written(const Write &write, bool accepted);
+    // Records a write that went past the stage: a requested value (`requested`) or a batched command. It
+    // supersedes anything pending for the field.
+    void bypassed(size_t field, int32_t value, bool accepted, bool requested);
+    // Drops anything pending and forgets what was written, e.g. after a stop.
+    void reset();
+    // Forgets what was written but keeps anything pending, for when the device's target has changed behind
+    // the stage's back, e.g. it was halted by an emergency-stop epoch or its error state flipped.
+    void forget();
+    bool hasPending() const;
+    CoalescingStats getStats() const;
+
+  private:
+    struct Field
+    {
+        int32_t staged = 0;
+        int32_t sent = 0;
+        uint64_t order = 0;
+        bool pending = false;
+        bool hasSent = false;
+    };
+
+    const std::array<Policy, 2> policies_;
+    mutable std::mutex mtx_;
+    std::array<Field, 2> fields_;
+    uint64_t nextOrder_ = 0;
+    CoalescingStats stats_;
+};
+
+// Decorator that stages setSpeed()/setPosition() and writes only the latest value of each per flush(),
+// skipping a speed equal to the last one written (positions are always written: the motor moves off them).
+// Stops, emergency stops, configuration and reads go straight through, and a stop discards whatever is
+// pending. Batched commands (applyCommand) also go straight through, superseding a staged value of the same
+// field. If the device publishes its status, the decorator also forgets what it wrote whenever the device
+// stops moving or its error flag flips, so a repeat after a stop it did not see is written again. Meant for
+// planners that set a device many times per control period.
+class CoalescingMotor : public MotorController
+{
+  public:
+    explicit CoalescingMotor(std::shared_ptr<MotorController> inner, const CoalescingOptions &options = {});
+    ~CoalescingMotor() override;
+
+    bool setSpeed(int16_t speed) override;       // true once staged; out-of-range speeds are written at once
+    bool setPosition(int32_t position) override; // true once staged
+    bool stop() override;
+    bool emergencyStop() override;
+
+    int16_t getCurrentSpeed() const override;
+    int32_t getCurrentPosition() const override;
+    bool isMoving() const override;
+    bool isError() const override;
+    std::optional<std::string> getLastError() const override;
+    ErrorRecord getLastErrorRecord() const override;
+
+    bool setMaxSpeed(int16_t maxSpeed) override;
+    bool setAcceleration(uint16_t acceleration) override;
+    int16_t getMaxSpeed() const override;
+    uint16_t getAcceleration() const override;
+
+    StatusPublisher *getStatusPublisher() override;
+    BatchDomain *getBatchDomain() override;
+    bool checkCommand(const MotorCommand &command) const override;
+    bool applyCommand(const MotorCommand &command) override;
+
+    // Writes the pending values; call once per control period, from one thread. Under the device's batch
+    // domain if it has one, so a transport sends them together. False if the device refused any of them.
+    bool flush();
+    CoalescingStats getStats() const;
+    MotorController &getInner()
+    {
+        return *inner_;
+    }
+
+  private:
+    friend class CoalescingGroup;
+
+    // The two halves of a flush: applyPending() runs inside the batch domain, if any, and returns the writes the
+    // device's checkCommand() refused in `refused`; writeRefused() then makes those through the setters,
+    // outside the domain, so the device reports the failure the way it would have without coalescing.
+    bool applyPending(CommandStage::Writes &refused);
+    bool writeRefused(const CommandStage::Writes &refused);
+
+    const std::shared_ptr<MotorController> inner_;
+    std::atomic<int16_t> maxSpeed_;
+    CommandStage stage_;
+    uint64_t statusListener_ = 0;
+};
+
+// Decorator that stages setAngle()/setSpeed() for a ServoController; see CoalescingMotor.
+class CoalescingServo : public ServoController
+{
+  public:
+    explicit CoalescingServo(std::shared_ptr<ServoController> inner, const CoalescingOptions &options = {});
+    ~CoalescingServo() override;
+
+    bool setAngle(uint16_t angle) override; // true once staged; angles outside the limits are written at once
+    bool setSpeed(uint8_t speed) override;  // true once staged; speeds above the maximum are written at once
+    bool stop() override;
+    bool emergencyStop() override;
+
+    uint16_t getCurrentAngle() const override;
+    uint8_t getCurrentSpeed() const override;
+    bool isMoving() const override;
+    bool isError() const override;
+    std::optional<std::string> getLastError() const override;
+    ErrorRecord getLastErrorRecord() const override;
+
+    bool setAngleLimits(uint16_t minAngle, uint16_t maxAngle) override;
+    bool setMaxSpeed(uint8_t maxSpeed) override;
+    std::pair<uint16_t, uint16_t> getAngleLimits() const override;
+    uint8_t getMaxSpeed() const override;
+
+    StatusPublisher *getStatusPublisher() override;
+    BatchDomain *getBatchDomain() override;
+    bool checkCommand(const ServoCommand &command) const override;
+    bool applyCommand(const ServoCommand &command) override;
+
+    bool flush();
+    CoalescingStats getStats() const;
+    ServoController &getInner()
+    {
+        return *inner_;
+    }
+
+  private:
+    friend class CoalescingGroup;
+
+    bool applyPending(CommandStage::Writes &refused);
+    bool writeRefused(const CommandStage::Writes &refused);
+
+    const std::shared_ptr<ServoController> inner_;
+    // Cached so that staging needs no call into the device
+    std::atomic<uint16_t> minAngle_;
+    std::atomic<uint16_t> maxAngle_;
+    std::atomic<uint8_t> maxSpeed_;
+    CommandStage stage_;
+    uint64_t statusListener_ = 0;
+};
+
+// Flushes a set of coalescing devices together once per tick, holding each batch domain once for all of its
+// devices. Not synchronised: add devices before the control loop starts.
+class CoalescingGroup
+{
+  public:
+    void add(std::shared_ptr<CoalescingMotor> motor);
+    void add(std::shared_ptr<CoalescingServo> servo);
+
+    // From one thread at a time. False if any device refused a write.
+    bool flush();
+    // Summed over every device in the group.
+    CoalescingStats getStats() const;
+
+  private:
+    // One device, kept sorted by batch domain so each domain's devices are adjacent
+    struct Member
+    {
+        BatchDomain *domain;
+        std::shared_ptr<CoalescingMotor> motor;
+        std::shared_ptr<CoalescingServo> servo;
+    };
+
+    std::vector<Member> members_;
+    std::vector<CommandStage::Writes> refused_; // scratch, one per member
+};
+
+} // namespace FingerFlexAid
@@ -0,0 +1,185 @@
+#include "ControlLoop.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <pthread.h>
+#include <sched.h>
+
+namespace FingerFlexAid
+{
+
+using Clock = std::chrono::steady_clock;
+
+size_t LatencyHistogram::bucketFor(std::chrono::nanoseconds value)
+{
+    auto micros = static_cast<uint64_t>(std::max<int64_t>(value.count(), 0) / 1000);
+    return std::min<size_t>(static_cast<size_t>(std::bit_width(micros)), kBuckets - 1);
+}
+
+std::chrono::nanoseconds LatencyHistogram::percentile(double fraction) const
+{
+    if (samples == 0)
+        return std::chrono::nanoseconds{0};
+    auto wanted = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(samples)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i)
+    {
+        seen += counts[i];
+        if (seen >= wanted && i + 1 < kBuckets)
+            return std::min<std::chrono::nanoseconds>(std::chrono::microseconds(uint64_t{1} << i), max);
+    }
+    return max;
+}
+
+void ControlLoop::AtomicHistogram::record(std::chrono::nanoseconds value)
+{
+    // Only the loop thread records, so the max needs no compare-exchange
+    counts[LatencyHistogram::bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+    samples.fetch_add(1, std::memory_order_relaxed);
+    totalNs.fetch_add(value.count(), std::memory_order_relaxed);
+    if (value.count() > maxNs.load(std::memory_order_relaxed))
+        maxNs.store(value.count(), std::memory_order_relaxed);
+}
+
+LatencyHistogram ControlLoop::AtomicHistogram::snapshot() const
+{
+    LatencyHistogram histogram;
+    for (size_t i = 0; i < LatencyHistogram::kBuckets; ++i)
+        histogram.counts[i] = counts[i].load(std::memory_order_relaxed);
+    histogram.samples = samples.load(std::memory_order_relaxed);
+    histogram.max = std::chrono::nanoseconds(maxNs.load(std::memory_order_relaxed));
+    histogram.total = std::chrono::nanoseconds(totalNs.load(std::memory_order_relaxed));
+    return histogram;
+}
+
+void ControlLoop::AtomicHistogram::reset()
+{
+    for (auto &count : counts)
+        count.store(0, std::memory_order_relaxed);
+    samples.store(0, std::memory_order_relaxed);
+    maxNs.store(0, std::memory_order_relaxed);
+    totalNs.store(0, std::memory_order_relaxed);
+}
+
+ControlLoop::ControlLoop(Tick tick, ControlLoopOptions options) : tick_(std::move(tick)), options_(options)
+{
+}
+
+ControlLoop::~ControlLoop()
+{
+    stop();
+}
+
+bool ControlLoop::start()
+{
+    if (running_.exchange(true))
+        return false;
+    thread_ = std::thread(&ControlLoop::run, this);
+    return true;
+}
+
+void ControlLoop::stop()
+{
+    running_ = false;
+    if (thread_.joinable())
+        thread_.join();
+}
+
+bool ControlLoop::isRunning() const
+{
+    return running_;
+}
+
+std::chrono::nanoseconds ControlLoop::getPeriod() const
+{
+    return options_.period;
+}
+
+ControlLoopStats ControlLoop::getStats() const
+{
+    ControlLoopStats stats;
+    stats.ticks = ticks_.load(std::memory_order_relaxed);
+    stats.overruns = overruns_.load(std::memory_order_relaxed);
+    stats.missedTicks = missedTicks_.load(std::memory_order_relaxed);
+    stats.emergencyStops = emergencyStops_.load(std::memory_order_relaxed);
+    stats.jitter = jitter_.snapshot();
+    stats.overrun = overrun_.snapshot();
+    stats.duration = duration_.snapshot();
+    stats.pinned = pinned_;
+    stats.realtime = realtime_;
+    return stats;
+}
+
+void ControlLoop::resetStats()
+{
+    ticks_ = 0;
+    overruns_ = 0;
+    missedTicks_ = 0;
+    emergencyStops_ = 0;
+    jitter_.reset();
+    overrun_.reset();
+    duration_.reset();
+}
+
+void ControlLoop::applyThreadOptions()
+{
+    if (options_.cpu)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(*options_.cpu, &set);
+        pinned_ = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+    if (options_.realtime)
+    {
+        sched_param param{};
+        param.sched_priority = options_.priority;
+        realtime_ = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+    }
+}
+
+void ControlLoop::run()
+{
+    applyThreadOptions();
+    const auto period = options_.period;
+    std::optional<EmergencyStop::Observer> emergencyStop;
+    if (options_.emergencyStop)
+        emergencyStop.emplace(*options_.emergencyStop);
+    auto deadline = Clock::now() + period;
+    while (running_)
+    {
+        std::this_thread::sleep_until(deadline - options_.spin);
+        while (Clock::now() < deadline)
+        {
+        }
+
+        auto woke = Clock::now();
+        jitter_.record(woke - deadline);
+        if (emergencyStop && emergencyStop->poll())
+        {
+            emergencyStops_.fetch_add(1, std::memory_order_relaxed);
+            if (options_.onEmergencyStop)
+                options_.onEmergencyStop();
+            else
+                tick_();
+        }
+        else
+            tick_();
+        auto done = Clock::now();
+        duration_.record(done - woke);
+        ticks_.fetch_add(1, std::memory_order_relaxed);
+
+        deadline += period;
+        if (done > deadline)
+        {
+            // Overrun: resume on the first deadline still ahead rather than bursting through the missed ones
+            overruns_.fetch_add(1, std::memory_order_relaxed);
+            overrun_.record(done - deadline);
+            auto missed = (done - deadline) / period + 1;
+            missedTicks_.fetch_add(static_cast<uint64_t>(missed), std::memory_order_relaxed);
+            deadline += missed * period;
+        }
+    }
+}
+
+} // namespace FingerFlexAid
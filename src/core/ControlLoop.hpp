@@ -0,0 +1,122 @@
+#pragma once
+
+#include "EmergencyStop.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <thread>
+
+namespace FingerFlexAid
+{
+
+struct ControlLoopOptions
+{
+    std::chrono::nanoseconds period{std::chrono::milliseconds(1)};
+    // Failing to apply either (e.g. without CAP_SYS_NICE) is not fatal: the loop runs anyway and
+    // ControlLoop::getStats() reports what took effect.
+    std::optional<int> cpu;     // pin the loop thread to this CPU
+    bool realtime = false;      // run under SCHED_FIFO at `priority`
+    int priority = 80;
+    // Sleep until this long before each deadline, then spin; trades CPU time for lower wake-up jitter.
+    std::chrono::nanoseconds spin{0};
+    // The epoch each tick polls, e.g. DeviceManagerImpl::getEmergencyStop(); none if null. It must outlive
+    // the loop.
+    const EmergencyStop *emergencyStop = nullptr;
+    // Run on the loop thread in place of the tick on the first tick after each trigger of that epoch; ticks
+    // resume on the next deadline. When unset the stop is only counted and the tick runs as usual.
+    std::function<void()> onEmergencyStop;
+};
+
+// Log2-bucketed latency histogram: bucket 0 counts values under 1us, bucket i values in [2^(i-1), 2^i) us,
+// and the last bucket everything longer.
+struct LatencyHistogram
+{
+    static constexpr size_t kBuckets = 24;
+
+    std::array<uint64_t, kBuckets> counts{};
+    uint64_t samples = 0;
+    std::chrono::nanoseconds max{0};
+    std::chrono::nanoseconds total{0};
+
+    static size_t bucketFor(std::chrono::nanoseconds value);
+    // Upper bound of the bucket holding the given fraction of samples, e.g. 0.99 for p99.
+    std::chrono::nanoseconds percentile(double fraction) const;
+    std::chrono::nanoseconds mean() const
+    {
+        return samples ? total / static_cast<int64_t>(samples) : std::chrono::nanoseconds{0};
+    }
+};
+
+struct ControlLoopStats
+{
+    uint64_t ticks = 0;
+    uint64_t overruns = 0;     // ticks that finished past the next deadline
+    uint64_t missedTicks = 0;  // deadlines skipped to catch up after an overrun
+    uint64_t emergencyStops = 0; // emergency-stop epochs noticed by the loop
+    LatencyHistogram jitter;   // how late each tick started relative to its deadline
+    LatencyHistogram overrun;  // how far each overrunning tick ran past the next deadline
+    LatencyHistogram duration; // how long each tick function took
+    bool pinned = false;
+    bool realtime = false;
+};
+
+// Runs a tick function at a fixed rate on its own thread. Deadlines are absolute (start + n * period), so
+// the rate does not drift with tick cost; a tick that overruns skips the deadlines it missed instead of
+// running back-to-back ticks to catch up. Each tick first polls the epoch in
+// ControlLoopOptions::emergencyStop, if any. Statistics are kept with relaxed atomics and may be read from
+// any thread while the loop runs.
+class ControlLoop
+{
+  public:
+    using Tick = std::function<void()>;
+
+    explicit ControlLoop(Tick tick, ControlLoopOptions options = {});
+    ~ControlLoop();
+
+    ControlLoop(const ControlLoop &) = delete;
+    ControlLoop &operator=(const ControlLoop &) = delete;
+
+    bool start();
+    void stop();
+    bool isRunning() const;
+
+    std::chrono::nanoseconds getPeriod() const;
+    ControlLoopStats getStats() const;
+    void resetStats();
+
+  private:
+    struct AtomicHistogram
+    {
+        std::array<std::atomic<uint64_t>, LatencyHistogram::kBuckets> counts{};
+        std::atomic<uint64_t> samples{0};
+        std::atomic<int64_t> maxNs{0};
+        std::atomic<int64_t> totalNs{0};
+
+        void record(std::chrono::nanoseconds value);
+        LatencyHistogram snapshot() const;
+        void reset();
+    };
+
+    void run();
+    void applyThreadOptions();
+
+    const Tick tick_;
+    const ControlLoopOptions options_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    std::atomic<uint64_t> ticks_{0};
+    std::atomic<uint64_t> overruns_{0};
+    std::atomic<uint64_t> missedTicks_{0};
+    std::atomic<uint64_t> emergencyStops_{0};
+    AtomicHistogram jitter_;
+    AtomicHistogram overrun_;
+    AtomicHistogram duration_;
+    std::atomic<bool> pinned_{false};
+    std::atomic<bool> realtime_{false};
+};
+
+} // namespace FingerFlexAid
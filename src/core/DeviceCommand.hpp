@@ -0,0 +1,120 @@
+#pragma once
+
+#include "DeviceHandle.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace FingerFlexAid
+{
+
+struct MotorCommand
+{
+    enum class Type : uint8_t
+    {
+        SetSpeed,
+        SetPosition,
+        Stop,
+        EmergencyStop
+    };
+
+    Type type = Type::Stop;
+    int32_t value = 0;
+
+    static constexpr MotorCommand speed(int16_t speed)
+    {
+        return {Type::SetSpeed, speed};
+    }
+    static constexpr MotorCommand position(int32_t position)
+    {
+        return {Type::SetPosition, position};
+    }
+    static constexpr MotorCommand stop()
+    {
+        return {Type::Stop, 0};
+    }
+    static constexpr MotorCommand emergencyStop()
+    {
+        return {Type::EmergencyStop, 0};
+    }
+};
+
+struct ServoCommand
+{
+    enum class Type : uint8_t
+    {
+        SetAngle,
+        SetSpeed,
+        Stop,
+        EmergencyStop
+    };
+
+    Type type = Type::Stop;
+    int32_t value = 0;
+
+    static constexpr ServoCommand angle(uint16_t angle)
+    {
+        return {Type::SetAngle, angle};
+    }
+    static constexpr ServoCommand speed(uint8_t speed)
+    {
+        return {Type::SetSpeed, speed};
+    }
+    static constexpr ServoCommand stop()
+    {
+        return {Type::Stop, 0};
+    }
+    static constexpr ServoCommand emergencyStop()
+    {
+        return {Type::EmergencyStop, 0};
+    }
+};
+
+// Commands for several devices, applied by DeviceManager::applyBatch as one unit.
+struct CommandBatch
+{
+    std::vector<std::pair<MotorHandle, MotorCommand>> motors;
+    std::vector<std::pair<ServoHandle, ServoCommand>> servos;
+
+    void add(MotorHandle motor, MotorCommand command)
+    {
+        motors.emplace_back(motor, command);
+    }
+    void add(ServoHandle servo, ServoCommand command)
+    {
+        servos.emplace_back(servo, command);
+    }
+    size_t size() const
+    {
+        return motors.size() + servos.size();
+    }
+    bool empty() const
+    {
+        return motors.empty() && servos.empty();
+    }
+    void clear()
+    {
+        motors.clear();
+        servos.clear();
+    }
+};
+
+// A group of devices that takes a batch as one unit, such as everything stepped by one simulation engine or
+// wired to one bus. Between beginBatch() and endBatch() no other access to those devices can happen;
+// a hardware transport sends the commands applied in between as a single transmission in endBatch().
+class BatchDomain
+{
+  public:
+    virtual ~BatchDomain() = default;
+
+    virtual void beginBatch() = 0;
+    virtual void endBatch() = 0;
+
+  protected:
+    BatchDomain() = default;
+    BatchDomain(const BatchDomain &) = default;
+    BatchDomain &operator=(const BatchDomain &) = default;
+};
+
+} // namespace FingerFlexAid
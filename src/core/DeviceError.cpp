@@ -0,0 +1,101 @@
+#include "DeviceError.hpp"
+#include <charconv>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace FingerFlexAid
+{
+
+namespace
+{
+
+struct TextTable
+{
+    std::shared_mutex mutex;
+    std::deque<std::string> texts; // a deque never moves its elements, so the keys below stay valid
+    std::unordered_map<std::string_view, uint32_t> ids;
+};
+
+TextTable &table()
+{
+    static TextTable instance;
+    return instance;
+}
+
+// Sized up front, so the returned string is the only allocation
+std::string withValue(std::string_view prefix, int32_t value)
+{
+    char digits[16];
+    const auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    std::string text;
+    text.reserve(prefix.size() + static_cast<size_t>(end - digits));
+    return text.append(prefix).append(digits, end);
+}
+
+} // namespace
+
+ErrorRecord ErrorRecord::raise(std::string_view message)
+{
+    return raise(ErrorCode::Text, static_cast<int32_t>(ErrorText::intern(message)));
+}
+
+std::optional<std::string> ErrorRecord::message() const
+{
+    switch (code)
+    {
+    case ErrorCode::None:
+        return std::nullopt;
+    case ErrorCode::Unknown:
+        return "Device error";
+    case ErrorCode::InvalidSpeed:
+        return withValue("Invalid speed value: ", value);
+    case ErrorCode::InvalidPosition:
+        return withValue("Invalid position value: ", value);
+    case ErrorCode::InvalidMaxSpeed:
+        return withValue("Invalid max speed value: ", value);
+    case ErrorCode::InvalidAcceleration:
+        return withValue("Invalid acceleration value: ", value);
+    case ErrorCode::InvalidAngleLimits:
+        return "Invalid angle limits";
+    case ErrorCode::EmergencyStop:
+        return "Emergency stop activated";
+    case ErrorCode::CommandRejected:
+        return "Command rejected or unanswered by the bridge";
+    case ErrorCode::LinkDisconnected:
+        return "Serial link disconnected";
+    case ErrorCode::Text:
+        return std::string(ErrorText::lookup(static_cast<uint32_t>(value)));
+    }
+    return "Device error";
+}
+
+uint32_t ErrorText::intern(std::string_view text)
+{
+    auto &t = table();
+    {
+        std::shared_lock<std::shared_mutex> lock(t.mutex);
+        if (auto it = t.ids.find(text); it != t.ids.end())
+            return it->second;
+    }
+    std::unique_lock<std::shared_mutex> lock(t.mutex);
+    if (auto it = t.ids.find(text); it != t.ids.end())
+        return it->second; // interned by another thread in between
+    if (t.texts.size() >= kCapacity)
+        return kOverflow;
+    const auto id = static_cast<uint32_t>(t.texts.size());
+    t.ids.emplace(t.texts.emplace_back(text), id);
+    return id;
+}
+
+std::string_view ErrorText::lookup(uint32_t id)
+{
+    auto &t = table();
+    std::shared_lock<std::shared_mutex> lock(t.mutex);
+    if (id >= t.texts.size())
+        return "Device error (message not recorded)";
+    return t.texts[id];
+}
+
+} // namespace FingerFlexAid
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace FingerFlexAid
+{
+
+enum class ErrorCode : uint16_t
+{
+    None,
+    Unknown, // the device reports an error but not why
+    InvalidSpeed,
+    InvalidPosition,
+    InvalidMaxSpeed,
+    InvalidAcceleration,
+    InvalidAngleLimits,
+    EmergencyStop,
+    CommandRejected,
+    LinkDisconnected,
+    Text // free-form message; the value is its ErrorText id
+};
+
+// The last error of a device: a code, the offending value and when it was raised. Trivially copyable, so
+// it can be published through a Seqlock; raising and reading one never allocates. The message is only
+// rendered when message() is called.
+struct ErrorRecord
+{
+    ErrorCode code = ErrorCode::None;
+    int32_t value = 0;
+    int64_t timestampNs = 0; // steady_clock
+
+    static ErrorRecord raise(ErrorCode code, int32_t value = 0)
+    {
+        return {code, value, std::chrono::steady_clock::now().time_since_epoch().count()};
+    }
+    // Interns `message`; only the first occurrence of a given text allocates.
+    static ErrorRecord raise(std::string_view message);
+
+    explicit operator bool() const
+    {
+        return code != ErrorCode::None;
+    }
+    std::chrono::steady_clock::time_point timestamp() const
+    {
+        return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(timestampNs));
+    }
+    // Empty for ErrorCode::None.
+    std::optional<std::string> message() const;
+};
+
+// Process-wide table of free-form error texts, each stored once and referred to by id. Simulated and
+// driver errors repeat the same few messages, so after the first raise a lookup is all that is left.
+class ErrorText
+{
+  public:
+    static constexpr uint32_t kCapacity = 4096;
+    // Texts arriving once the table is full share this id.
+    static constexpr uint32_t kOverflow = kCapacity;
+
+    static uint32_t intern(std::string_view text);
+    static std::string_view lookup(uint32_t id);
+};
+
+} // namespace FingerFlexAid
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+namespace FingerFlexAid
+{
+
+// Compact reference to a registered device: an index into the manager's dense slot array plus the
+// generation the slot had when the device was registered. Unregistering bumps the slot's generation, so a
+// stale handle stops resolving instead of reaching whichever device reuses the slot.
+template <typename Tag> class DeviceHandle
+{
+  public:
+    constexpr DeviceHandle() = default;
+    constexpr DeviceHandle(uint32_t index, uint32_t generation) : index_(index), generation_(generation)
+    {
+    }
+
+    constexpr uint32_t index() const
+    {
+        return index_;
+    }
+    constexpr uint32_t generation() const
+    {
+        return generation_;
+    }
+    // Generation 0 is never handed out, so a default-constructed handle is invalid.
+    constexpr bool isValid() const
+    {
+        return generation_ != 0;
+    }
+    constexpr explicit operator bool() const
+    {
+        return isValid();
+    }
+
+    constexpr bool operator==(const DeviceHandle &) const = default;
+
+  private:
+    uint32_t index_ = 0;
+    uint32_t generation_ = 0;
+};
+
+struct MotorHandleTag;
+struct ServoHandleTag;
+
+using MotorHandle = DeviceHandle<MotorHandleTag>;
+using ServoHandle = DeviceHandle<ServoHandleTag>;
+
+} // namespace FingerFlexAid
@@ -1,146 +1,810 @@
 #include "DeviceManagerImpl.hpp"
+#include "utils/FunctionRef.hpp"
+#include <algorithm>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 namespace FingerFlexAid
 {
 
-DeviceManagerImpl::DeviceManagerImpl() = default;
-DeviceManagerImpl::~DeviceManagerImpl() = default;
+namespace
+{
 
-bool DeviceManagerImpl::registerMotor(const std::string &id, std::shared_ptr<MotorController> motor)
+// Holds a set of batch domains, entered in address order so that concurrent batches over overlapping
+// domains cannot deadlock. Sorts `domains` in place; it must outlive the scope.
+class BatchScope
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!motor || motors_.count(id))
-        return false;
-    motors_[id] = motor;
+  public:
+    explicit BatchScope(std::vector<BatchDomain *> &domains) : domains_(domains)
+    {
+        std::sort(domains_.begin(), domains_.end());
+        domains_.erase(std::unique(domains_.begin(), domains_.end()), domains_.end());
+        for (auto *domain : domains_)
+            domain->beginBatch();
+    }
+    ~BatchScope()
+    {
+        for (auto it = domains_.rbegin(); it != domains_.rend(); ++it)
+            (*it)->endBatch();
+    }
+
+    BatchScope(const BatchScope &) = delete;
+    BatchScope &operator=(const BatchScope &) = delete;
+
+  private:
+    std::vector<BatchDomain *> &domains_;
+};
+
+// Holds one batch domain, or none for a null one; unlike BatchScope it never allocates.
+class DomainHold
+{
+  public:
+    explicit DomainHold(BatchDomain *domain) : domain_(domain)
+    {
+        if (domain_)
+            domain_->beginBatch();
+    }
+    ~DomainHold()
+    {
+        if (domain_)
+            domain_->endBatch();
+    }
+
+    DomainHold(const DomainHold &) = delete;
+    DomainHold &operator=(const DomainHold &) = delete;
+
+  private:
+    BatchDomain *domain_;
+};
+
+// Working storage for applyBatch(). Each thread keeps one and reuses it, so a thread's batches stop
+// allocating once it has sent its largest.
+struct BatchScratch
+{
+    std::vector<std::pair<uint32_t, size_t>> order; // (slot, position in the batch)
+    std::vector<std::pair<MotorController *, MotorCommand>> motors;
+    std::vector<std::pair<ServoController *, ServoCommand>> servos;
+    std::vector<BatchDomain *> domains;
+    bool lent = false;
+};
+
+// Lends out the calling thread's BatchScratch, cleared; a batch started from inside a device's command on
+// the same thread gets storage of its own instead.
+class ScratchLease
+{
+  public:
+    ScratchLease()
+    {
+        thread_local BatchScratch threadScratch;
+        if (threadScratch.lent)
+        {
+            own_ = std::make_unique<BatchScratch>();
+            scratch_ = own_.get();
+        }
+        else
+            scratch_ = &threadScratch;
+        scratch_->lent = true;
+        scratch_->motors.clear();
+        scratch_->servos.clear();
+        scratch_->domains.clear();
+    }
+    ~ScratchLease()
+    {
+        scratch_->lent = false;
+    }
+
+    ScratchLease(const ScratchLease &) = delete;
+    ScratchLease &operator=(const ScratchLease &) = delete;
+
+    BatchScratch *operator->() const
+    {
+        return scratch_;
+    }
+
+  private:
+    std::unique_ptr<BatchScratch> own_;
+    BatchScratch *scratch_;
+};
+
+// Every command in a batch is checked against the state from before the batch, so none may depend on what
+// an earlier command for the same device changes: nothing but another emergency stop may follow one, since
+// it latches the error, and a motor takes at most one position, since each is checked against where the
+// motor stands.
+template <typename Handle, typename Command>
+bool commandsIndependent(const std::vector<std::pair<Handle, Command>> &commands,
+                         std::vector<std::pair<uint32_t, size_t>> &order)
+{
+    if (commands.size() < 2)
+        return true;
+    order.clear();
+    for (size_t i = 0; i < commands.size(); ++i)
+        order.emplace_back(commands[i].first.index(), i);
+    std::sort(order.begin(), order.end());
+
+    bool stopped = false;
+    bool positioned = false;
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        if (i == 0 || order[i].first != order[i - 1].first)
+            stopped = positioned = false;
+        const auto type = commands[order[i].second].second.type;
+        if (stopped && type != Command::Type::EmergencyStop)
+            return false;
+        stopped |= type == Command::Type::EmergencyStop;
+        if constexpr (std::is_same_v<Command, MotorCommand>)
+        {
+            if (type == MotorCommand::Type::SetPosition && std::exchange(positioned, true))
+                return false;
+        }
+    }
     return true;
 }
 
-bool DeviceManagerImpl::registerServo(const std::string &id, std::shared_ptr<ServoController> servo)
+} // namespace
+
+class DeviceManagerImpl::ReadGuard
+{
+  public:
+    explicit ReadGuard(const DeviceManagerImpl &manager)
+    {
+        // Each thread starts probing at its own slot, so an uncontended reader only ever writes its own line
+        static std::atomic<size_t> nextReader{0};
+        thread_local const size_t preferred = nextReader.fetch_add(1, std::memory_order_relaxed);
+
+        const Registry *seen = manager.current_.load(std::memory_order_seq_cst);
+        for (size_t probe = 0; probe < kReaderSlots; ++probe)
+        {
+            auto &slot = manager.readers_[(preferred + probe) % kReaderSlots];
+            const Registry *expected = nullptr;
+            if (!slot.registry.compare_exchange_strong(expected, seen, std::memory_order_seq_cst))
+                continue;
+            // Only a snapshot still current after it was named is safe: a writer replacing it later will
+            // find it in the slot and keep it.
+            for (const Registry *now; (now = manager.current_.load(std::memory_order_seq_cst)) != seen; seen = now)
+                slot.registry.store(now, std::memory_order_seq_cst);
+            slot_ = &slot;
+            registry_ = seen;
+            return;
+        }
+        fallback_ = manager.snapshot();
+        registry_ = fallback_.get();
+    }
+    ~ReadGuard()
+    {
+        if (slot_)
+            slot_->registry.store(nullptr, std::memory_order_release);
+    }
+
+    ReadGuard(const ReadGuard &) = delete;
+    ReadGuard &operator=(const ReadGuard &) = delete;
+
+    const Registry *operator->() const
+    {
+        return registry_;
+    }
+
+  private:
+    ReaderSlot *slot_ = nullptr;
+    const Registry *registry_ = nullptr;
+    std::shared_ptr<const Registry> fallback_;
+};
+
+class DeviceManagerImpl::StopWorkers
+{
+  public:
+    using Task = FunctionRef<void(size_t)>;
+
+    // Beyond this, further tasks queue behind the busy workers rather than getting a thread each
+    static constexpr size_t kMaxWorkers = 16;
+
+    ~StopWorkers()
+    {
+        stopping_.store(true, std::memory_order_relaxed);
+        round_.fetch_add(1, std::memory_order_release);
+        round_.notify_all();
+        for (auto &thread : threads_)
+            thread.join();
+    }
+
+    // Grows the pool so that `tasks` tasks can all run at once, the calling thread of run() included.
+    void reserve(size_t tasks)
+    {
+        std::lock_guard<std::mutex> lock(runMutex_);
+        const size_t wanted = std::min(tasks > 0 ? tasks - 1 : 0, kMaxWorkers);
+        // Handed the current round, so a thread that starts late cannot mistake the next one for it
+        while (threads_.size() < wanted)
+            threads_.emplace_back(&StopWorkers::work, this, round_.load(std::memory_order_relaxed));
+    }
+
+    // Runs task(0) .. task(count - 1) across the workers and this thread, returning once all have finished.
+    // Tasks are claimed one at a time, so a slow one ties up only the thread running it.
+    void run(size_t count, Task task)
+    {
+        std::lock_guard<std::mutex> lock(runMutex_);
+        task_ = &task;
+        count_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        if (count < 2)
+        {
+            // Nothing to share; waking the workers would only add their wake-up latency
+            drain();
+            return;
+        }
+        outstanding_.store(threads_.size(), std::memory_order_relaxed);
+        round_.fetch_add(1, std::memory_order_release);
+        round_.notify_all();
+        drain();
+        // Every worker reports back, so none can still be reading this round's task when the next begins
+        for (size_t left; (left = outstanding_.load(std::memory_order_acquire)) != 0;)
+            outstanding_.wait(left, std::memory_order_acquire);
+    }
+
+  private:
+    void drain()
+    {
+        for (size_t index; (index = next_.fetch_add(1, std::memory_order_relaxed)) < count_;)
+            (*task_)(index);
+    }
+
+    void work(uint64_t seen)
+    {
+        for (;;)
+        {
+            round_.wait(seen, std::memory_order_acquire);
+            seen = round_.load(std::memory_order_acquire);
+            if (stopping_.load(std::memory_order_relaxed))
+                return;
+            drain();
+            if (outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                outstanding_.notify_one();
+        }
+    }
+
+    std::mutex runMutex_; // one stop at a time, and no growth during one
+    std::vector<std::thread> threads_;
+    const Task *task_ = nullptr; // this round's; written before round_ is bumped
+    size_t count_ = 0;
+    std::atomic<size_t> next_{0};
+    std::atomic<size_t> outstanding_{0}; // workers yet to finish this round
+    std::atomic<uint64_t> round_{0};
+    std::atomic<bool> stopping_{false};
+};
+
+DeviceManagerImpl::DeviceManagerImpl(size_t statusCapacity)
+    : registry_(std::make_shared<const Registry>()), motorStatus_(statusCapacity, &errorSignal_),
+      servoStatus_(statusCapacity, &errorSignal_), stopWorkers_(std::make_unique<StopWorkers>())
+{
+    current_.store(registry_.load().get(), std::memory_order_seq_cst);
+}
+
+DeviceManagerImpl::~DeviceManagerImpl()
+{
+    // Devices may outlive the manager; they must stop publishing to its boards
+    auto registry = snapshot();
+    for (const auto &slot : registry->motors.slots)
+        if (slot.status)
+            slot.status->unsubscribe(motorStatus_, static_cast<uint32_t>(&slot - registry->motors.slots.data()));
+    for (const auto &slot : registry->servos.slots)
+        if (slot.status)
+            slot.status->unsubscribe(servoStatus_, static_cast<uint32_t>(&slot - registry->servos.slots.data()));
+}
+
+std::shared_ptr<const DeviceManagerImpl::Registry> DeviceManagerImpl::snapshot() const
+{
+    return registry_.load(std::memory_order_acquire);
+}
+
+template <typename Controller, typename Handle>
+Handle DeviceManagerImpl::Slots<Controller, Handle>::add(const std::string &id, std::shared_ptr<Controller> device)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!servo || servos_.count(id))
+    if (names.count(id))
+        return Handle{};
+    uint32_t index;
+    if (freeSlots.empty())
+    {
+        index = static_cast<uint32_t>(slots.size());
+        slots.emplace_back();
+    }
+    else
+    {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    auto &slot = slots[index];
+    slot.device = std::move(device);
+    slot.id = id;
+    Handle handle(index, slot.generation);
+    names.emplace(id, handle);
+    return handle;
+}
+
+template <typename Controller, typename Handle>
+bool DeviceManagerImpl::Slots<Controller, Handle>::remove(std::string_view id)
+{
+    auto it = names.find(id);
+    if (it == names.end())
         return false;
-    servos_[id] = servo;
+    auto &slot = slots[it->second.index()];
+    slot.device.reset();
+    slot.id.clear();
+    slot.status = nullptr;
+    // Skip 0 on wrap-around; it marks an invalid handle
+    if (++slot.generation == 0)
+        slot.generation = 1;
+    freeSlots.push_back(it->second.index());
+    names.erase(it);
     return true;
 }
 
-bool DeviceManagerImpl::unregisterDevice(const std::string &id)
+template <typename Controller, typename Handle>
+const std::shared_ptr<Controller> *DeviceManagerImpl::Slots<Controller, Handle>::find(Handle handle) const
+{
+    if (handle.index() >= slots.size())
+        return nullptr;
+    const auto &slot = slots[handle.index()];
+    return slot.device && slot.generation == handle.generation() ? &slot.device : nullptr;
+}
+
+DeviceManagerImpl::StopGroup &DeviceManagerImpl::Registry::stopGroup(BatchDomain *domain)
+{
+    auto [it, inserted] = stopGroupOf.try_emplace(domain, stopGroups.size());
+    if (inserted)
+        stopGroups.push_back(StopGroup{domain, {}, {}});
+    return stopGroups[it->second];
+}
+
+template <typename Device> void DeviceManagerImpl::Registry::fileForStop(BatchDomain *domain, Device *device)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    size_t removed = motors_.erase(id);
-    removed += servos_.erase(id);
-    return removed > 0;
+    auto &group = domain ? stopGroup(domain) : looseStops;
+    if constexpr (std::is_base_of_v<MotorController, Device>)
+        group.motors.push_back(device);
+    else
+        group.servos.push_back(device);
 }
 
-std::shared_ptr<MotorController> DeviceManagerImpl::getMotor(const std::string &id) const
+template <typename Device> void DeviceManagerImpl::Registry::unfileForStop(BatchDomain *domain, Device *device)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = motors_.find(id);
-    return it != motors_.end() ? it->second : nullptr;
+    auto found = stopGroupOf.find(domain);
+    if (domain && found == stopGroupOf.end())
+        return;
+    auto &group = domain ? stopGroups[found->second] : looseStops;
+    auto &list = [&]() -> auto & {
+        if constexpr (std::is_base_of_v<MotorController, Device>)
+            return group.motors;
+        else
+            return group.servos;
+    }();
+    if (auto it = std::find(list.begin(), list.end(), device); it != list.end())
+    {
+        *it = list.back();
+        list.pop_back();
+    }
+    if (!domain || !group.motors.empty() || !group.servos.empty())
+        return;
+    // Drop the empty group by moving the last one into its place
+    const size_t index = found->second;
+    stopGroupOf.erase(found);
+    if (index + 1 != stopGroups.size())
+    {
+        stopGroups[index] = std::move(stopGroups.back());
+        stopGroupOf[stopGroups[index].domain] = index;
+    }
+    stopGroups.pop_back();
+}
+
+size_t DeviceManagerImpl::Registry::stopTaskCount() const
+{
+    return stopGroups.size() + looseStops.motors.size() + looseStops.servos.size();
+}
+
+bool DeviceManagerImpl::Registry::runStopTask(size_t task) const
+{
+    // Devices without a domain come first: they are the ones likely to wait on a link, and started early
+    // their waits overlap the domain groups' work instead of following it
+    if (task < looseStops.motors.size())
+        return looseStops.motors[task]->applyCommand(MotorCommand::emergencyStop());
+    task -= looseStops.motors.size();
+    if (task < looseStops.servos.size())
+        return looseStops.servos[task]->applyCommand(ServoCommand::emergencyStop());
+    const auto &group = stopGroups[task - looseStops.servos.size()];
+    DomainHold hold(group.domain);
+    bool any = false;
+    for (auto *motor : group.motors)
+        any |= motor->applyCommand(MotorCommand::emergencyStop());
+    for (auto *servo : group.servos)
+        any |= servo->applyCommand(ServoCommand::emergencyStop());
+    return any;
 }
 
-std::shared_ptr<ServoController> DeviceManagerImpl::getServo(const std::string &id) const
+template <typename Change> auto DeviceManagerImpl::update(Change &&change)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = servos_.find(id);
-    return it != servos_.end() ? it->second : nullptr;
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    auto next = std::make_shared<Registry>(*registry_.load(std::memory_order_relaxed));
+    auto result = change(*next);
+    if (result)
+    {
+        retired_.push_back(registry_.load(std::memory_order_relaxed));
+        current_.store(next.get(), std::memory_order_seq_cst);
+        registry_.store(std::move(next), std::memory_order_release);
+        reclaim();
+    }
+    return result;
+}
+
+void DeviceManagerImpl::reclaim()
+{
+    // Pairs with the seq_cst store of current_: a reader either sees the new snapshot when it rechecks, or
+    // its slot is seen here
+    std::erase_if(retired_, [this](const std::shared_ptr<const Registry> &registry) {
+        return std::none_of(readers_.begin(), readers_.end(), [&](const ReaderSlot &slot) {
+            return slot.registry.load(std::memory_order_seq_cst) == registry.get();
+        });
+    });
+}
+
+template <typename Slot> void DeviceManagerImpl::attachStatus(Slot &slot, uint32_t index, DeviceStatusBoard &board)
+{
+    if (index < board.capacity())
+        slot.status = slot.device->getStatusPublisher();
+    if (slot.status)
+        slot.status->subscribe(board, index);
+    else
+        polledDevices_.fetch_add(1, std::memory_order_release);
+}
+
+template <typename Slot> void DeviceManagerImpl::detachStatus(Slot &slot, uint32_t index, DeviceStatusBoard &board)
+{
+    if (slot.status)
+        slot.status->unsubscribe(board, index);
+    else
+        polledDevices_.fetch_sub(1, std::memory_order_release);
+}
+
+template <typename Query> bool DeviceManagerImpl::anyPolled(Query &&query) const
+{
+    if (polledDevices_.load(std::memory_order_acquire) == 0)
+        return false;
+    ReadGuard registry(*this);
+    for (const auto &slot : registry->motors.slots)
+        if (slot.device && !slot.status && query(*slot.device))
+            return true;
+    for (const auto &slot : registry->servos.slots)
+        if (slot.device && !slot.status && query(*slot.device))
+            return true;
+    return false;
+}
+
+MotorHandle DeviceManagerImpl::registerMotor(const std::string &id, std::shared_ptr<MotorController> motor)
+{
+    if (!motor)
+        return MotorHandle{};
+    MotorHandle registered = update([&](Registry &registry) {
+        MotorHandle handle = registry.motors.add(id, std::move(motor));
+        if (handle)
+        {
+            auto &slot = registry.motors.slots[handle.index()];
+            attachStatus(slot, handle.index(), motorStatus_);
+            slot.domain = slot.device->getBatchDomain();
+            registry.fileForStop(slot.domain, slot.device.get());
+        }
+        return handle;
+    });
+    if (registered)
+        stopWorkers_->reserve(snapshot()->stopTaskCount());
+    return registered;
+}
+
+ServoHandle DeviceManagerImpl::registerServo(const std::string &id, std::shared_ptr<ServoController> servo)
+{
+    if (!servo)
+        return ServoHandle{};
+    ServoHandle registered = update([&](Registry &registry) {
+        ServoHandle handle = registry.servos.add(id, std::move(servo));
+        if (handle)
+        {
+            auto &slot = registry.servos.slots[handle.index()];
+            attachStatus(slot, handle.index(), servoStatus_);
+            slot.domain = slot.device->getBatchDomain();
+            registry.fileForStop(slot.domain, slot.device.get());
+        }
+        return handle;
+    });
+    if (registered)
+        stopWorkers_->reserve(snapshot()->stopTaskCount());
+    return registered;
+}
+
+bool DeviceManagerImpl::unregisterDevice(std::string_view id)
+{
+    auto detach = [&](Registry &registry, auto &kind, DeviceStatusBoard &board) {
+        auto it = kind.names.find(id);
+        if (it == kind.names.end())
+            return false;
+        auto &slot = kind.slots[it->second.index()];
+        detachStatus(slot, it->second.index(), board);
+        registry.unfileForStop(slot.domain, slot.device.get());
+        slot.domain = nullptr;
+        return kind.remove(id);
+    };
+    return update([&](Registry &registry) {
+        bool removed = detach(registry, registry.motors, motorStatus_);
+        removed |= detach(registry, registry.servos, servoStatus_);
+        return removed;
+    });
+}
+
+std::shared_ptr<MotorController> DeviceManagerImpl::getMotor(MotorHandle handle) const
+{
+    ReadGuard registry(*this);
+    auto *motor = registry->motors.find(handle);
+    return motor ? *motor : nullptr;
+}
+
+std::shared_ptr<ServoController> DeviceManagerImpl::getServo(ServoHandle handle) const
+{
+    ReadGuard registry(*this);
+    auto *servo = registry->servos.find(handle);
+    return servo ? *servo : nullptr;
+}
+
+bool DeviceManagerImpl::applyBatch(const CommandBatch &batch)
+{
+    ScratchLease scratch;
+    if (!commandsIndependent(batch.motors, scratch->order) || !commandsIndependent(batch.servos, scratch->order))
+        return false;
+    // The snapshot keeps every device alive for the batch, even if it is unregistered meanwhile
+    auto registry = snapshot();
+
+    auto &motors = scratch->motors;
+    auto &servos = scratch->servos;
+    auto &domains = scratch->domains;
+    for (const auto &[handle, command] : batch.motors)
+    {
+        auto *motor = registry->motors.find(handle);
+        if (!motor)
+            return false;
+        motors.emplace_back(motor->get(), command);
+        if (auto *domain = (*motor)->getBatchDomain())
+            domains.push_back(domain);
+        else if (batch.size() > 1)
+            return false;
+    }
+    for (const auto &[handle, command] : batch.servos)
+    {
+        auto *servo = registry->servos.find(handle);
+        if (!servo)
+            return false;
+        servos.emplace_back(servo->get(), command);
+        if (auto *domain = (*servo)->getBatchDomain())
+            domains.push_back(domain);
+        else if (batch.size() > 1)
+            return false;
+    }
+
+    BatchScope scope(domains);
+    for (const auto &[motor, command] : motors)
+        if (!motor->checkCommand(command))
+            return false;
+    for (const auto &[servo, command] : servos)
+        if (!servo->checkCommand(command))
+            return false;
+
+    bool success = true;
+    for (const auto &[motor, command] : motors)
+        success &= motor->applyCommand(command);
+    for (const auto &[servo, command] : servos)
+        success &= servo->applyCommand(command);
+
+    // Recorded while the domains are still held, so the commands land in the session before any state they
+    // cause, and as one group, so a player can replay them as one batch again.
+    if (auto *recorder = recorder_.load(std::memory_order_acquire))
+    {
+        recorder->record(batch.size(), [&](size_t i) {
+            if (i < batch.motors.size())
+            {
+                const auto &[handle, command] = batch.motors[i];
+                return SessionRecord::command(SessionRecordType::MotorCommand,
+                                              registry->motors.slots[handle.index()].id,
+                                              static_cast<uint8_t>(command.type), command.value);
+            }
+            const auto &[handle, command] = batch.servos[i - batch.motors.size()];
+            return SessionRecord::command(SessionRecordType::ServoCommand, registry->servos.slots[handle.index()].id,
+                                          static_cast<uint8_t>(command.type), command.value);
+        });
+    }
+    return success;
+}
+
+MotorHandle DeviceManagerImpl::findMotor(std::string_view id) const
+{
+    ReadGuard registry(*this);
+    auto it = registry->motors.names.find(id);
+    return it != registry->motors.names.end() ? it->second : MotorHandle{};
+}
+
+ServoHandle DeviceManagerImpl::findServo(std::string_view id) const
+{
+    ReadGuard registry(*this);
+    auto it = registry->servos.names.find(id);
+    return it != registry->servos.names.end() ? it->second : ServoHandle{};
+}
+
+std::shared_ptr<MotorController> DeviceManagerImpl::getMotor(std::string_view id) const
+{
+    // One read for both steps, so the name and the slot come from the same snapshot
+    ReadGuard registry(*this);
+    auto it = registry->motors.names.find(id);
+    return it != registry->motors.names.end() ? *registry->motors.find(it->second) : nullptr;
+}
+
+std::shared_ptr<ServoController> DeviceManagerImpl::getServo(std::string_view id) const
+{
+    ReadGuard registry(*this);
+    auto it = registry->servos.names.find(id);
+    return it != registry->servos.names.end() ? *registry->servos.find(it->second) : nullptr;
 }
 
 std::vector<std::string> DeviceManagerImpl::getMotorIds() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
     std::vector<std::string> ids;
-    for (const auto &kv : motors_)
-        ids.push_back(kv.first);
+    ids.reserve(getMotorCount());
+    forEachMotorId([&](std::string_view id) { ids.emplace_back(id); });
     return ids;
 }
 
 std::vector<std::string> DeviceManagerImpl::getServoIds() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
     std::vector<std::string> ids;
-    for (const auto &kv : servos_)
-        ids.push_back(kv.first);
+    ids.reserve(getServoCount());
+    forEachServoId([&](std::string_view id) { ids.emplace_back(id); });
     return ids;
 }
 
+void DeviceManagerImpl::forEachMotorId(IdVisitor visit) const
+{
+    auto registry = snapshot();
+    // The dense slot array, not the name index: no node chasing
+    for (const auto &slot : registry->motors.slots)
+        if (slot.device)
+            visit(slot.id);
+}
+
+void DeviceManagerImpl::forEachServoId(IdVisitor visit) const
+{
+    auto registry = snapshot();
+    for (const auto &slot : registry->servos.slots)
+        if (slot.device)
+            visit(slot.id);
+}
+
 bool DeviceManagerImpl::initializeAll()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto registry = snapshot();
+    for (const auto &slot : registry->motors.slots)
+        if (slot.device)
+            slot.device->resume();
+    for (const auto &slot : registry->servos.slots)
+        if (slot.device)
+            slot.device->resume();
     initialized_ = true;
     return true;
 }
 
 bool DeviceManagerImpl::shutdownAll()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
     initialized_ = false;
+    // Every worker is asked before any is joined, so they wind down together; the joins happen as the
+    // devices are destroyed and find their threads already finished.
+    auto registry = snapshot();
+    for (const auto &slot : registry->motors.slots)
+        if (slot.device)
+            slot.device->requestShutdown();
+    for (const auto &slot : registry->servos.slots)
+        if (slot.device)
+            slot.device->requestShutdown();
     return true;
 }
 
 bool DeviceManagerImpl::emergencyStopAll()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    bool any = false;
-    for (auto &kv : motors_)
-        any |= kv.second->emergencyStop();
-    for (auto &kv : servos_)
-        any |= kv.second->emergencyStop();
-    return any;
+    // Signal first: simulation engines and control loops polling the epoch react on their next tick, without
+    // waiting for the fan-out below to reach them. Devices with no tick of their own (serial devices, and any
+    // without a batch domain) are stopped only by the fan-out.
+    emergencyStop_.trigger();
+    if (auto *recorder = recorder_.load(std::memory_order_acquire))
+        recorder->record(SessionRecord::command(SessionRecordType::EmergencyStop, {}, 0, 0));
+    auto registry = snapshot();
+
+    // The groups and the workers are kept by registration, so the stop itself neither allocates nor starts
+    // a thread. Each domain group and each device without a domain is a task of its own, run in parallel.
+    std::atomic<bool> any{false};
+    stopWorkers_->run(registry->stopTaskCount(), [&](size_t task) {
+        if (registry->runStopTask(task))
+            any.store(true, std::memory_order_relaxed);
+    });
+    return any.load(std::memory_order_relaxed);
+}
+
+void DeviceManagerImpl::setRecorder(SessionRecorder *recorder)
+{
+    recorder_.store(recorder, std::memory_order_release);
 }
 
 bool DeviceManagerImpl::isAnyDeviceMoving() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto &kv : motors_)
-        if (kv.second->isMoving())
-            return true;
-    for (const auto &kv : servos_)
-        if (kv.second->isMoving())
-            return true;
-    return false;
+    if (motorStatus_.anyMoving() || servoStatus_.anyMoving())
+        return true;
+    return anyPolled([](const auto &device) { return device.isMoving(); });
 }
 
 bool DeviceManagerImpl::isAnyDeviceInError() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto &kv : motors_)
-        if (kv.second->isError())
-            return true;
-    for (const auto &kv : servos_)
-        if (kv.second->isError())
+    if (motorStatus_.anyError() || servoStatus_.anyError())
+        return true;
+    return anyPolled([](const auto &device) { return device.isError(); });
+}
+
+bool DeviceManagerImpl::waitAnyError(std::chrono::nanoseconds timeout) const
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;)
+    {
+        const uint32_t seen = errorSignal_.value();
+        if (isAnyDeviceInError())
             return true;
-    return false;
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline)
+            return false;
+        std::chrono::steady_clock::time_point wakeAt = deadline;
+        if (polledDevices_.load(std::memory_order_acquire) != 0)
+            wakeAt = std::min<std::chrono::steady_clock::time_point>(deadline, now + kPollInterval);
+        errorSignal_.waitForChange(seen, wakeAt);
+    }
 }
 
 std::vector<std::string> DeviceManagerImpl::getDevicesInError() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
     std::vector<std::string> ids;
-    for (const auto &kv : motors_)
-        if (kv.second->isError())
-            ids.push_back(kv.first);
-    for (const auto &kv : servos_)
-        if (kv.second->isError())
-            ids.push_back(kv.first);
+    forEachDeviceInError([&](std::string_view id) { ids.emplace_back(id); });
     return ids;
 }
 
+void DeviceManagerImpl::forEachDeviceInError(IdVisitor visit) const
+{
+    auto registry = snapshot();
+    // The boards are live and the snapshot is not: since it was taken, a slot may have been released and
+    // reused by a device in error. A bit is therefore reported only if the snapshot's own device for that
+    // slot confirms it, so it never goes out under another device's id.
+    auto report = [&](const auto &slots, uint32_t index) {
+        if (index < slots.size() && slots[index].status && slots[index].device->isError())
+            visit(slots[index].id);
+    };
+    motorStatus_.forEachError([&](uint32_t index) { report(registry->motors.slots, index); });
+    servoStatus_.forEachError([&](uint32_t index) { report(registry->servos.slots, index); });
+    if (polledDevices_.load(std::memory_order_acquire) == 0)
+        return;
+
+    for (const auto &slot : registry->motors.slots)
+        if (slot.device && !slot.status && slot.device->isError())
+            visit(slot.id);
+    for (const auto &slot : registry->servos.slots)
+        if (slot.device && !slot.status && slot.device->isError())
+            visit(slot.id);
+}
+
 size_t DeviceManagerImpl::getMotorCount() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return motors_.size();
+    return ReadGuard(*this)->motors.size();
 }
 
 size_t DeviceManagerImpl::getServoCount() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return servos_.size();
+    return ReadGuard(*this)->servos.size();
 }
 
 bool DeviceManagerImpl::isInitialized() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
     return initialized_;
 }
 
@@ -1,9 +1,16 @@
 #pragma once
 
+#include "DeviceCommand.hpp"
+#include "DeviceHandle.hpp"
+#include "EmergencyStop.hpp"
 #include "MotorController.hpp"
 #include "ServoController.hpp"
+#include "utils/FunctionRef.hpp"
+#include <chrono>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -15,21 +22,67 @@ class DeviceManager
   public:
     virtual ~DeviceManager() = default;
 
-    virtual bool registerMotor(const std::string &id, std::shared_ptr<MotorController> motor) = 0;
-    virtual bool registerServo(const std::string &id, std::shared_ptr<ServoController> servo) = 0;
-    virtual bool unregisterDevice(const std::string &id) = 0;
+    // Called with each id in turn; the view points into the registry and is valid only during the call.
+    using IdVisitor = FunctionRef<void(std::string_view id)>;
 
-    virtual std::shared_ptr<MotorController> getMotor(const std::string &id) const = 0;
-    virtual std::shared_ptr<ServoController> getServo(const std::string &id) const = 0;
+    // Registration returns an invalid handle if the id is taken or the device is null.
+    virtual MotorHandle registerMotor(const std::string &id, std::shared_ptr<MotorController> motor) = 0;
+    virtual ServoHandle registerServo(const std::string &id, std::shared_ptr<ServoController> servo) = 0;
+    virtual bool unregisterDevice(std::string_view id) = 0;
+
+    // Hot path: handle lookups index a dense slot array, with no hashing or allocation.
+    virtual std::shared_ptr<MotorController> getMotor(MotorHandle handle) const = 0;
+    virtual std::shared_ptr<ServoController> getServo(ServoHandle handle) const = 0;
+
+    // Applies every command in the batch or none. All handles must resolve and every device must accept its
+    // command, checked while the devices' batch domains are held, before the first command is applied;
+    // readers of those devices see either none or all of the batch. Checks see the state from before the
+    // batch, so a batch is refused if a device gets anything after an emergency stop, or a motor more than
+    // one position. A device without a batch domain can only be commanded in a batch of one command, since
+    // nothing would hold it between the check and the setter.
+    virtual bool applyBatch(const CommandBatch &batch) = 0;
+
+    // Cold path: lookups by name, hashed straight from the view without building a std::string.
+    virtual MotorHandle findMotor(std::string_view id) const = 0;
+    virtual ServoHandle findServo(std::string_view id) const = 0;
+    virtual std::shared_ptr<MotorController> getMotor(std::string_view id) const = 0;
+    virtual std::shared_ptr<ServoController> getServo(std::string_view id) const = 0;
     virtual std::vector<std::string> getMotorIds() const = 0;
     virtual std::vector<std::string> getServoIds() const = 0;
+    // Enumeration in place, without allocating.
+    virtual void forEachMotorId(IdVisitor visit) const = 0;
+    virtual void forEachServoId(IdVisitor visit) const = 0;
+    // Fill `ids` from the front and return the filled part. Entries past it are kept, cleared, as spare
+    // storage, so a monitor polling with the same vector stops allocating once it has seen its largest
+    // result.
+    std::span<const std::string> fillMotorIds(std::vector<std::string> &ids) const
+    {
+        return fillIds(ids, [this](IdVisitor visit) { forEachMotorId(visit); });
+    }
+    std::span<const std::string> fillServoIds(std::vector<std::string> &ids) const
+    {
+        return fillIds(ids, [this](IdVisitor visit) { forEachServoId(visit); });
+    }
 
+    // Restarts any device worker threads a previous shutdownAll() stopped (see MotorController::resume).
     virtual bool initializeAll() = 0;
+    // Asks every device's worker threads to stop at once (see MotorController::requestShutdown); devices
+    // stay registered, and initializeAll() brings their threads back.
     virtual bool shutdownAll() = 0;
+    // Triggers the manager's own EmergencyStop epoch, then stops every device before returning.
     virtual bool emergencyStopAll() = 0;
+    // That epoch, for loops and engines that should react to this manager's stops.
+    virtual const EmergencyStop &getEmergencyStop() const = 0;
     virtual bool isAnyDeviceMoving() const = 0;
     virtual bool isAnyDeviceInError() const = 0;
     virtual std::vector<std::string> getDevicesInError() const = 0;
+    virtual void forEachDeviceInError(IdVisitor visit) const = 0;
+    std::span<const std::string> fillDevicesInError(std::vector<std::string> &ids) const
+    {
+        return fillIds(ids, [this](IdVisitor visit) { forEachDeviceInError(visit); });
+    }
+    // Blocks until some device is in error, or the timeout passes; false on timeout.
+    virtual bool waitAnyError(std::chrono::nanoseconds timeout) const = 0;
 
     virtual size_t getMotorCount() const = 0;
     virtual size_t getServoCount() const = 0;
@@ -41,6 +94,23 @@ class DeviceManager
     DeviceManager &operator=(const DeviceManager &) = default;
     DeviceManager(DeviceManager &&) = default;
     DeviceManager &operator=(DeviceManager &&) = default;
+
+  private:
+    template <typename Enumerate>
+    static std::span<const std::string> fillIds(std::vector<std::string> &ids, Enumerate &&enumerate)
+    {
+        size_t count = 0;
+        enumerate([&](std::string_view id) {
+            if (count < ids.size())
+                ids[count].assign(id);
+            else
+                ids.emplace_back(id);
+            ++count;
+        });
+        for (size_t i = count; i < ids.size(); ++i)
+            ids[i].clear();
+        return {ids.data(), count};
+    }
 };
 
 }
@@ -1,29 +1,58 @@
 #pragma once
 
 #include "DeviceManager.hpp"
+#include "DeviceStatus.hpp"
+#include "EmergencyStop.hpp"
+#include "utils/SessionRecording.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 namespace FingerFlexAid
 {
 
+// Device registry with a copy-on-write read path: lookups and scans work on an immutable snapshot and never
+// wait for the registration mutex. Writers copy the current snapshot, modify the copy and publish it.
+// std::atomic<std::shared_ptr> is not lock-free on libstdc++, and every load of it also bumps one shared
+// reference count, so the hot lookups (by handle or name, counts, polled health) read a plain pointer to
+// the current snapshot instead, guarded by a hazard slot that only the reading thread writes; writers keep
+// each replaced snapshot until no slot names it. Scans and batches, which may run long or call back into
+// the manager, take a shared_ptr snapshot as before. Lookups still return a shared_ptr to the device, so
+// they do bump that device's own count.
+// Health queries read per-kind status boards that publishing devices keep current, indexed by slot; only
+// devices that do not publish, or whose slot lies beyond the board capacity, are polled.
 class DeviceManagerImpl : public DeviceManager
 {
   public:
-    DeviceManagerImpl();
+    static constexpr size_t kDefaultStatusCapacity = 1 << 16;
+    static constexpr std::chrono::milliseconds kPollInterval{20};
+
+    explicit DeviceManagerImpl(size_t statusCapacity = kDefaultStatusCapacity);
     ~DeviceManagerImpl() override;
 
-    bool registerMotor(const std::string &id, std::shared_ptr<MotorController> motor) override;
-    bool registerServo(const std::string &id, std::shared_ptr<ServoController> servo) override;
-    bool unregisterDevice(const std::string &id) override;
+    MotorHandle registerMotor(const std::string &id, std::shared_ptr<MotorController> motor) override;
+    ServoHandle registerServo(const std::string &id, std::shared_ptr<ServoController> servo) override;
+    bool unregisterDevice(std::string_view id) override;
+
+    std::shared_ptr<MotorController> getMotor(MotorHandle handle) const override;
+    std::shared_ptr<ServoController> getServo(ServoHandle handle) const override;
 
-    std::shared_ptr<MotorController> getMotor(const std::string &id) const override;
-    std::shared_ptr<ServoController> getServo(const std::string &id) const override;
+    bool applyBatch(const CommandBatch &batch) override;
+
+    MotorHandle findMotor(std::string_view id) const override;
+    ServoHandle findServo(std::string_view id) const override;
+    std::shared_ptr<MotorController> getMotor(std::string_view id) const override;
+    std::shared_ptr<ServoController> getServo(std::string_view id) const override;
     std::vector<std::string> getMotorIds() const override;
     std::vector<std::string> getServoIds() const override;
+    void forEachMotorId(IdVisitor visit) const override;
+    void forEachServoId(IdVisitor visit) const override;
 
     bool initializeAll() override;
     bool shutdownAll() override;
@@ -31,16 +60,126 @@ class DeviceManagerImpl : public DeviceManager
     bool isAnyDeviceMoving() const override;
     bool isAnyDeviceInError() const override;
     std::vector<std::string> getDevicesInError() const override;
+    void forEachDeviceInError(IdVisitor visit) const override;
+    // Sleeps on the status boards; devices that do not publish their flags are polled every kPollInterval.
+    bool waitAnyError(std::chrono::nanoseconds timeout) const override;
 
     size_t getMotorCount() const override;
     size_t getServoCount() const override;
     bool isInitialized() const override;
 
+    // This manager's own, so loops and engines watching it react to this manager's stops only.
+    const EmergencyStop &getEmergencyStop() const override
+    {
+        return emergencyStop_;
+    }
+
+    // Records every applied batch command and emergency stop until detached with nullptr, so a SessionPlayer
+    // can reproduce them. Commands sent to controllers directly, bypassing the manager, are not recorded.
+    // The recorder must outlive the manager or be detached first.
+    void setRecorder(SessionRecorder *recorder);
+
   private:
-    mutable std::mutex mutex_;
-    std::unordered_map<std::string, std::shared_ptr<MotorController>> motors_;
-    std::unordered_map<std::string, std::shared_ptr<ServoController>> servos_;
-    bool initialized_ = false;
+    // Lets the name index be searched with any string_view.
+    struct IdHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view id) const
+        {
+            return std::hash<std::string_view>{}(id);
+        }
+    };
+
+    // Dense slot array for one device kind, plus the name index used on the cold path.
+    template <typename Controller, typename Handle> struct Slots
+    {
+        struct Slot
+        {
+            std::shared_ptr<Controller> device; // null while the slot is free
+            uint32_t generation = 1;
+            std::string id;
+            StatusPublisher *status = nullptr; // subscribed to the board; null if the device is polled
+            BatchDomain *domain = nullptr;     // the e-stop group the device is filed under
+        };
+
+        std::vector<Slot> slots;
+        std::vector<uint32_t> freeSlots;
+        std::unordered_map<std::string, Handle, IdHash, std::equal_to<>> names;
+
+        Handle add(const std::string &id, std::shared_ptr<Controller> device);
+        bool remove(std::string_view id);
+        const std::shared_ptr<Controller> *find(Handle handle) const;
+        size_t size() const
+        {
+            return names.size();
+        }
+    };
+
+    // Devices that share a batch domain, stopped under one hold of it as one task. Devices without a domain
+    // are kept in a group of their own and stopped as a task each, so a slow one holds up nothing else.
+    struct StopGroup
+    {
+        BatchDomain *domain = nullptr;
+        std::vector<MotorController *> motors;
+        std::vector<ServoController *> servos;
+    };
+
+    struct Registry
+    {
+        Slots<MotorController, MotorHandle> motors;
+        Slots<ServoController, ServoHandle> servos;
+        // Kept current by registration, so emergencyStopAll() only walks them
+        std::vector<StopGroup> stopGroups;
+        std::unordered_map<BatchDomain *, size_t> stopGroupOf;
+        StopGroup looseStops; // devices without a domain
+
+        StopGroup &stopGroup(BatchDomain *domain);
+        template <typename Device> void fileForStop(BatchDomain *domain, Device *device);
+        template <typename Device> void unfileForStop(BatchDomain *domain, Device *device);
+        // One task per device in looseStops, then one per domain group; each may run on its own thread.
+        size_t stopTaskCount() const;
+        bool runStopTask(size_t task) const;
+    };
+
+    // Persistent threads that emergencyStopAll() fans its stop tasks out to, grown at registration so the
+    // stop itself neither allocates nor starts a thread.
+    class StopWorkers;
+
+    // A hazard slot: the snapshot one reader is using, or null while the slot is free. Padded so readers on
+    // different slots never share a cache line.
+    struct alignas(64) ReaderSlot
+    {
+        std::atomic<const Registry *> registry{nullptr};
+    };
+    static constexpr size_t kReaderSlots = 64;
+    // Pins the current snapshot for one hot-path read; falls back to a shared_ptr if every slot is busy.
+    class ReadGuard;
+
+    std::shared_ptr<const Registry> snapshot() const;
+    // Drops replaced snapshots that no reader slot names any more; the caller holds writeMutex_.
+    void reclaim();
+    // Applies `change` to a copy of the registry under writeMutex_ and publishes the copy if the result is
+    // truthy; returns the result.
+    template <typename Change> auto update(Change &&change);
+    // Subscribe a freshly added slot to the board, or count it as polled; and the reverse on removal.
+    template <typename Slot> void attachStatus(Slot &slot, uint32_t index, DeviceStatusBoard &board);
+    template <typename Slot> void detachStatus(Slot &slot, uint32_t index, DeviceStatusBoard &board);
+    // Polls the devices that are not on a board.
+    template <typename Query> bool anyPolled(Query &&query) const;
+
+    std::mutex writeMutex_; // serialises writers; readers never take it
+    std::atomic<std::shared_ptr<const Registry>> registry_;
+    std::atomic<const Registry *> current_; // the snapshot registry_ owns, for ReadGuard
+    mutable std::array<ReaderSlot, kReaderSlots> readers_;
+    std::vector<std::shared_ptr<const Registry>> retired_; // replaced snapshots; guarded by writeMutex_
+    std::atomic<bool> initialized_{false};
+    ChangeSignal errorSignal_; // shared by both boards
+    DeviceStatusBoard motorStatus_;
+    DeviceStatusBoard servoStatus_;
+    std::atomic<size_t> polledDevices_{0};
+    std::atomic<SessionRecorder *> recorder_{nullptr};
+    EmergencyStop emergencyStop_;
+    std::unique_ptr<StopWorkers> stopWorkers_;
 };
 
 } // namespace FingerFlexAid
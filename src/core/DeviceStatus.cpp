@@ -0,0 +1,158 @@
+#include "DeviceStatus.hpp"
+#include <algorithm>
+
+namespace FingerFlexAid
+{
+
+namespace
+{
+
+// Sets or clears one bit; returns whether it changed.
+bool assignBit(std::atomic<uint64_t> &word, uint32_t index, bool value)
+{
+    const uint64_t bit = uint64_t{1} << (index % 64);
+    if (value)
+        return !(word.fetch_or(bit, std::memory_order_acq_rel) & bit);
+    return word.fetch_and(~bit, std::memory_order_acq_rel) & bit;
+}
+
+// Returns whether the bit changed.
+bool assign(std::atomic<uint64_t> *words, std::atomic<size_t> &count, uint32_t index, bool value)
+{
+    if (!assignBit(words[index / 64], index, value))
+        return false;
+    if (value)
+        count.fetch_add(1, std::memory_order_acq_rel);
+    else
+        count.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+} // namespace
+
+DeviceStatusBoard::DeviceStatusBoard(size_t capacity, ChangeSignal *errorSignal)
+    : capacity_(capacity),
+      errorSignal_(errorSignal),
+      errors_(std::make_unique<std::atomic<uint64_t>[]>((capacity + 63) / 64)),
+      moving_(std::make_unique<std::atomic<uint64_t>[]>((capacity + 63) / 64))
+{
+}
+
+void DeviceStatusBoard::setError(uint32_t index, bool error)
+{
+    extendTo(index);
+    if (assign(errors_.get(), errorCount_, index, error) && errorSignal_)
+        errorSignal_->signal();
+}
+
+void DeviceStatusBoard::setMoving(uint32_t index, bool moving)
+{
+    extendTo(index);
+    assign(moving_.get(), movingCount_, index, moving);
+}
+
+void DeviceStatusBoard::clear(uint32_t index)
+{
+    if (assign(errors_.get(), errorCount_, index, false) && errorSignal_)
+        errorSignal_->signal();
+    assign(moving_.get(), movingCount_, index, false);
+}
+
+void DeviceStatusBoard::extendTo(uint32_t index)
+{
+    uint32_t extent = extent_.load(std::memory_order_relaxed);
+    while (index >= extent && !extent_.compare_exchange_weak(extent, index + 1, std::memory_order_release))
+    {
+    }
+}
+
+void StatusPublisher::subscribe(DeviceStatusBoard &board, uint32_t index)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    boards_.emplace_back(&board, index);
+    board.setError(index, publishedError_.load(std::memory_order_acquire));
+    board.setMoving(index, publishedMoving_.load(std::memory_order_acquire));
+}
+
+void StatusPublisher::unsubscribe(DeviceStatusBoard &board, uint32_t index)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find(boards_.begin(), boards_.end(), std::make_pair(&board, index));
+    if (it == boards_.end())
+        return;
+    boards_.erase(it);
+    board.clear(index);
+}
+
+uint64_t StatusPublisher::addStatusListener(StatusListener listener)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    listeners_.emplace_back(nextListenerId_, std::move(listener));
+    return nextListenerId_++;
+}
+
+void StatusPublisher::removeStatusListener(uint64_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::erase_if(listeners_, [id](const auto &entry) { return entry.first == id; });
+}
+
+void StatusPublisher::publishError(bool error)
+{
+    if (publishedError_.exchange(error, std::memory_order_acq_rel) == error)
+        return;
+    // Publish whatever the flag holds by now, so the last of several racing flips always wins
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool current = publishedError_.load(std::memory_order_acquire);
+    for (auto [board, index] : boards_)
+        board->setError(index, current);
+    notifyLocked();
+}
+
+void StatusPublisher::publishMoving(bool moving)
+{
+    if (publishedMoving_.exchange(moving, std::memory_order_acq_rel) == moving)
+        return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool current = publishedMoving_.load(std::memory_order_acquire);
+    for (auto [board, index] : boards_)
+        board->setMoving(index, current);
+    notifyLocked();
+}
+
+void StatusPublisher::notifyLocked()
+{
+    changed_.signal();
+    if (listeners_.empty())
+        return;
+    const bool error = publishedError_.load(std::memory_order_acquire);
+    const bool moving = publishedMoving_.load(std::memory_order_acquire);
+    for (const auto &[id, listener] : listeners_)
+        listener(error, moving);
+}
+
+template <typename Done> bool StatusPublisher::waitFor(Done &&done, std::chrono::nanoseconds timeout) const
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;)
+    {
+        // Read the signal before the flag: a flip in between moves the signal, so the wait returns at once
+        const uint32_t seen = changed_.value();
+        if (done())
+            return true;
+        if (!changed_.waitForChange(seen, deadline))
+            return done();
+    }
+}
+
+bool StatusPublisher::waitUntilStopped(std::chrono::nanoseconds timeout) const
+{
+    return waitFor([this] { return !publishedMoving_.load(std::memory_order_acquire); }, timeout);
+}
+
+bool StatusPublisher::waitForError(std::chrono::nanoseconds timeout) const
+{
+    return waitFor([this] { return publishedError_.load(std::memory_order_acquire); }, timeout);
+}
+
+} // namespace FingerFlexAid
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "utils/ChangeSignal.hpp"
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace FingerFlexAid
+{
+
+// Aggregate health of a set of devices: one error bit and one moving bit per device index, plus running
+// counts of each. The devices keep it current themselves (see StatusPublisher), so anyError()/anyMoving()
+// are a single atomic load and the devices in error are found by walking the error bits.
+class DeviceStatusBoard
+{
+  public:
+    // `errorSignal`, if given, is signalled whenever a device's error bit flips; several boards may share one.
+    explicit DeviceStatusBoard(size_t capacity, ChangeSignal *errorSignal = nullptr);
+
+    DeviceStatusBoard(const DeviceStatusBoard &) = delete;
+    DeviceStatusBoard &operator=(const DeviceStatusBoard &) = delete;
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    // Idempotent; the counts change only when a bit actually flips.
+    void setError(uint32_t index, bool error);
+    void setMoving(uint32_t index, bool moving);
+    void clear(uint32_t index);
+
+    bool anyError() const
+    {
+        return errorCount_.load(std::memory_order_acquire) != 0;
+    }
+    bool anyMoving() const
+    {
+        return movingCount_.load(std::memory_order_acquire) != 0;
+    }
+    size_t getErrorCount() const
+    {
+        return errorCount_.load(std::memory_order_acquire);
+    }
+    size_t getMovingCount() const
+    {
+        return movingCount_.load(std::memory_order_acquire);
+    }
+
+    // Calls visit(index) for every device currently in error, in index order.
+    template <typename Visit> void forEachError(Visit &&visit) const
+    {
+        size_t words = (extent_.load(std::memory_order_acquire) + 63) / 64;
+        for (size_t w = 0; w < words; ++w)
+        {
+            for (uint64_t bits = errors_[w].load(std::memory_order_acquire); bits; bits &= bits - 1)
+                visit(static_cast<uint32_t>(w * 64 + static_cast<size_t>(std::countr_zero(bits))));
+        }
+    }
+
+  private:
+    void extendTo(uint32_t index);
+
+    const size_t capacity_;
+    ChangeSignal *const errorSignal_;
+    std::unique_ptr<std::atomic<uint64_t>[]> errors_;
+    std::unique_ptr<std::atomic<uint64_t>[]> moving_;
+    std::atomic<size_t> errorCount_{0};
+    std::atomic<size_t> movingCount_{0};
+    std::atomic<uint32_t> extent_{0}; // one past the highest index ever set; bounds forEachError
+};
+
+// Mixin for devices that push their error and moving flags to status boards when they flip, instead of
+// being polled. A device may sit on several boards at once, e.g. a DeviceManager's and a GloveState's; each
+// board must unsubscribe before it is destroyed. The same flips wake threads blocked in the wait functions
+// and call any status listeners, so nobody has to spin on isMoving()/isError().
+class StatusPublisher
+{
+  public:
+    // Called with the device's flags after either flips. Listeners run on whichever thread published,
+    // possibly with the device's own locks held, so they must be quick and must not call back into it.
+    using StatusListener = std::function<void(bool error, bool moving)>;
+
+    void subscribe(DeviceStatusBoard &board, uint32_t index);
+    void unsubscribe(DeviceStatusBoard &board, uint32_t index);
+    // Returns an id for removeStatusListener().
+    uint64_t addStatusListener(StatusListener listener);
+    void removeStatusListener(uint64_t id);
+
+    // Cheap when the flag is unchanged: one atomic exchange.
+    void publishError(bool error);
+    void publishMoving(bool moving);
+
+    // The error flag as last published; unlike a device's own isError(), it is the same for every device type.
+    bool getPublishedError() const
+    {
+        return publishedError_.load(std::memory_order_acquire);
+    }
+
+    // Block until the published flag says so, or the timeout passes; false on timeout.
+    bool waitUntilStopped(std::chrono::nanoseconds timeout) const;
+    bool waitForError(std::chrono::nanoseconds timeout) const;
+
+  protected:
+    StatusPublisher() = default;
+    ~StatusPublisher() = default;
+    StatusPublisher(const StatusPublisher &) = delete;
+    StatusPublisher &operator=(const StatusPublisher &) = delete;
+
+  private:
+    // Republishes both flags to boards and listeners; the caller holds mutex_.
+    void notifyLocked();
+    template <typename Done> bool waitFor(Done &&done, std::chrono::nanoseconds timeout) const;
+
+    // Guards boards_ and listeners_; republishing under it keeps racing flips from leaving a stale bit
+    std::mutex mutex_;
+    std::vector<std::pair<DeviceStatusBoard *, uint32_t>> boards_;
+    std::vector<std::pair<uint64_t, StatusListener>> listeners_;
+    uint64_t nextListenerId_ = 1;
+    std::atomic<bool> publishedError_{false};
+    std::atomic<bool> publishedMoving_{false};
+    ChangeSignal changed_;
+};
+
+} // namespace FingerFlexAid
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace FingerFlexAid
+{
+
+// Emergency-stop epoch for one set of devices; each DeviceManagerImpl owns one, so a stop on one manager
+// leaves devices and loops that belong to another alone. trigger() bumps it; everything with a tick of its
+// own that watches it (SimulationEngine, ControlLoop) remembers the epoch it last saw and compares it with
+// one atomic load, so noticing a stop never waits on a lock. The epoch only grows, so a late poll still sees
+// the stop. Devices without a tick (serial devices, and any without a batch domain) do not poll it;
+// DeviceManager::emergencyStopAll() commands them.
+class EmergencyStop
+{
+  public:
+    EmergencyStop() = default;
+    EmergencyStop(const EmergencyStop &) = delete;
+    EmergencyStop &operator=(const EmergencyStop &) = delete;
+
+    uint64_t trigger()
+    {
+        return epoch_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    }
+
+    uint64_t epoch() const
+    {
+        return epoch_.load(std::memory_order_acquire);
+    }
+
+    // The epoch as seen by one polling thread; poll() is true once for each trigger since the last poll.
+    // The EmergencyStop must outlive it.
+    class Observer
+    {
+      public:
+        explicit Observer(const EmergencyStop &stop) : stop_(&stop), seen_(stop.epoch())
+        {
+        }
+
+        bool poll()
+        {
+            uint64_t current = stop_->epoch();
+            if (current == seen_)
+                return false;
+            seen_ = current;
+            return true;
+        }
+
+      private:
+        const EmergencyStop *stop_;
+        uint64_t seen_;
+    };
+
+  private:
+    std::atomic<uint64_t> epoch_{0};
+};
+
+} // namespace FingerFlexAid
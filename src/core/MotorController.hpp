@@ -1,6 +1,10 @@
 #pragma once
 
+#include "DeviceCommand.hpp"
+#include "DeviceError.hpp"
+#include "DeviceStatus.hpp"
 #include <cstdint>
+#include <cstdlib>
 #include <optional>
 #include <string>
 
@@ -10,6 +14,9 @@ namespace FingerFlexAid
 class MotorController
 {
   public:
+    // Largest move a single SetPosition command may ask for, in steps.
+    static constexpr int32_t kMaxPositionChange = 1000000;
+
     virtual ~MotorController() = default;
 
     virtual bool setSpeed(int16_t speed) = 0;       // Speed in RPM, negative for reverse
@@ -22,12 +29,77 @@ class MotorController
     virtual bool isMoving() const = 0;
     virtual bool isError() const = 0;
     virtual std::optional<std::string> getLastError() const = 0;
+    // The same error as a compact record, without allocating; getLastError() is its rendered message.
+    // Controllers that keep no record report ErrorCode::Unknown while in error.
+    virtual ErrorRecord getLastErrorRecord() const
+    {
+        return isError() ? ErrorRecord{ErrorCode::Unknown} : ErrorRecord{};
+    }
 
     virtual bool setMaxSpeed(int16_t maxSpeed) = 0;
     virtual bool setAcceleration(uint16_t acceleration) = 0;
     virtual int16_t getMaxSpeed() const = 0;
     virtual uint16_t getAcceleration() const = 0;
 
+    // Batched commands (see DeviceManager::applyBatch). The manager holds the controller's batch domain,
+    // if any, for the whole batch and checks every command before applying any, so checkCommand must not
+    // change state and neither call may re-enter the domain. Without a domain the setters are used.
+    // Controllers that push flag changes (see StatusPublisher) let the manager answer health queries without
+    // polling them; the rest are polled.
+    virtual StatusPublisher *getStatusPublisher()
+    {
+        return nullptr;
+    }
+    virtual BatchDomain *getBatchDomain()
+    {
+        return nullptr;
+    }
+    virtual bool checkCommand(const MotorCommand &command) const
+    {
+        if (command.type == MotorCommand::Type::EmergencyStop)
+            return true;
+        if (isError())
+            return false;
+        switch (command.type)
+        {
+        case MotorCommand::Type::SetSpeed:
+            return std::abs(command.value) <= getMaxSpeed();
+        case MotorCommand::Type::SetPosition:
+            return std::abs(int64_t{command.value} - getCurrentPosition()) <= kMaxPositionChange;
+        case MotorCommand::Type::Stop:
+        case MotorCommand::Type::EmergencyStop:
+            return true;
+        }
+        return false;
+    }
+    virtual bool applyCommand(const MotorCommand &command)
+    {
+        switch (command.type)
+        {
+        case MotorCommand::Type::SetSpeed:
+            return setSpeed(static_cast<int16_t>(command.value));
+        case MotorCommand::Type::SetPosition:
+            return setPosition(command.value);
+        case MotorCommand::Type::Stop:
+            return stop();
+        case MotorCommand::Type::EmergencyStop:
+            return emergencyStop();
+        }
+        return false;
+    }
+
+    // Asks any worker thread behind the controller to wind down without waiting for it, so a whole fleet
+    // can be stopped in one pass (see DeviceManager::shutdownAll); destroying the controller still joins it.
+    virtual void requestShutdown()
+    {
+    }
+
+    // Restarts any worker thread that requestShutdown() stopped (see DeviceManager::initializeAll); does
+    // nothing while it runs.
+    virtual void resume()
+    {
+    }
+
   protected:
     MotorController() = default;
     MotorController(const MotorController &) = default;
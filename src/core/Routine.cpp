@@ -0,0 +1,203 @@
+#include "Routine.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace FingerFlexAid
+{
+
+namespace
+{
+
+constexpr double kServoDegreesPerSecondPerUnit = 5.0; // speed * 0.1 degrees per 20 ms servo update
+
+} // namespace
+
+MotionLimits motionLimits(const MotorController &motor, double stepsPerRevolution, double jerkRatio)
+{
+    MotionLimits limits;
+    limits.maxVelocity = std::abs(motor.getMaxSpeed()) * stepsPerRevolution / 60.0;
+    limits.maxAcceleration = motor.getAcceleration() * stepsPerRevolution / 60.0;
+    limits.maxJerk = limits.maxAcceleration * jerkRatio;
+    return limits;
+}
+
+MotionLimits motionLimits(const ServoController &servo, double acceleration, double jerk)
+{
+    auto [minAngle, maxAngle] = servo.getAngleLimits();
+    MotionLimits limits;
+    limits.maxVelocity = servo.getMaxSpeed() * kServoDegreesPerSecondPerUnit;
+    limits.maxAcceleration = acceleration;
+    limits.maxJerk = jerk;
+    limits.minPosition = minAngle;
+    limits.maxPosition = maxAngle;
+    return limits;
+}
+
+std::shared_ptr<const CompiledRoutine> CompiledRoutine::compile(const ExerciseRoutine &routine,
+                                                                const std::vector<MotionLimits> &limits)
+{
+    if (limits.size() != routine.tracks.size())
+        return nullptr;
+    std::shared_ptr<CompiledRoutine> compiled(new CompiledRoutine());
+    compiled->name_ = routine.name;
+    compiled->tracks_.reserve(routine.tracks.size());
+    for (size_t i = 0; i < routine.tracks.size(); ++i)
+    {
+        const RoutineTrack &track = routine.tracks[i];
+        Trajectory trajectory(track.start, limits[i]);
+        for (const RoutineMove &move : track.moves)
+        {
+            if (!trajectory.moveTo(move.target, routine.shape))
+                return nullptr;
+            trajectory.hold(move.hold);
+        }
+        compiled->duration_ = std::max(compiled->duration_, trajectory.getDuration());
+        compiled->tracks_.push_back({track.device, track.kind, std::move(trajectory)});
+    }
+    return compiled;
+}
+
+const std::string &CompiledRoutine::getName() const
+{
+    return name_;
+}
+
+const std::vector<CompiledRoutine::Track> &CompiledRoutine::getTracks() const
+{
+    return tracks_;
+}
+
+std::chrono::nanoseconds CompiledRoutine::getDuration() const
+{
+    return duration_;
+}
+
+RoutineCache &RoutineCache::shared()
+{
+    static RoutineCache instance;
+    return instance;
+}
+
+std::shared_ptr<const CompiledRoutine> RoutineCache::get(const ExerciseRoutine &routine, const DeviceManager &devices)
+{
+    std::vector<MotionLimits> limits;
+    limits.reserve(routine.tracks.size());
+    for (const RoutineTrack &track : routine.tracks)
+    {
+        if (track.kind == ActuatorKind::Motor)
+        {
+            auto motor = devices.getMotor(track.device);
+            if (!motor)
+                return nullptr;
+            limits.push_back(motionLimits(*motor));
+        }
+        else
+        {
+            auto servo = devices.getServo(track.device);
+            if (!servo)
+                return nullptr;
+            limits.push_back(motionLimits(*servo));
+        }
+    }
+    return get(routine, limits);
+}
+
+std::shared_ptr<const CompiledRoutine> RoutineCache::get(const ExerciseRoutine &routine,
+                                                         const std::vector<MotionLimits> &limits)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = entries_.find(routine.name);
+    if (it != entries_.end() && it->second.routine == routine && it->second.limits == limits)
+        return it->second.compiled;
+
+    // Compiling under the lock keeps concurrent sessions starting the same routine from compiling it twice
+    auto compiled = CompiledRoutine::compile(routine, limits);
+    if (!compiled)
+        return nullptr;
+    ++compiles_;
+    entries_.insert_or_assign(routine.name, Entry{routine, limits, compiled});
+    return compiled;
+}
+
+size_t RoutineCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return entries_.size();
+}
+
+uint64_t RoutineCache::getCompileCount() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return compiles_;
+}
+
+void RoutineCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    entries_.clear();
+}
+
+RoutinePlayer::RoutinePlayer(std::shared_ptr<const CompiledRoutine> routine, DeviceManager &devices)
+    : routine_(std::move(routine)), devices_(devices), emergencyStop_(devices.getEmergencyStop())
+{
+    bindings_.reserve(routine_->getTracks().size());
+    for (const auto &track : routine_->getTracks())
+    {
+        Binding binding{&track.trajectory, {}, {}};
+        if (track.kind == ActuatorKind::Motor)
+            binding.motor = devices_.findMotor(track.device);
+        else
+            binding.servo = devices_.findServo(track.device);
+        if (!binding.motor && !binding.servo)
+        {
+            ready_ = false;
+            continue;
+        }
+        bindings_.push_back(binding);
+    }
+    batch_.motors.reserve(bindings_.size());
+    batch_.servos.reserve(bindings_.size());
+}
+
+bool RoutinePlayer::isReady() const
+{
+    return ready_;
+}
+
+bool RoutinePlayer::tick(std::chrono::nanoseconds elapsed)
+{
+    if (emergencyStop_.poll())
+        for (Binding &binding : bindings_)
+            binding.hasSent = false;
+    batch_.clear();
+    for (Binding &binding : bindings_)
+    {
+        const auto setpoint = static_cast<int32_t>(std::lround(binding.trajectory->sample(elapsed, binding.cursor)));
+        if (binding.hasSent && setpoint == binding.sent)
+            continue;
+        if (binding.motor)
+            batch_.add(binding.motor, MotorCommand::position(setpoint));
+        else
+            batch_.add(binding.servo, ServoCommand::angle(static_cast<uint16_t>(setpoint)));
+        binding.sent = setpoint;
+        binding.hasSent = true;
+    }
+    if (batch_.empty() || devices_.applyBatch(batch_))
+        return true;
+    // Nothing was applied; send every setpoint again next tick
+    for (Binding &binding : bindings_)
+        binding.hasSent = false;
+    return false;
+}
+
+bool RoutinePlayer::isFinished(std::chrono::nanoseconds elapsed) const
+{
+    return elapsed >= routine_->getDuration();
+}
+
+const CompiledRoutine &RoutinePlayer::getRoutine() const
+{
+    return *routine_;
+}
+
+} // namespace FingerFlexAid
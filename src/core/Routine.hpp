@@ -0,0 +1,155 @@
+#pragma once
+
+#include "DeviceManager.hpp"
+#include "Trajectory.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace FingerFlexAid
+{
+
+enum class ActuatorKind : uint8_t
+{
+    Motor, // positions in steps
+    Servo  // positions are angles in degrees
+};
+
+// Move to `target` under the routine's profile shape, then stay there for `hold`.
+struct RoutineMove
+{
+    double target = 0;
+    std::chrono::milliseconds hold{0};
+
+    bool operator==(const RoutineMove &) const = default;
+};
+
+// The moves of one actuator, starting at rest at `start`.
+struct RoutineTrack
+{
+    std::string device;
+    ActuatorKind kind = ActuatorKind::Servo;
+    double start = 0;
+    std::vector<RoutineMove> moves;
+
+    bool operator==(const RoutineTrack &) const = default;
+};
+
+// An exercise as the therapist describes it: waypoints per actuator, all tracks starting together.
+struct ExerciseRoutine
+{
+    std::string name;
+    ProfileShape shape = ProfileShape::SCurve;
+    std::vector<RoutineTrack> tracks;
+
+    bool operator==(const ExerciseRoutine &) const = default;
+};
+
+// Converts controller settings to motion limits. Motor speeds are RPM and accelerations RPM per second;
+// servo speeds are the 0-100 scale, which the servos move at 5 degrees per second per unit. Neither
+// controller reports a jerk or servo acceleration limit, so those are parameters.
+MotionLimits motionLimits(const MotorController &motor, double stepsPerRevolution = 200, double jerkRatio = 10);
+MotionLimits motionLimits(const ServoController &servo, double acceleration = 500, double jerk = 5000);
+
+// A routine compiled to one Trajectory per track. Immutable, so one copy is shared by every session that
+// plays it.
+class CompiledRoutine
+{
+  public:
+    struct Track
+    {
+        std::string device;
+        ActuatorKind kind;
+        Trajectory trajectory;
+    };
+
+    // `limits` holds one entry per track. Returns nullptr if a track's limits allow no motion.
+    static std::shared_ptr<const CompiledRoutine> compile(const ExerciseRoutine &routine,
+                                                          const std::vector<MotionLimits> &limits);
+
+    const std::string &getName() const;
+    const std::vector<Track> &getTracks() const;
+    // Until the last track comes to rest at its last target and finishes holding it.
+    std::chrono::nanoseconds getDuration() const;
+
+  private:
+    CompiledRoutine() = default;
+
+    std::string name_;
+    std::vector<Track> tracks_;
+    std::chrono::nanoseconds duration_{0};
+};
+
+// Compiled routines by name, so starting an exercise that has run before costs a lookup. An entry is reused
+// while the routine and its devices' limits are unchanged and recompiled otherwise. Thread-safe.
+class RoutineCache
+{
+  public:
+    // The cache shared by every session in the process.
+    static RoutineCache &shared();
+
+    // Null if a device of the routine is not registered or its limits allow no motion.
+    std::shared_ptr<const CompiledRoutine> get(const ExerciseRoutine &routine, const DeviceManager &devices);
+    std::shared_ptr<const CompiledRoutine> get(const ExerciseRoutine &routine,
+                                               const std::vector<MotionLimits> &limits);
+
+    size_t size() const;
+    // Routines compiled so far, counting recompilations; a cache hit adds nothing.
+    uint64_t getCompileCount() const;
+    void clear();
+
+  private:
+    struct Entry
+    {
+        ExerciseRoutine routine;
+        std::vector<MotionLimits> limits;
+        std::shared_ptr<const CompiledRoutine> compiled;
+    };
+
+    mutable std::mutex mtx_;
+    std::unordered_map<std::string, Entry> entries_;
+    uint64_t compiles_ = 0;
+};
+
+// Plays a compiled routine into a DeviceManager from a control loop: each tick samples every track and
+// sends the setpoints that changed since the last tick as one batch. After the manager's emergency-stop
+// epoch moves, the next tick sends every setpoint again, since the stop moved the devices off them. Device
+// ids are resolved to handles once, up front, and the batch is reused, so a tick allocates nothing (nor
+// does applyBatch(), once the thread has sent a batch that large).
+class RoutinePlayer
+{
+  public:
+    // `devices` must outlive the player.
+    RoutinePlayer(std::shared_ptr<const CompiledRoutine> routine, DeviceManager &devices);
+
+    // False if a track's device is not registered; tick() then skips that track.
+    bool isReady() const;
+    // Sends the setpoints for `elapsed` time since the exercise started; false if the batch was rejected.
+    bool tick(std::chrono::nanoseconds elapsed);
+    bool isFinished(std::chrono::nanoseconds elapsed) const;
+    const CompiledRoutine &getRoutine() const;
+
+  private:
+    struct Binding
+    {
+        const Trajectory *trajectory;
+        MotorHandle motor;
+        ServoHandle servo;
+        size_t cursor = 0;
+        int32_t sent = 0;
+        bool hasSent = false;
+    };
+
+    const std::shared_ptr<const CompiledRoutine> routine_;
+    DeviceManager &devices_;
+    std::vector<Binding> bindings_;
+    CommandBatch batch_;
+    EmergencyStop::Observer emergencyStop_;
+    bool ready_ = true;
+};
+
+} // namespace FingerFlexAid
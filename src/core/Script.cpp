@@ -0,0 +1,158 @@
+#include "Script.hpp"
+#include <algorithm>
+#include <functional>
+
+namespace FingerFlexAid
+{
+
+std::coroutine_handle<> ScriptTask::FinalAwaiter::await_suspend(Handle handle) noexcept
+{
+    promise_type &promise = handle.promise();
+    if (promise.continuation)
+        return promise.continuation;
+    // A spawned script; the scheduler destroys it once control is back in tick()
+    promise.scheduler->finish(handle);
+    return std::noop_coroutine();
+}
+
+void ConditionWait::suspend(ScriptTask::Handle handle, std::chrono::nanoseconds timeout)
+{
+    ScriptScheduler &scheduler = *handle.promise().scheduler;
+    handle_ = handle;
+    timedOut_ = false;
+    deadline_ = timeout == kNoTimeout ? kNoTimeout : scheduler.now() + timeout;
+    scheduler.wait(*this);
+}
+
+ScriptScheduler::ScriptScheduler() : start_(std::chrono::steady_clock::now())
+{
+}
+
+ScriptScheduler::~ScriptScheduler()
+{
+    cancelAll();
+}
+
+void ScriptScheduler::spawn(ScriptTask script)
+{
+    ScriptTask::Handle handle = std::exchange(script.handle_, {});
+    if (!handle)
+        return;
+    handle.promise().scheduler = this;
+    handle.promise().root = roots_.size();
+    roots_.push_back(handle);
+    ready_.push_back(handle);
+}
+
+void ScriptScheduler::tick(std::chrono::nanoseconds now)
+{
+    now_ = now;
+    // Scripts made ready during this tick (spawned, or yielding with nextTick) wait for the next one
+    running_.swap(ready_);
+
+    while (!timers_.empty() && timers_.front().deadline <= now_.count())
+    {
+        std::pop_heap(timers_.begin(), timers_.end(), std::greater<>());
+        running_.push_back(timers_.back().handle);
+        timers_.pop_back();
+    }
+
+    for (size_t i = 0; i < conditions_.size();)
+    {
+        ConditionWait *condition = conditions_[i];
+        const bool ready = condition->ready();
+        if (!ready && condition->deadline_ > now_)
+        {
+            ++i;
+            continue;
+        }
+        condition->timedOut_ = !ready;
+        running_.push_back(condition->handle_);
+        conditions_[i] = conditions_.back();
+        conditions_.pop_back();
+    }
+
+    for (std::coroutine_handle<> handle : running_)
+    {
+        handle.resume();
+        reap();
+    }
+    running_.clear();
+}
+
+void ScriptScheduler::tick()
+{
+    tick(std::chrono::steady_clock::now() - start_);
+}
+
+void ScriptScheduler::cancelAll()
+{
+    // Forget the suspension points first: destroying the frames destroys the awaiters they point into
+    ready_.clear();
+    running_.clear();
+    timers_.clear();
+    conditions_.clear();
+    finished_.clear();
+    for (ScriptTask::Handle root : roots_)
+        root.destroy();
+    roots_.clear();
+}
+
+std::chrono::nanoseconds ScriptScheduler::now() const
+{
+    return now_;
+}
+
+size_t ScriptScheduler::getActiveCount() const
+{
+    return roots_.size();
+}
+
+uint64_t ScriptScheduler::getCompletedCount() const
+{
+    return completed_;
+}
+
+uint64_t ScriptScheduler::getFailedCount() const
+{
+    return failed_;
+}
+
+void ScriptScheduler::sleepUntil(std::coroutine_handle<> handle, std::chrono::nanoseconds deadline)
+{
+    timers_.push_back({deadline.count(), timerSequence_++, handle});
+    std::push_heap(timers_.begin(), timers_.end(), std::greater<>());
+}
+
+void ScriptScheduler::wait(ConditionWait &condition)
+{
+    conditions_.push_back(&condition);
+}
+
+void ScriptScheduler::schedule(std::coroutine_handle<> handle)
+{
+    ready_.push_back(handle);
+}
+
+void ScriptScheduler::finish(ScriptTask::Handle root)
+{
+    finished_.push_back(root);
+}
+
+void ScriptScheduler::reap()
+{
+    for (ScriptTask::Handle root : finished_)
+    {
+        // Swap-remove from the running scripts, keeping the moved script's index current
+        const size_t index = root.promise().root;
+        roots_[index] = roots_.back();
+        roots_[index].promise().root = index;
+        roots_.pop_back();
+
+        ++(root.promise().exception ? failed_ : completed_);
+        root.destroy();
+    }
+    finished_.clear();
+}
+
+} // namespace FingerFlexAid
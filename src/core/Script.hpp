@@ -0,0 +1,352 @@
+#pragma once
+
+#include "ServoController.hpp"
+#include "utils/FramePool.hpp"
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <utility>
+#include <vector>
+
+namespace FingerFlexAid
+{
+
+class ScriptScheduler;
+
+// An exercise script: a coroutine that suspends on time (sleepFor) or on device conditions (waitUntil,
+// moveServo) instead of blocking a thread. Scripts are started with ScriptScheduler::spawn() and may
+// co_await other scripts, which then run inline as part of their caller. Frames come from FramePool.
+//
+//     ScriptTask flexIndex(std::shared_ptr<ServoController> index)
+//     {
+//         for (int rep = 0; rep < 10; ++rep)
+//         {
+//             co_await moveServo(*index, 120);
+//             co_await sleepFor(2s);
+//             co_await moveServo(*index, 30);
+//         }
+//     }
+//
+// Pass devices by value (e.g. shared_ptr): references in a coroutine's parameters must outlive the script.
+class ScriptTask
+{
+  public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+        std::coroutine_handle<> await_suspend(Handle handle) noexcept;
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    struct promise_type
+    {
+        ScriptScheduler *scheduler = nullptr;
+        std::coroutine_handle<> continuation; // the awaiting script; none for a spawned one
+        std::exception_ptr exception;
+        size_t root = 0; // index among the scheduler's running scripts, if spawned
+
+        ScriptTask get_return_object()
+        {
+            return ScriptTask(Handle::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() const noexcept
+        {
+            return {};
+        }
+        FinalAwaiter final_suspend() const noexcept
+        {
+            return {};
+        }
+        void return_void() const noexcept
+        {
+        }
+        void unhandled_exception()
+        {
+            exception = std::current_exception();
+        }
+
+        static void *operator new(size_t size)
+        {
+            return FramePool::shared().allocate(size);
+        }
+        static void operator delete(void *frame, size_t size)
+        {
+            FramePool::shared().deallocate(frame, size);
+        }
+    };
+
+    ScriptTask(ScriptTask &&other) noexcept : handle_(std::exchange(other.handle_, {}))
+    {
+    }
+    ScriptTask &operator=(ScriptTask &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle_)
+                handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    ~ScriptTask()
+    {
+        if (handle_)
+            handle_.destroy();
+    }
+
+    // Awaiting a script runs it to completion within the caller; an exception it throws is rethrown here.
+    bool await_ready() const noexcept
+    {
+        return !handle_ || handle_.done();
+    }
+    std::coroutine_handle<> await_suspend(Handle caller) noexcept
+    {
+        handle_.promise().scheduler = caller.promise().scheduler;
+        handle_.promise().continuation = caller;
+        return handle_;
+    }
+    void await_resume() const
+    {
+        if (handle_ && handle_.promise().exception)
+            std::rethrow_exception(handle_.promise().exception);
+    }
+
+  private:
+    friend class ScriptScheduler;
+
+    explicit ScriptTask(Handle handle) : handle_(handle)
+    {
+    }
+
+    Handle handle_;
+};
+
+// Base of awaiters that suspend until a condition holds, polled once per scheduler tick.
+class ConditionWait
+{
+  public:
+    virtual bool ready() = 0;
+
+  protected:
+    ConditionWait() = default;
+    ~ConditionWait() = default;
+    ConditionWait(const ConditionWait &) = default;
+    ConditionWait &operator=(const ConditionWait &) = default;
+
+    void suspend(ScriptTask::Handle handle, std::chrono::nanoseconds timeout);
+    bool timedOut() const
+    {
+        return timedOut_;
+    }
+
+  private:
+    friend class ScriptScheduler;
+
+    std::coroutine_handle<> handle_;
+    std::chrono::nanoseconds deadline_{0};
+    bool timedOut_ = false;
+};
+
+constexpr std::chrono::nanoseconds kNoTimeout = std::chrono::nanoseconds::max();
+
+// Runs scripts from a control loop: tick() resumes every script whose sleep has expired or whose condition
+// now holds, on the calling thread, so scripts never block and need no threads of their own. Timers are a
+// heap and conditions a flat list, so thousands of scripts across many gloves share one scheduler.
+// Not synchronised: spawn(), tick() and cancelAll() belong to the control loop's thread.
+class ScriptScheduler
+{
+  public:
+    ScriptScheduler();
+    // Destroys any script still running, as cancelAll().
+    ~ScriptScheduler();
+
+    ScriptScheduler(const ScriptScheduler &) = delete;
+    ScriptScheduler &operator=(const ScriptScheduler &) = delete;
+
+    // The script starts on the next tick.
+    void spawn(ScriptTask script);
+    // Resumes everything due at `now`, a time on the caller's clock (such as SimulationEngine::now()) that
+    // must not go backwards. The overload without arguments uses the steady clock since construction.
+    void tick(std::chrono::nanoseconds now);
+    void tick();
+    // Destroys every running script at its suspension point; their locals are destroyed as usual. Not from
+    // within a script.
+    void cancelAll();
+
+    std::chrono::nanoseconds now() const;
+    size_t getActiveCount() const;
+    uint64_t getCompletedCount() const;
+    // Scripts that ended with an exception.
+    uint64_t getFailedCount() const;
+
+  private:
+    friend struct ScriptTask::FinalAwaiter;
+    friend class ConditionWait;
+    friend struct SleepAwaiter;
+    friend struct NextTickAwaiter;
+
+    struct Timer
+    {
+        int64_t deadline;
+        uint64_t sequence; // keeps scripts sleeping until the same time in the order they slept
+        std::coroutine_handle<> handle;
+
+        bool operator>(const Timer &other) const
+        {
+            return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+        }
+    };
+
+    void sleepUntil(std::coroutine_handle<> handle, std::chrono::nanoseconds deadline);
+    void wait(ConditionWait &condition);
+    void schedule(std::coroutine_handle<> handle);
+    void finish(ScriptTask::Handle root);
+    void reap();
+
+    const std::chrono::steady_clock::time_point start_;
+    std::chrono::nanoseconds now_{0};
+    std::vector<ScriptTask::Handle> roots_;
+    std::vector<ScriptTask::Handle> finished_;
+    std::vector<std::coroutine_handle<>> ready_;
+    std::vector<std::coroutine_handle<>> running_;
+    std::vector<Timer> timers_; // min-heap by deadline
+    std::vector<ConditionWait *> conditions_;
+    uint64_t timerSequence_ = 0;
+    uint64_t completed_ = 0;
+    uint64_t failed_ = 0;
+};
+
+struct SleepAwaiter
+{
+    std::chrono::nanoseconds duration;
+
+    bool await_ready() const noexcept
+    {
+        return duration <= std::chrono::nanoseconds::zero();
+    }
+    void await_suspend(ScriptTask::Handle handle) const
+    {
+        ScriptScheduler &scheduler = *handle.promise().scheduler;
+        scheduler.sleepUntil(handle, scheduler.now() + duration);
+    }
+    void await_resume() const noexcept
+    {
+    }
+};
+
+struct NextTickAwaiter
+{
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+    void await_suspend(ScriptTask::Handle handle) const
+    {
+        handle.promise().scheduler->schedule(handle);
+    }
+    void await_resume() const noexcept
+    {
+    }
+};
+
+template <typename Predicate> class ConditionAwaiter : public ConditionWait
+{
+  public:
+    ConditionAwaiter(Predicate predicate, std::chrono::nanoseconds timeout)
+        : predicate_(std::move(predicate)), timeout_(timeout)
+    {
+    }
+
+    bool ready() override
+    {
+        return predicate_();
+    }
+    bool await_ready()
+    {
+        return predicate_();
+    }
+    void await_suspend(ScriptTask::Handle handle)
+    {
+        suspend(handle, timeout_);
+    }
+    // False if the wait timed out before the condition held.
+    bool await_resume() const
+    {
+        return !timedOut();
+    }
+
+  private:
+    Predicate predicate_;
+    std::chrono::nanoseconds timeout_;
+};
+
+// Sets the servo's target, then waits for it to arrive: to stop moving, or to report the target angle, the
+// controller's whole-degree resolution (servos may take a while to settle the last fraction of a degree).
+// True if the servo accepted the angle and got there without an error within the timeout.
+class ServoMoveAwaiter : public ConditionWait
+{
+  public:
+    ServoMoveAwaiter(ServoController &servo, uint16_t angle, std::chrono::nanoseconds timeout)
+        : servo_(servo), angle_(angle), timeout_(timeout)
+    {
+    }
+
+    bool ready() override
+    {
+        return !servo_.isMoving() || servo_.getCurrentAngle() == angle_ || servo_.isError();
+    }
+    bool await_ready()
+    {
+        accepted_ = servo_.setAngle(angle_);
+        return !accepted_ || ready();
+    }
+    void await_suspend(ScriptTask::Handle handle)
+    {
+        suspend(handle, timeout_);
+    }
+    bool await_resume() const
+    {
+        return accepted_ && !timedOut() && !servo_.isError();
+    }
+
+  private:
+    ServoController &servo_;
+    uint16_t angle_;
+    std::chrono::nanoseconds timeout_;
+    bool accepted_ = false;
+};
+
+inline SleepAwaiter sleepFor(std::chrono::nanoseconds duration)
+{
+    return {duration};
+}
+
+// Yields until the next tick.
+inline NextTickAwaiter nextTick()
+{
+    return {};
+}
+
+// Suspends until `predicate` returns true, checked every tick; the result is false on timeout.
+template <typename Predicate>
+ConditionAwaiter<Predicate> waitUntil(Predicate predicate, std::chrono::nanoseconds timeout = kNoTimeout)
+{
+    return ConditionAwaiter<Predicate>(std::move(predicate), timeout);
+}
+
+inline ServoMoveAwaiter moveServo(ServoController &servo, uint16_t angle,
+                                  std::chrono::nanoseconds timeout = kNoTimeout)
+{
+    return ServoMoveAwaiter(servo, angle, timeout);
+}
+
+} // namespace FingerFlexAid
@@ -0,0 +1,397 @@
+#include "SerialDevices.hpp"
+#include <cstdlib>
+
+namespace FingerFlexAid
+{
+
+namespace
+{
+
+bool isAck(const Record &record)
+{
+    return record.type == RecordType::Ack && record.value == 1;
+}
+
+// Shared by both device kinds: a rejected or unanswered command leaves a message behind
+void noteFailure(SerialBus &bus, std::mutex &mtx, ErrorRecord &lastError)
+{
+    auto record = ErrorRecord::raise(bus.getLink().isConnected() ? ErrorCode::CommandRejected
+                                                                 : ErrorCode::LinkDisconnected);
+    std::lock_guard<std::mutex> lock(mtx);
+    lastError = record;
+}
+
+} // namespace
+
+SerialBus::SerialBus(std::unique_ptr<SerialLink> link, std::chrono::milliseconds timeout)
+    : link_(std::move(link)), timeout_(timeout)
+{
+    records_.reserve(kMaxPayload / 2);
+}
+
+void SerialBus::beginBatch()
+{
+    mtx_.lock();
+    if (batchDepth_++ == 0)
+        batchOwner_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+}
+
+void SerialBus::endBatch()
+{
+    if (--batchDepth_ == 0)
+    {
+        batchOwner_.store(std::thread::id(), std::memory_order_relaxed);
+        // As many queued commands per frame as fit; a DeviceManager batch is normally one frame
+        size_t first = 0;
+        while (first < queue_.size())
+        {
+            writer_.begin(FrameType::Request);
+            size_t last = first;
+            while (last < queue_.size() && writer_.add(queue_[last].type, queue_[last].device, queue_[last].value))
+                ++last;
+            flush(first, last);
+            first = last;
+        }
+        queue_.clear();
+    }
+    mtx_.unlock();
+}
+
+bool SerialBus::batchingHere() const
+{
+    return batchOwner_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+}
+
+bool SerialBus::roundTrip()
+{
+    records_.clear();
+    return link_->transact(
+        writer_,
+        [this](const FrameView &frame) {
+            RecordReader reader(frame.payload);
+            for (Record record; reader.next(record);)
+                records_.push_back(record);
+        },
+        timeout_);
+}
+
+void SerialBus::flush(size_t first, size_t last)
+{
+    const bool answered = roundTrip();
+    for (size_t i = first; i < last; ++i)
+    {
+        const size_t r = i - first;
+        const bool applied = answered && r < records_.size() && isAck(records_[r]);
+        if (queue_[i].done)
+            queue_[i].done(applied);
+    }
+}
+
+bool SerialBus::command(RecordType type, uint8_t device, int32_t value, Completion done)
+{
+    std::lock_guard<std::recursive_mutex> lock(mtx_);
+    if (batchingHere())
+    {
+        queue_.push_back(Queued{type, device, value, std::move(done)});
+        return true;
+    }
+    writer_.begin(FrameType::Request);
+    writer_.add(type, device, value);
+    const bool applied = roundTrip() && records_.size() == 1 && isAck(records_[0]);
+    if (done)
+        done(applied);
+    return applied;
+}
+
+bool SerialBus::read(std::span<const uint8_t> motors, std::span<MotorReading> motorReadings,
+                     std::span<const uint8_t> servos, std::span<ServoReading> servoReadings)
+{
+    std::lock_guard<std::recursive_mutex> lock(mtx_);
+    writer_.begin(FrameType::Request);
+    for (uint8_t device : motors)
+        if (!writer_.add(RecordType::MotorRead, device))
+            return false;
+    for (uint8_t device : servos)
+        if (!writer_.add(RecordType::ServoRead, device))
+            return false;
+    if (!roundTrip() || records_.size() != motors.size() + servos.size())
+        return false;
+
+    for (size_t i = 0; i < motors.size(); ++i)
+    {
+        if (records_[i].type != RecordType::MotorState || records_[i].device != motors[i])
+            return false;
+        motorReadings[i] = records_[i].motor;
+    }
+    for (size_t i = 0; i < servos.size(); ++i)
+    {
+        const Record &record = records_[motors.size() + i];
+        if (record.type != RecordType::ServoState || record.device != servos[i])
+            return false;
+        servoReadings[i] = record.servo;
+    }
+    return true;
+}
+
+std::optional<MotorReading> SerialBus::readMotor(uint8_t device)
+{
+    MotorReading reading;
+    if (!read(std::span<const uint8_t>(&device, 1), std::span<MotorReading>(&reading, 1), {}, {}))
+        return std::nullopt;
+    return reading;
+}
+
+std::optional<ServoReading> SerialBus::readServo(uint8_t device)
+{
+    ServoReading reading;
+    if (!read({}, {}, std::span<const uint8_t>(&device, 1), std::span<ServoReading>(&reading, 1)))
+        return std::nullopt;
+    return reading;
+}
+
+SerialMotor::SerialMotor(std::shared_ptr<SerialBus> bus, uint8_t index) : bus_(std::move(bus)), index_(index)
+{
+}
+
+bool SerialMotor::send(RecordType type, int32_t value, std::function<void()> applied)
+{
+    return bus_->command(type, index_, value, [this, applied = std::move(applied)](bool ok) {
+        if (!ok)
+            noteFailure(*bus_, errorMutex_, lastError_);
+        else if (applied)
+            applied();
+    });
+}
+
+bool SerialMotor::setSpeed(int16_t speed)
+{
+    return send(RecordType::MotorSetSpeed, speed);
+}
+
+bool SerialMotor::setPosition(int32_t position)
+{
+    return send(RecordType::MotorSetPosition, position);
+}
+
+bool SerialMotor::stop()
+{
+    return send(RecordType::MotorStop);
+}
+
+bool SerialMotor::emergencyStop()
+{
+    return send(RecordType::MotorEmergencyStop);
+}
+
+std::optional<MotorReading> SerialMotor::read() const
+{
+    auto reading = bus_->readMotor(index_);
+    if (!reading)
+        noteFailure(*bus_, errorMutex_, lastError_);
+    else
+        lastErrorFlag_.store(reading->error, std::memory_order_relaxed);
+    return reading;
+}
+
+int16_t SerialMotor::getCurrentSpeed() const
+{
+    auto reading = read();
+    return reading ? reading->speed : 0;
+}
+
+int32_t SerialMotor::getCurrentPosition() const
+{
+    auto reading = read();
+    return reading ? reading->position : 0;
+}
+
+bool SerialMotor::isMoving() const
+{
+    auto reading = read();
+    return reading && reading->moving;
+}
+
+bool SerialMotor::isError() const
+{
+    // A bridge that cannot be reached counts as a device in error
+    auto reading = read();
+    return !reading || reading->error;
+}
+
+std::optional<std::string> SerialMotor::getLastError() const
+{
+    return getLastErrorRecord().message();
+}
+
+ErrorRecord SerialMotor::getLastErrorRecord() const
+{
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return lastError_;
+}
+
+bool SerialMotor::setMaxSpeed(int16_t maxSpeed)
+{
+    return send(RecordType::MotorSetMaxSpeed, maxSpeed,
+                [this, maxSpeed] { maxSpeed_.store(maxSpeed, std::memory_order_relaxed); });
+}
+
+bool SerialMotor::setAcceleration(uint16_t acceleration)
+{
+    return send(RecordType::MotorSetAcceleration, acceleration,
+                [this, acceleration] { acceleration_.store(acceleration, std::memory_order_relaxed); });
+}
+
+int16_t SerialMotor::getMaxSpeed() const
+{
+    return maxSpeed_.load(std::memory_order_relaxed);
+}
+
+uint16_t SerialMotor::getAcceleration() const
+{
+    return acceleration_.load(std::memory_order_relaxed);
+}
+
+BatchDomain *SerialMotor::getBatchDomain()
+{
+    return bus_.get();
+}
+
+bool SerialMotor::checkCommand(const MotorCommand &command) const
+{
+    if (command.type == MotorCommand::Type::EmergencyStop)
+        return true;
+    if (lastErrorFlag_.load(std::memory_order_relaxed))
+        return false;
+    return command.type != MotorCommand::Type::SetSpeed || std::abs(command.value) <= getMaxSpeed();
+}
+
+SerialServo::SerialServo(std::shared_ptr<SerialBus> bus, uint8_t index) : bus_(std::move(bus)), index_(index)
+{
+}
+
+bool SerialServo::send(RecordType type, int32_t value, std::function<void()> applied)
+{
+    return bus_->command(type, index_, value, [this, applied = std::move(applied)](bool ok) {
+        if (!ok)
+            noteFailure(*bus_, errorMutex_, lastError_);
+        else if (applied)
+            applied();
+    });
+}
+
+bool SerialServo::setAngle(uint16_t angle)
+{
+    return send(RecordType::ServoSetAngle, angle);
+}
+
+bool SerialServo::setSpeed(uint8_t speed)
+{
+    return send(RecordType::ServoSetSpeed, speed);
+}
+
+bool SerialServo::stop()
+{
+    return send(RecordType::ServoStop);
+}
+
+bool SerialServo::emergencyStop()
+{
+    return send(RecordType::ServoEmergencyStop);
+}
+
+std::optional<ServoReading> SerialServo::read() const
+{
+    auto reading = bus_->readServo(index_);
+    if (!reading)
+        noteFailure(*bus_, errorMutex_, lastError_);
+    else
+        lastErrorFlag_.store(reading->error, std::memory_order_relaxed);
+    return reading;
+}
+
+uint16_t SerialServo::getCurrentAngle() const
+{
+    auto reading = read();
+    return reading ? reading->angle : 0;
+}
+
+uint8_t SerialServo::getCurrentSpeed() const
+{
+    auto reading = read();
+    return reading ? reading->speed : 0;
+}
+
+bool SerialServo::isMoving() const
+{
+    auto reading = read();
+    return reading && reading->moving;
+}
+
+bool SerialServo::isError() const
+{
+    auto reading = read();
+    return !reading || reading->error;
+}
+
+std::optional<std::string> SerialServo::getLastError() const
+{
+    return getLastErrorRecord().message();
+}
+
+ErrorRecord SerialServo::getLastErrorRecord() const
+{
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return lastError_;
+}
+
+bool SerialServo::setAngleLimits(uint16_t minAngle, uint16_t maxAngle)
+{
+    const int32_t packed = static_cast<int32_t>(minAngle | static_cast<uint32_t>(maxAngle) << 16);
+    return send(RecordType::ServoSetAngleLimits, packed, [this, minAngle, maxAngle] {
+        minAngle_.store(minAngle, std::memory_order_relaxed);
+        maxAngle_.store(maxAngle, std::memory_order_relaxed);
+    });
+}
+
+bool SerialServo::setMaxSpeed(uint8_t maxSpeed)
+{
+    return send(RecordType::ServoSetMaxSpeed, maxSpeed,
+                [this, maxSpeed] { maxSpeed_.store(maxSpeed, std::memory_order_relaxed); });
+}
+
+std::pair<uint16_t, uint16_t> SerialServo::getAngleLimits() const
+{
+    return {minAngle_.load(std::memory_order_relaxed), maxAngle_.load(std::memory_order_relaxed)};
+}
+
+uint8_t SerialServo::getMaxSpeed() const
+{
+    return maxSpeed_.load(std::memory_order_relaxed);
+}
+
+BatchDomain *SerialServo::getBatchDomain()
+{
+    return bus_.get();
+}
+
+bool SerialServo::checkCommand(const ServoCommand &command) const
+{
+    if (command.type == ServoCommand::Type::EmergencyStop)
+        return true;
+    if (lastErrorFlag_.load(std::memory_order_relaxed))
+        return false;
+    switch (command.type)
+    {
+    case ServoCommand::Type::SetAngle:
+        return command.value >= minAngle_.load(std::memory_order_relaxed) &&
+               command.value <= maxAngle_.load(std::memory_order_relaxed);
+    case ServoCommand::Type::SetSpeed:
+        return command.value >= 0 && command.value <= getMaxSpeed();
+    case ServoCommand::Type::Stop:
+    case ServoCommand::Type::EmergencyStop:
+        return true;
+    }
+    return false;
+}
+
+} // namespace FingerFlexAid
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "../utils/SerialLink.hpp"
+#include "DeviceCommand.hpp"
+#include "MotorController.hpp"
+#include "ServoController.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace FingerFlexAid
+{
+
+// The devices behind one ESP32 bridge, addressed by index over one SerialLink. As a batch domain it turns
+// a DeviceManager batch, or an emergencyStopAll(), into a single frame: commands applied between
+// beginBatch() and endBatch() are queued and sent together when the batch ends.
+class SerialBus : public BatchDomain
+{
+  public:
+    // Called with the bridge's verdict on a command: at once outside a batch, when the batch is answered inside
+    // one.
+    using Completion = std::function<void(bool applied)>;
+
+    explicit SerialBus(std::unique_ptr<SerialLink> link,
+                       std::chrono::milliseconds timeout = SerialLink::kDefaultTimeout);
+
+    void beginBatch() override;
+    void endBatch() override;
+
+    // One command in its own frame; true once the bridge acknowledges it as applied. Inside a batch on this
+    // thread the command is queued instead and true is returned; only `done` gets the real answer.
+    bool command(RecordType type, uint8_t device, int32_t value = 0, Completion done = nullptr);
+
+    // Reads every listed device in one frame. False, leaving the outputs unspecified, if the bridge did not
+    // answer every read.
+    bool read(std::span<const uint8_t> motors, std::span<MotorReading> motorReadings,
+              std::span<const uint8_t> servos, std::span<ServoReading> servoReadings);
+    std::optional<MotorReading> readMotor(uint8_t device);
+    std::optional<ServoReading> readServo(uint8_t device);
+
+    SerialLink &getLink()
+    {
+        return *link_;
+    }
+
+  private:
+    struct Queued
+    {
+        RecordType type;
+        uint8_t device;
+        int32_t value;
+        Completion done;
+    };
+
+    bool batchingHere() const;
+    // Sends the request built in writer_ and collects the response's records in records_.
+    bool roundTrip();
+    // Sends queue_[first, last) as one frame and reports each verdict.
+    void flush(size_t first, size_t last);
+
+    std::unique_ptr<SerialLink> link_;
+    const std::chrono::milliseconds timeout_;
+    std::recursive_mutex mtx_; // held for a whole batch; guards writer_, records_ and queue_
+    std::atomic<std::thread::id> batchOwner_{};
+    int batchDepth_ = 0;
+    std::vector<Queued> queue_;
+    FrameWriter writer_;
+    std::vector<Record> records_;
+};
+
+// MotorController for motor `index` on a bridge. Readings come from the bridge on every query; the
+// configuration (maximum speed, acceleration) has no read command, so it is tracked on the host from the
+// bridge's power-on defaults and the settings it acknowledges.
+class SerialMotor : public MotorController
+{
+  public:
+    SerialMotor(std::shared_ptr<SerialBus> bus, uint8_t index);
+
+    bool setSpeed(int16_t speed) override;
+    bool setPosition(int32_t position) override;
+    bool stop() override;
+    bool emergencyStop() override;
+
+    int16_t getCurrentSpeed() const override;
+    int32_t getCurrentPosition() const override;
+    bool isMoving() const override;
+    bool isError() const override;
+    std::optional<std::string> getLastError() const override;
+    ErrorRecord getLastErrorRecord() const override;
+
+    bool setMaxSpeed(int16_t maxSpeed) override;
+    bool setAcceleration(uint16_t acceleration) override;
+    int16_t getMaxSpeed() const override;
+    uint16_t getAcceleration() const override;
+
+    // Checked against the last reading and the tracked configuration, so a batch costs one frame.
+    BatchDomain *getBatchDomain() override;
+    bool checkCommand(const MotorCommand &command) const override;
+
+  private:
+    std::optional<MotorReading> read() const;
+    // Sends a command, noting a rejection in lastError_ and calling `applied` once it is acknowledged.
+    bool send(RecordType type, int32_t value = 0, std::function<void()> applied = nullptr);
+
+    std::shared_ptr<SerialBus> bus_;
+    const uint8_t index_;
+    std::atomic<int16_t> maxSpeed_{1000};
+    std::atomic<uint16_t> acceleration_{0};
+    mutable std::atomic<bool> lastErrorFlag_{false};
+    mutable std::mutex errorMutex_;
+    mutable ErrorRecord lastError_;
+};
+
+// ServoController for servo `index` on a bridge; configuration is tracked as for SerialMotor.
+class SerialServo : public ServoController
+{
+  public:
+    SerialServo(std::shared_ptr<SerialBus> bus, uint8_t index);
+
+    bool setAngle(uint16_t angle) override;
+    bool setSpeed(uint8_t speed) override;
+    bool stop() override;
+    bool emergencyStop() override;
+
+    uint16_t getCurrentAngle() const override;
+    uint8_t getCurrentSpeed() const override;
+    bool isMoving() const override;
+    bool isError() const override;
+    std::optional<std::string> getLastError() const override;
+    ErrorRecord getLastErrorRecord() const override;
+
+    bool setAngleLimits(uint16_t minAngle, uint16_t maxAngle) override;
+    bool setMaxSpeed(uint8_t maxSpeed) override;
+    std::pair<uint16_t, uint16_t> getAngleLimits() const override;
+    uint8_t getMaxSpeed() const override;
+
+    BatchDomain *getBatchDomain() override;
+    bool checkCommand(const ServoCommand &command) const override;
+
+  private:
+    std::optional<ServoReading> read() const;
+    bool send(RecordType type, int32_t value = 0, std::function<void()> applied = nullptr);
+
+    std::shared_ptr<SerialBus> bus_;
+    const uint8_t index_;
+    std::atomic<uint16_t> minAngle_{0};
+    std::atomic<uint16_t> maxAngle_{180};
+    std::atomic<uint8_t> maxSpeed_{100};
+    mutable std::atomic<bool> lastErrorFlag_{false};
+    mutable std::mutex errorMutex_;
+    mutable ErrorRecord lastError_;
+};
+
+} // namespace FingerFlexAid
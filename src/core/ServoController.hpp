@@ -1,8 +1,12 @@
 #pragma once
 
+#include "DeviceCommand.hpp"
+#include "DeviceError.hpp"
+#include "DeviceStatus.hpp"
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <utility>
 
 namespace FingerFlexAid
 {
@@ -22,12 +26,73 @@ class ServoController
     virtual bool isMoving() const = 0;
     virtual bool isError() const = 0;
     virtual std::optional<std::string> getLastError() const = 0;
+    // See MotorController::getLastErrorRecord.
+    virtual ErrorRecord getLastErrorRecord() const
+    {
+        return isError() ? ErrorRecord{ErrorCode::Unknown} : ErrorRecord{};
+    }
 
     virtual bool setAngleLimits(uint16_t minAngle, uint16_t maxAngle) = 0;
     virtual bool setMaxSpeed(uint8_t maxSpeed) = 0;
     virtual std::pair<uint16_t, uint16_t> getAngleLimits() const = 0;
     virtual uint8_t getMaxSpeed() const = 0;
 
+    // Batched commands; same contract as MotorController.
+    virtual StatusPublisher *getStatusPublisher()
+    {
+        return nullptr;
+    }
+    virtual BatchDomain *getBatchDomain()
+    {
+        return nullptr;
+    }
+    virtual bool checkCommand(const ServoCommand &command) const
+    {
+        if (command.type == ServoCommand::Type::EmergencyStop)
+            return true;
+        if (isError())
+            return false;
+        switch (command.type)
+        {
+        case ServoCommand::Type::SetAngle:
+        {
+            auto [min, max] = getAngleLimits();
+            return command.value >= min && command.value <= max;
+        }
+        case ServoCommand::Type::SetSpeed:
+            return command.value >= 0 && command.value <= getMaxSpeed();
+        case ServoCommand::Type::Stop:
+        case ServoCommand::Type::EmergencyStop:
+            return true;
+        }
+        return false;
+    }
+    virtual bool applyCommand(const ServoCommand &command)
+    {
+        switch (command.type)
+        {
+        case ServoCommand::Type::SetAngle:
+            return setAngle(static_cast<uint16_t>(command.value));
+        case ServoCommand::Type::SetSpeed:
+            return setSpeed(static_cast<uint8_t>(command.value));
+        case ServoCommand::Type::Stop:
+            return stop();
+        case ServoCommand::Type::EmergencyStop:
+            return emergencyStop();
+        }
+        return false;
+    }
+
+    // See MotorController::requestShutdown.
+    virtual void requestShutdown()
+    {
+    }
+
+    // See MotorController::resume.
+    virtual void resume()
+    {
+    }
+
   protected:
     ServoController() = default;
     ServoController(const ServoController &) = default;
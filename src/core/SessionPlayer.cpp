@@ -0,0 +1,135 @@
+#include "SessionPlayer.hpp"
+
+namespace FingerFlexAid
+{
+
+namespace
+{
+
+bool isCommand(const SessionRecord &record)
+{
+    return record.type == SessionRecordType::MotorCommand || record.type == SessionRecordType::ServoCommand ||
+           record.type == SessionRecordType::EmergencyStop;
+}
+
+} // namespace
+
+SessionPlayer::SessionPlayer(const SessionReader &session, DeviceManager &devices)
+    : session_(session), devices_(devices)
+{
+}
+
+void SessionPlayer::seek(std::chrono::nanoseconds time)
+{
+    cursor_ = session_.seek(time);
+    appliedEnd_ = cursor_;
+}
+
+size_t SessionPlayer::advanceTo(std::chrono::nanoseconds time)
+{
+    size_t applied = 0;
+    while (cursor_ < session_.size() && session_[cursor_].time() <= time)
+    {
+        if (cursor_ >= appliedEnd_ && isCommand(session_[cursor_]))
+        {
+            appliedEnd_ = applyFrom(cursor_);
+            applied += appliedEnd_ - cursor_;
+            cursor_ = appliedEnd_;
+        }
+        else
+            ++cursor_;
+    }
+    return applied;
+}
+
+bool SessionPlayer::step(SessionRecord &record)
+{
+    if (atEnd())
+        return false;
+    if (cursor_ >= appliedEnd_ && isCommand(session_[cursor_]))
+        appliedEnd_ = applyFrom(cursor_);
+    record = session_[cursor_++];
+    return true;
+}
+
+size_t SessionPlayer::getPosition() const
+{
+    return cursor_;
+}
+
+bool SessionPlayer::atEnd() const
+{
+    return cursor_ >= session_.size();
+}
+
+size_t SessionPlayer::getFailedCount() const
+{
+    return failed_;
+}
+
+size_t SessionPlayer::applyFrom(size_t index)
+{
+    const SessionRecord &first = session_[index];
+    if (first.type == SessionRecordType::EmergencyStop)
+    {
+        emergencyStopDevices();
+        return index + 1;
+    }
+
+    size_t end = index;
+    batch_.clear();
+    for (; end < session_.size(); ++end)
+    {
+        const SessionRecord &record = session_[end];
+        if (record.timeNs != first.timeNs ||
+            (record.type != SessionRecordType::MotorCommand && record.type != SessionRecordType::ServoCommand))
+            break;
+        add(record);
+    }
+    if (devices_.applyBatch(batch_))
+        return end;
+    if (end - index == 1)
+    {
+        ++failed_;
+        return end;
+    }
+    for (size_t i = index; i < end; ++i)
+    {
+        batch_.clear();
+        add(session_[i]);
+        if (!devices_.applyBatch(batch_))
+            ++failed_;
+    }
+    return end;
+}
+
+void SessionPlayer::add(const SessionRecord &record)
+{
+    const std::string_view id = record.getDevice();
+    if (record.type == SessionRecordType::MotorCommand)
+    {
+        auto it = motors_.find(id);
+        if (it == motors_.end())
+            it = motors_.emplace(id, devices_.findMotor(id)).first;
+        batch_.add(it->second, MotorCommand{static_cast<MotorCommand::Type>(record.commandType), record.value});
+    }
+    else
+    {
+        auto it = servos_.find(id);
+        if (it == servos_.end())
+            it = servos_.emplace(id, devices_.findServo(id)).first;
+        batch_.add(it->second, ServoCommand{static_cast<ServoCommand::Type>(record.commandType), record.value});
+    }
+}
+
+void SessionPlayer::emergencyStopDevices()
+{
+    for (const std::string &id : devices_.fillMotorIds(ids_))
+        if (auto motor = devices_.getMotor(std::string_view(id)); motor && !motor->emergencyStop())
+            ++failed_;
+    for (const std::string &id : devices_.fillServoIds(ids_))
+        if (auto servo = devices_.getServo(std::string_view(id)); servo && !servo->emergencyStop())
+            ++failed_;
+}
+
+} // namespace FingerFlexAid
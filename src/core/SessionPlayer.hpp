@@ -0,0 +1,70 @@
+#pragma once
+
+#include "DeviceManager.hpp"
+#include "utils/SessionRecording.hpp"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace FingerFlexAid
+{
+
+// Replays the commands of a recorded session into a DeviceManager whose devices are registered under the
+// recorded ids, typically MockMotor/MockServo on a manually stepped SimulationEngine. Adjacent commands with
+// one timestamp were recorded as one batch and go through one applyBatch() again; a group the manager
+// refuses as a whole is retried one command at a time, so commands that share a timestamp by chance replay
+// as before. A recorded emergency stop is replayed as an emergencyStop() on each of the manager's devices,
+// without triggering its EmergencyStop epoch, so nothing else watching that epoch stops. State records are
+// passed over, for callers to compare with what the devices now report.
+class SessionPlayer
+{
+  public:
+    // Both must outlive the player.
+    SessionPlayer(const SessionReader &session, DeviceManager &devices);
+
+    // Moves the cursor to the first record at or after `time` without applying anything.
+    void seek(std::chrono::nanoseconds time);
+    // Applies every command from the cursor up to and including `time`; returns how many were applied.
+    size_t advanceTo(std::chrono::nanoseconds time);
+    // Hands out the record at the cursor, applying it first if it is a command; false at the end. The first
+    // command of a batch applies the whole batch.
+    bool step(SessionRecord &record);
+
+    size_t getPosition() const;
+    bool atEnd() const;
+    // Commands whose device is not registered or which the device rejected.
+    size_t getFailedCount() const;
+
+  private:
+    // Lets the handle caches be searched with the record's string_view.
+    struct IdHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view id) const
+        {
+            return std::hash<std::string_view>{}(id);
+        }
+    };
+
+    // Applies the command at `index` and the rest of its batch; returns the index past the batch.
+    size_t applyFrom(size_t index);
+    void add(const SessionRecord &record);
+    void emergencyStopDevices();
+
+    const SessionReader &session_;
+    DeviceManager &devices_;
+    size_t cursor_ = 0;
+    size_t appliedEnd_ = 0; // records before this, from the cursor on, are already applied
+    size_t failed_ = 0;
+    // Name lookups are the cold path; resolve each recorded id once
+    std::unordered_map<std::string, MotorHandle, IdHash, std::equal_to<>> motors_;
+    std::unordered_map<std::string, ServoHandle, IdHash, std::equal_to<>> servos_;
+    CommandBatch batch_;           // reused for every batch
+    std::vector<std::string> ids_; // scratch for emergencyStopDevices()
+};
+
+} // namespace FingerFlexAid
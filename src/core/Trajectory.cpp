@@ -0,0 +1,186 @@
+#include "Trajectory.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace FingerFlexAid
+{
+
+namespace
+{
+
+double toSeconds(std::chrono::nanoseconds time)
+{
+    return std::chrono::duration<double>(time).count();
+}
+
+// Acceleration phase of a jerk-limited move from rest up to `peak` velocity: jerk up for `ramp` seconds,
+// hold `acceleration` for `constant` seconds, jerk down for `ramp` seconds.
+struct SCurvePhase
+{
+    double ramp = 0;
+    double constant = 0;
+    double acceleration = 0;
+
+    SCurvePhase(double peak, double maxAcceleration, double maxJerk)
+    {
+        if (peak * maxJerk >= maxAcceleration * maxAcceleration)
+        {
+            ramp = maxAcceleration / maxJerk;
+            constant = peak / maxAcceleration - ramp;
+            acceleration = maxAcceleration;
+        }
+        else
+        {
+            // Too short to reach the acceleration limit
+            ramp = std::sqrt(peak / maxJerk);
+            acceleration = maxJerk * ramp;
+        }
+    }
+
+    // Distance covered accelerating to `peak` and decelerating back to rest
+    double distance(double peak) const
+    {
+        return peak * (2 * ramp + constant);
+    }
+};
+
+} // namespace
+
+Trajectory::Trajectory(double position, MotionLimits limits)
+    : limits_(limits), endPosition_(std::clamp(position, limits.minPosition, limits.maxPosition))
+{
+}
+
+bool Trajectory::moveTo(double target, ProfileShape shape)
+{
+    target = std::clamp(target, limits_.minPosition, limits_.maxPosition);
+    const double v = limits_.maxVelocity;
+    const double a = limits_.maxAcceleration;
+    const double j = limits_.maxJerk;
+    if (!(v > 0) || !(a > 0) || (shape == ProfileShape::SCurve && !(j > 0)))
+        return false;
+    const double distance = std::abs(target - endPosition_);
+    if (distance == 0)
+        return true;
+    const double direction = target > endPosition_ ? 1.0 : -1.0;
+
+    if (shape == ProfileShape::Trapezoidal)
+    {
+        // Cruise at the velocity limit if the move is long enough to reach it, else peak where the
+        // acceleration and deceleration ramps meet
+        const double peak = distance >= v * v / a ? v : std::sqrt(distance * a);
+        const double ramp = peak / a;
+        append(ramp, 0, direction * a);
+        append((distance - peak * ramp) / peak, 0, 0);
+        append(ramp, 0, -direction * a);
+    }
+    else
+    {
+        double peak = v;
+        if (SCurvePhase(peak, a, j).distance(peak) > distance)
+        {
+            // Too short to cruise: solve for the peak whose ramps cover the distance exactly. With the
+            // acceleration limit reached, distance = peak^2 / a + peak * a / j; without, 2 * peak^1.5 / sqrt(j).
+            peak = a * (std::sqrt(a * a / (j * j) + 4 * distance / a) - a / j) / 2;
+            if (peak * j < a * a)
+                peak = std::cbrt(distance * distance * j / 4);
+            peak = std::min(peak, v);
+        }
+        const SCurvePhase phase(peak, a, j);
+        const double accel = direction * phase.acceleration;
+        const double jerk = direction * j;
+        append(phase.ramp, jerk, 0);
+        append(phase.constant, 0, accel);
+        append(phase.ramp, -jerk, accel);
+        append((distance - phase.distance(peak)) / peak, 0, 0);
+        append(phase.ramp, -jerk, 0);
+        append(phase.constant, 0, -accel);
+        append(phase.ramp, jerk, -accel);
+    }
+
+    endPosition_ = target;
+    endVelocity_ = 0;
+    return true;
+}
+
+void Trajectory::hold(std::chrono::nanoseconds duration)
+{
+    append(toSeconds(duration), 0, 0);
+}
+
+double Trajectory::sample(std::chrono::nanoseconds time) const
+{
+    size_t cursor = segments_.size(); // no hint: binary search
+    return sample(time, cursor);
+}
+
+double Trajectory::sample(std::chrono::nanoseconds time, size_t &cursor) const
+{
+    const double seconds = toSeconds(time);
+    if (segments_.empty() || seconds >= end_)
+        return endPosition_;
+    cursor = find(seconds, cursor);
+    return std::clamp(evaluate(segments_[cursor], seconds), limits_.minPosition, limits_.maxPosition);
+}
+
+double Trajectory::velocityAt(std::chrono::nanoseconds time) const
+{
+    const double seconds = toSeconds(time);
+    if (segments_.empty() || seconds >= end_)
+        return 0;
+    const Segment &segment = segments_[find(seconds, segments_.size())];
+    const double t = std::max(seconds - segment.start, 0.0);
+    return segment.velocity + segment.acceleration * t + segment.jerk * t * t / 2;
+}
+
+std::chrono::nanoseconds Trajectory::getDuration() const
+{
+    return std::chrono::nanoseconds(std::llround(end_ * 1e9));
+}
+
+double Trajectory::getEndPosition() const
+{
+    return endPosition_;
+}
+
+const MotionLimits &Trajectory::getLimits() const
+{
+    return limits_;
+}
+
+const std::vector<Trajectory::Segment> &Trajectory::getSegments() const
+{
+    return segments_;
+}
+
+void Trajectory::append(double duration, double jerk, double acceleration)
+{
+    if (!(duration > 0))
+        return;
+    segments_.push_back({end_, endPosition_, endVelocity_, acceleration, jerk});
+    endPosition_ = evaluate(segments_.back(), end_ + duration);
+    endVelocity_ += acceleration * duration + jerk * duration * duration / 2;
+    end_ += duration;
+}
+
+size_t Trajectory::find(double seconds, size_t cursor) const
+{
+    if (cursor >= segments_.size() || segments_[cursor].start > seconds)
+    {
+        // No usable hint, or time went backwards: binary search
+        auto it = std::upper_bound(segments_.begin(), segments_.end(), seconds,
+                                   [](double value, const Segment &segment) { return value < segment.start; });
+        return it == segments_.begin() ? 0 : static_cast<size_t>(it - segments_.begin()) - 1;
+    }
+    while (cursor + 1 < segments_.size() && segments_[cursor + 1].start <= seconds)
+        ++cursor;
+    return cursor;
+}
+
+double Trajectory::evaluate(const Segment &segment, double seconds) const
+{
+    const double t = std::max(seconds - segment.start, 0.0);
+    return segment.position + t * (segment.velocity + t * (segment.acceleration / 2 + t * segment.jerk / 6));
+}
+
+} // namespace FingerFlexAid
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace FingerFlexAid
+{
+
+enum class ProfileShape : uint8_t
+{
+    Trapezoidal, // bounded velocity and acceleration; acceleration steps at segment boundaries
+    SCurve       // also bounded jerk, so acceleration ramps and the motion starts and stops smoothly
+};
+
+// Bounds a profile must respect, in the actuator's own units per second: steps for motors, degrees for
+// servos. Positions outside [minPosition, maxPosition] are clamped.
+struct MotionLimits
+{
+    double maxVelocity = 0;
+    double maxAcceleration = 0;
+    double maxJerk = 0; // S-curves only
+    double minPosition = -std::numeric_limits<double>::infinity();
+    double maxPosition = std::numeric_limits<double>::infinity();
+
+    bool operator==(const MotionLimits &) const = default;
+};
+
+// Position of one actuator as a function of time: a run of constant-jerk segments joined with continuous
+// position and velocity. Segments are stored with their start state, so sampling any instant is one cubic
+// evaluation once the segment is found.
+class Trajectory
+{
+  public:
+    struct Segment
+    {
+        double start = 0; // seconds from the start of the trajectory
+        double position = 0;
+        double velocity = 0;
+        double acceleration = 0;
+        double jerk = 0;
+    };
+
+    // Starts at rest at `position`.
+    explicit Trajectory(double position = 0, MotionLimits limits = {});
+
+    // Appends a rest-to-rest move to `target` with the given shape. Returns false, appending nothing, if the
+    // limits allow no motion (zero velocity or acceleration, or zero jerk for an S-curve).
+    bool moveTo(double target, ProfileShape shape);
+    void hold(std::chrono::nanoseconds duration);
+
+    double sample(std::chrono::nanoseconds time) const;
+    // As sample(), resuming the segment search from `cursor`; monotonically increasing times, as a control
+    // loop produces, cost O(1) each. The cursor is updated for the next call.
+    double sample(std::chrono::nanoseconds time, size_t &cursor) const;
+    double velocityAt(std::chrono::nanoseconds time) const;
+
+    std::chrono::nanoseconds getDuration() const;
+    double getEndPosition() const;
+    const MotionLimits &getLimits() const;
+    const std::vector<Segment> &getSegments() const;
+
+  private:
+    void append(double duration, double jerk, double acceleration);
+    size_t find(double seconds, size_t cursor) const;
+    double evaluate(const Segment &segment, double seconds) const;
+
+    MotionLimits limits_;
+    std::vector<Segment> segments_;
+    double end_ = 0; // seconds
+    // State at end_; both are snapped to the target and rest after every move, so error never accumulates
+    double endPosition_ = 0;
+    double endVelocity_ = 0;
+};
+
+} // namespace FingerFlexAid
@@ -1,8 +1,10 @@
+#include "core/ControlLoop.hpp"
 #include "mock/MockMotor.hpp"
 #include "mock/MockServo.hpp"
 #include "models/GloveState.hpp"
 #include "models/Motor.hpp"
 #include "models/Servo.hpp"
+#include "utils/Telemetry.hpp"
 #include <atomic>
 #include <chrono>
 #include <iostream>
@@ -17,6 +19,16 @@ int main()
 
     GloveState glove;
 
+    // Every device state change is broadcast here; dashboards and recorders read it from shared memory.
+    // Declared before the devices so it outlives them. The demo replaces whatever holds the name, so a segment
+    // left behind by a crashed run does not keep it from publishing.
+    auto telemetry =
+        TelemetryRing::createShared("/fingerflexaid-telemetry", 4096, TelemetryRing::Existing::Replace);
+    if (telemetry)
+        std::cout << "Telemetry: shared memory " << telemetry->getName() << "\n";
+    else
+        std::cout << "Telemetry: shared memory unavailable\n";
+
     // Create real and mock devices
     auto realMotor = std::make_shared<Motor>("real_motor_1", 1000, 10);
     auto mockMotor = std::make_shared<MockMotor>("mock_motor_1");
@@ -28,6 +40,17 @@ int main()
     glove.addServo(realServo);
     glove.addServo(mockServo);
 
+    realMotor->attachTelemetry(telemetry.get());
+    mockMotor->attachTelemetry(telemetry.get());
+    realServo->attachTelemetry(telemetry.get());
+    mockServo->attachTelemetry(telemetry.get());
+
+    // Device state is polled at 100 Hz on the control loop; the demo below only issues commands and prints.
+    ControlLoopOptions loopOptions;
+    loopOptions.period = std::chrono::milliseconds(10);
+    ControlLoop controlLoop([&glove] { glove.update(); }, loopOptions);
+    controlLoop.start();
+
     std::atomic<bool> running{true};
     std::thread inputThread([&running]() {
         std::cin.get();
@@ -58,8 +81,6 @@ int main()
             mockServo->clearError();
         }
 
-        glove.update();
-
         // Print state
         std::cout << "Tick: " << tick << "\n";
         std::cout << "  RealMotor speed: " << realMotor->getSpeed()
@@ -73,12 +94,17 @@ int main()
                   << ", error: " << (mockServo->hasError() ? mockServo->getLastError().value_or("unknown") : "none")
                   << "\n";
         std::cout << "  GloveState error: " << (glove.hasError() ? "YES" : "no") << "\n";
+        auto loopStats = controlLoop.getStats();
+        std::cout << "  Control loop: " << loopStats.ticks << " ticks, p99 jitter "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(loopStats.jitter.percentile(0.99)).count()
+                  << "us, " << loopStats.overruns << " overruns\n";
         std::cout << "-----------------------------\n";
 
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
         ++tick;
     }
     inputThread.join();
+    controlLoop.stop();
     std::cout << "Exiting demo.\n";
     return 0;
 }
@@ -0,0 +1,366 @@
+#include "ActuatorStore.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace FingerFlexAid
+{
+
+namespace
+{
+
+constexpr int32_t kMaxSpeedStep = 25; // Balanced for realism and test speed
+constexpr Fixed kServoArrival = Fixed::fromRatio(1, 10); // closer than this to the target counts as there
+
+void publishTelemetry(const MotorStateStore &store, uint32_t slot)
+{
+    if (auto *source = store.telemetry[slot])
+        source->publishTelemetry(store.currentSpeed[slot], store.currentPosition[slot], store.moving[slot],
+                                 store.error[slot]);
+}
+
+void publishTelemetry(const ServoStateStore &store, uint32_t slot)
+{
+    if (auto *source = store.telemetry[slot])
+        source->publishTelemetry(store.currentSpeed[slot].toDouble(), store.currentAngle[slot].toDouble(),
+                                 store.moving[slot], store.error[slot]);
+}
+
+void storeReadout(MotorStateStore &store, uint32_t slot)
+{
+    store.readouts[slot].store(
+        {store.currentSpeed[slot], store.currentPosition[slot], store.moving[slot], store.error[slot]});
+}
+
+void storeReadout(ServoStateStore &store, uint32_t slot)
+{
+    store.readouts[slot].store(
+        {store.currentAngle[slot], store.currentSpeed[slot], store.moving[slot], store.error[slot]});
+}
+
+void storeLimits(MotorStateStore &store, uint32_t slot)
+{
+    store.limits[slot].store({store.maxSpeed[slot], store.acceleration[slot]});
+}
+
+void storeLimits(ServoStateStore &store, uint32_t slot)
+{
+    store.limits[slot].store({store.maxSpeed[slot], store.minAngle[slot], store.maxAngle[slot]});
+}
+
+template <typename Store> void growReadouts(Store &store, uint32_t slot)
+{
+    if (slot == store.readouts.size())
+    {
+        store.readouts.grow();
+        store.limits.grow();
+    }
+}
+
+template <typename Store> void publishMoving(Store &store, uint32_t slot, bool value)
+{
+    store.moving[slot] = value;
+    storeReadout(store, slot);
+    if (auto *publisher = store.publishers[slot])
+        publisher->publishMoving(value);
+    publishTelemetry(store, slot);
+}
+
+template <typename Store> void publishError(Store &store, uint32_t slot, bool value)
+{
+    store.error[slot] = value;
+    storeReadout(store, slot);
+    if (auto *publisher = store.publishers[slot])
+        publisher->publishError(value);
+    publishTelemetry(store, slot);
+}
+
+template <typename T> void resetSlot(std::vector<T> &field, uint32_t slot, T value)
+{
+    if (slot == field.size())
+        field.push_back(value);
+    else
+        field[slot] = value;
+}
+
+uint32_t nextSlot(std::vector<uint32_t> &freeSlots, size_t size)
+{
+    if (freeSlots.empty())
+        return static_cast<uint32_t>(size);
+    uint32_t slot = freeSlots.back();
+    freeSlots.pop_back();
+    return slot;
+}
+
+// The acceleration curve of the original per-motor worker, with integer results so that the bridge firmware
+// steps a motor to the same counts as the host. The curve's fractions are kept as exact ratios over the
+// maximum speed, truncated toward zero as the original double-to-int casts did:
+//   step     = maxStep * (0.5 + 0.5 * min(|diff|, max) / max)      = maxStep * (max + min(|diff|, max)) / 2max
+//   position = speed / 10 * (0.7 + 0.3 * |speed| / max)             = speed * (7max + 3|speed|) / 100max
+// Integer division does not vectorise, so each quotient n / d is taken as n * (1 / d) in double, with the
+// reciprocal kept per slot, plus kQuotientSlack before truncating. That is exactly the integer quotient: for
+// speeds and maxima within 16 bits the product is within 2^-26 of n / d, and a quotient that is not a whole
+// number is at least 1 / 100max >= 2^-21.6 below the next one. Inactive slots are stepped too and then
+// masked out, which keeps the loop free of branches.
+constexpr double kQuotientSlack = 0x1p-23;
+
+void stepMotors(size_t count, int32_t *__restrict speed, int32_t *__restrict position,
+                const int32_t *__restrict target, const int32_t *__restrict max, const int32_t *__restrict maxStep,
+                const double *__restrict stepScale, const double *__restrict positionScale,
+                const int32_t *__restrict isLive, const int32_t *__restrict isMoving, const int32_t *__restrict isError)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const bool active = isLive[i] & isMoving[i] & (isError[i] ^ 1);
+
+        const int32_t speedDiff = target[i] - speed[i];
+        const int32_t absDiff = std::abs(speedDiff);
+        // Non-linear acceleration curve for more realistic behavior
+        const int32_t scaleNumerator = maxStep[i] * (max[i] + std::min(absDiff, max[i]));
+        const auto scaled = static_cast<int32_t>(scaleNumerator * stepScale[i] + kQuotientSlack);
+        const int32_t stepSize = std::min(std::max(scaled, 1), std::min(absDiff, int32_t{kMaxSpeedStep}));
+        const int32_t newSpeed = speed[i] + (speedDiff > 0 ? stepSize : -stepSize);
+
+        // Position follows the new speed with non-linear scaling; the quotient is taken on the magnitude so
+        // that truncation is toward zero
+        const int32_t absSpeed = std::abs(newSpeed);
+        const double positionNumerator = static_cast<double>(absSpeed) * (7 * max[i] + 3 * absSpeed);
+        const auto positionMagnitude = static_cast<int32_t>(positionNumerator * positionScale[i] + kQuotientSlack);
+        const int32_t positionStep = newSpeed < 0 ? -positionMagnitude : positionMagnitude;
+
+        speed[i] = active ? newSpeed : speed[i];
+        position[i] += active ? positionStep : 0;
+    }
+}
+
+} // namespace
+
+uint32_t MotorStateStore::acquire(StatusPublisher *publisher, TelemetrySource *source)
+{
+    uint32_t slot = nextSlot(freeSlots_, live.size());
+    resetSlot(currentSpeed, slot, 0);
+    resetSlot(targetSpeed, slot, 0);
+    resetSlot(currentPosition, slot, 0);
+    resetSlot(targetPosition, slot, 0);
+    resetSlot(maxSpeed, slot, 0);
+    resetSlot(stepScale, slot, 0.0);
+    resetSlot(positionScale, slot, 0.0);
+    resetSlot(acceleration, slot, 0);
+    resetSlot(maxSpeedStep, slot, 0);
+    resetSlot(moving, slot, 0);
+    resetSlot(error, slot, 0);
+    resetSlot(live, slot, 1);
+    resetSlot(publishers, slot, publisher);
+    resetSlot(telemetry, slot, source);
+    growReadouts(*this, slot);
+    telemetrySources_ += source != nullptr;
+    setMaxSpeed(slot, 1000);
+    setAcceleration(slot, 1000);
+    return slot;
+}
+
+void MotorStateStore::release(uint32_t slot)
+{
+    live[slot] = 0;
+    publishers[slot] = nullptr;
+    telemetrySources_ -= telemetry[slot] != nullptr;
+    telemetry[slot] = nullptr;
+    freeSlots_.push_back(slot);
+}
+
+size_t MotorStateStore::getLiveCount() const
+{
+    return live.size() - freeSlots_.size();
+}
+
+void MotorStateStore::setMoving(uint32_t slot, bool value)
+{
+    publishMoving(*this, slot, value);
+}
+
+void MotorStateStore::setError(uint32_t slot, bool value)
+{
+    publishError(*this, slot, value);
+}
+
+void MotorStateStore::setMaxSpeed(uint32_t slot, int32_t value)
+{
+    maxSpeed[slot] = value;
+    stepScale[slot] = 1.0 / (2.0 * value);
+    positionScale[slot] = 1.0 / (100.0 * value);
+    publishReadout(slot);
+}
+
+void MotorStateStore::setAcceleration(uint32_t slot, int32_t value)
+{
+    acceleration[slot] = value;
+    // Use a smaller divisor for smoother acceleration, limited to a fixed maximum
+    maxSpeedStep[slot] = std::clamp(value / 200, 1, kMaxSpeedStep);
+    publishReadout(slot);
+}
+
+void MotorStateStore::publishReadout(uint32_t slot)
+{
+    storeReadout(*this, slot);
+    storeLimits(*this, slot);
+}
+
+void MotorStateStore::halt()
+{
+    std::fill(targetSpeed.begin(), targetSpeed.end(), 0);
+    std::fill(currentSpeed.begin(), currentSpeed.end(), 0);
+    for (uint32_t slot = 0; slot < moving.size(); ++slot)
+        if (moving[slot])
+            setMoving(slot, false);
+        else if (live[slot])
+            storeReadout(*this, slot);
+}
+
+void MotorStateStore::advance(std::chrono::nanoseconds elapsed)
+{
+    pending_ += elapsed;
+    while (pending_ >= kUpdatePeriod)
+    {
+        pending_ -= kUpdatePeriod;
+        step();
+    }
+}
+
+void MotorStateStore::step()
+{
+    stepMotors(live.size(), currentSpeed.data(), currentPosition.data(), targetSpeed.data(), maxSpeed.data(),
+               maxSpeedStep.data(), stepScale.data(), positionScale.data(), live.data(), moving.data(), error.data());
+    const bool reportTelemetry = telemetrySources_ > 0;
+    for (uint32_t slot = 0; slot < live.size(); ++slot)
+    {
+        if (!(live[slot] && moving[slot] && !error[slot]))
+            continue;
+        storeReadout(*this, slot);
+        if (reportTelemetry)
+            publishTelemetry(*this, slot);
+    }
+}
+
+uint32_t ServoStateStore::acquire(StatusPublisher *publisher, TelemetrySource *source)
+{
+    uint32_t slot = nextSlot(freeSlots_, live.size());
+    resetSlot(currentAngle, slot, Fixed::fromInt(90));
+    resetSlot(targetAngle, slot, Fixed::fromInt(90));
+    resetSlot(currentSpeed, slot, Fixed::fromInt(50));
+    resetSlot(maxSpeed, slot, Fixed::fromInt(100));
+    resetSlot(minAngle, slot, Fixed::fromInt(0));
+    resetSlot(maxAngle, slot, Fixed::fromInt(180));
+    resetSlot<int64_t>(periodNs, slot, std::chrono::nanoseconds(kUpdatePeriod).count());
+    resetSlot<int64_t>(pendingNs, slot, 0);
+    resetSlot(moving, slot, 0);
+    resetSlot(error, slot, 0);
+    resetSlot(live, slot, 1);
+    resetSlot(publishers, slot, publisher);
+    resetSlot(telemetry, slot, source);
+    growReadouts(*this, slot);
+    publishReadout(slot);
+    return slot;
+}
+
+void ServoStateStore::release(uint32_t slot)
+{
+    live[slot] = 0;
+    publishers[slot] = nullptr;
+    telemetry[slot] = nullptr;
+    freeSlots_.push_back(slot);
+}
+
+size_t ServoStateStore::getLiveCount() const
+{
+    return live.size() - freeSlots_.size();
+}
+
+void ServoStateStore::setMoving(uint32_t slot, bool value)
+{
+    publishMoving(*this, slot, value);
+}
+
+void ServoStateStore::setError(uint32_t slot, bool value)
+{
+    publishError(*this, slot, value);
+}
+
+void ServoStateStore::publishReadout(uint32_t slot)
+{
+    storeReadout(*this, slot);
+    storeLimits(*this, slot);
+}
+
+void ServoStateStore::halt()
+{
+    std::copy(currentAngle.begin(), currentAngle.end(), targetAngle.begin());
+    for (uint32_t slot = 0; slot < moving.size(); ++slot)
+        if (moving[slot])
+            setMoving(slot, false);
+}
+
+void ServoStateStore::advance(std::chrono::nanoseconds elapsed)
+{
+    const int64_t elapsedNs = elapsed.count();
+    for (auto &pending : pendingNs)
+        pending += elapsedNs;
+    while (step() > 0)
+    {
+    }
+}
+
+size_t ServoStateStore::step()
+{
+    const size_t count = live.size();
+    Fixed *__restrict angle = currentAngle.data();
+    const Fixed *__restrict target = targetAngle.data();
+    const Fixed *__restrict speed = currentSpeed.data();
+    const int64_t *__restrict period = periodNs.data();
+    int64_t *__restrict pending = pendingNs.data();
+    int32_t *__restrict isMoving = moving.data();
+    const int32_t *__restrict isLive = live.data();
+    const int32_t *__restrict isError = error.data();
+
+    size_t due = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const bool isDue = isLive[i] && pending[i] >= period[i];
+        pending[i] -= isDue ? period[i] : 0;
+        due += isDue;
+        // Skipping idle servos outright pays off now that a step costs an integer division
+        if (!isDue || !isMoving[i] || isError[i])
+            continue;
+
+        // Non-linear movement curve: slower at start/end, faster in the middle. sin(pi * (1 - d/180)) is
+        // sin(d degrees); the step never rounds down to nothing, so a servo always gets there.
+        const Fixed diff = target[i] - angle[i];
+        const Fixed absDiff = abs(diff);
+        if (absDiff > kServoArrival)
+        {
+            const Fixed stepSize =
+                max(min(absDiff, Fixed::fromRaw(speed[i].raw / 10)) * sinDegrees(absDiff), Fixed::fromRaw(1));
+            angle[i] = angle[i] + (diff.raw > 0 ? stepSize : -stepSize);
+        }
+        else
+        {
+            angle[i] = target[i];
+            isMoving[i] = 0;
+            arrived_.push_back(static_cast<uint32_t>(i));
+        }
+        stepped_.push_back(static_cast<uint32_t>(i));
+    }
+
+    for (uint32_t slot : arrived_)
+        if (auto *publisher = publishers[slot])
+            publisher->publishMoving(false);
+    arrived_.clear();
+    for (uint32_t slot : stepped_)
+    {
+        storeReadout(*this, slot);
+        publishTelemetry(*this, slot);
+    }
+    stepped_.clear();
+    return due;
+}
+
+} // namespace FingerFlexAid
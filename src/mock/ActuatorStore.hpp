@@ -0,0 +1,171 @@
+#pragma once
+
+#include "../core/DeviceStatus.hpp"
+#include "../utils/FixedPoint.hpp"
+#include "../utils/Seqlock.hpp"
+#include "../utils/Telemetry.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace FingerFlexAid
+{
+
+// Grow-only array whose elements never move, so a reader's reference survives the store growing. Elements
+// live in large fixed-size chunks, keeping a pass over consecutive slots sequential in memory.
+template <typename T> class StableArray
+{
+  public:
+    T &operator[](size_t index)
+    {
+        return chunks_[index >> kChunkBits][index & kChunkMask];
+    }
+    const T &operator[](size_t index) const
+    {
+        return chunks_[index >> kChunkBits][index & kChunkMask];
+    }
+    size_t size() const
+    {
+        return size_;
+    }
+    // Appends a default-constructed element.
+    void grow()
+    {
+        if (size_ == chunks_.size() << kChunkBits)
+            chunks_.push_back(std::make_unique<T[]>(size_t{1} << kChunkBits));
+        ++size_;
+    }
+
+  private:
+    static constexpr size_t kChunkBits = 12;
+    static constexpr size_t kChunkMask = (size_t{1} << kChunkBits) - 1;
+
+    std::vector<std::unique_ptr<T[]>> chunks_;
+    size_t size_ = 0;
+};
+
+// What a mock reads back about its motor slot, republished by the store after every change to the slot so
+// getters can read it through a Seqlock without taking the engine lock. Only the fields a step changes are in
+// the readout, which keeps the per-step publish to two words; the settings go in MotorLimits.
+struct MotorReadout
+{
+    int32_t speed = 0;
+    int32_t position = 0;
+    int32_t moving = 0;
+    int32_t error = 0;
+};
+
+struct MotorLimits
+{
+    int32_t maxSpeed = 0;
+    int32_t acceleration = 0;
+};
+
+struct ServoReadout
+{
+    Fixed angle;
+    Fixed speed;
+    int32_t moving = 0;
+    int32_t error = 0;
+};
+
+struct ServoLimits
+{
+    Fixed maxSpeed;
+    Fixed minAngle;
+    Fixed maxAngle;
+};
+
+// Structure-of-arrays state for simulated motors. Every field is a parallel array indexed by slot, so one
+// integration step is a single branch-free pass over contiguous memory for all motors at once.
+// Not synchronised; the owning SimulationEngine serialises access.
+struct MotorStateStore
+{
+    static constexpr std::chrono::milliseconds kUpdatePeriod{20};
+
+    std::vector<int32_t> currentSpeed;
+    std::vector<int32_t> targetSpeed;
+    std::vector<int32_t> currentPosition;
+    std::vector<int32_t> targetPosition;
+    std::vector<int32_t> maxSpeed;     // write through setMaxSpeed(), which keeps the scales below current
+    std::vector<double> stepScale;     // 1 / 2maxSpeed; with positionScale, keeps division out of the step kernel
+    std::vector<double> positionScale; // 1 / 100maxSpeed
+    std::vector<int32_t> acceleration;
+    std::vector<int32_t> maxSpeedStep; // derived from acceleration; keeps the clamp out of the step kernel
+    std::vector<int32_t> moving;
+    std::vector<int32_t> error;
+    std::vector<int32_t> live; // slot is in use
+    std::vector<StatusPublisher *> publishers; // told when moving/error flip; may be null
+    std::vector<TelemetrySource *> telemetry;  // sent every state change; may be null
+    // Republished after every change to the slot
+    StableArray<Seqlock<MotorReadout>> readouts;
+    StableArray<Seqlock<MotorLimits>> limits;
+
+    // Claims a slot reset to the mock motor defaults; slots are reused after release.
+    uint32_t acquire(StatusPublisher *publisher = nullptr, TelemetrySource *source = nullptr);
+    void release(uint32_t slot);
+    size_t getLiveCount() const;
+    // Flag writes outside the step kernel go through these so the slot's publisher hears about them.
+    void setMoving(uint32_t slot, bool value);
+    void setError(uint32_t slot, bool value);
+    void setMaxSpeed(uint32_t slot, int32_t value);
+    void setAcceleration(uint32_t slot, int32_t value);
+    // Republishes the slot's readout and limits; for field writes that no setter above covers.
+    void publishReadout(uint32_t slot);
+    // Brings every motor to a standstill at once.
+    void halt();
+
+    // Runs one integration step per whole update period elapsed, across every live motor.
+    void advance(std::chrono::nanoseconds elapsed);
+    void step();
+
+  private:
+    std::vector<uint32_t> freeSlots_;
+    std::chrono::nanoseconds pending_{0};
+    size_t telemetrySources_ = 0; // live slots with a telemetry source; step() skips them when zero
+};
+
+// Structure-of-arrays state for simulated servos. Each servo keeps its own update period so a simulated
+// hardware delay only slows that servo down. Angles (degrees) and speeds are Q16.16, so a step is integer
+// arithmetic that the bridge firmware reproduces exactly.
+struct ServoStateStore
+{
+    static constexpr std::chrono::milliseconds kUpdatePeriod{20};
+
+    std::vector<Fixed> currentAngle;
+    std::vector<Fixed> targetAngle;
+    std::vector<Fixed> currentSpeed;
+    std::vector<Fixed> maxSpeed;
+    std::vector<Fixed> minAngle;
+    std::vector<Fixed> maxAngle;
+    std::vector<int64_t> periodNs;
+    std::vector<int64_t> pendingNs;
+    std::vector<int32_t> moving;
+    std::vector<int32_t> error;
+    std::vector<int32_t> live;
+    std::vector<StatusPublisher *> publishers;
+    std::vector<TelemetrySource *> telemetry;
+    StableArray<Seqlock<ServoReadout>> readouts;
+    StableArray<Seqlock<ServoLimits>> limits;
+
+    uint32_t acquire(StatusPublisher *publisher = nullptr, TelemetrySource *source = nullptr);
+    void release(uint32_t slot);
+    size_t getLiveCount() const;
+    void setMoving(uint32_t slot, bool value);
+    void setError(uint32_t slot, bool value);
+    void publishReadout(uint32_t slot);
+    // Holds every servo at its current angle.
+    void halt();
+
+    void advance(std::chrono::nanoseconds elapsed);
+    // Integrates every servo whose update period has come due; returns how many did.
+    size_t step();
+
+  private:
+    std::vector<uint32_t> freeSlots_;
+    std::vector<uint32_t> arrived_; // servos that reached their target during a step, to publish after it
+    std::vector<uint32_t> stepped_; // servos that moved during a step, to republish after it
+};
+
+} // namespace FingerFlexAid
@@ -0,0 +1,217 @@
+#include "FirmwareEmulator.hpp"
+#include "../utils/ByteRing.hpp"
+#include "../utils/SerialLink.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace FingerFlexAid
+{
+
+namespace
+{
+
+constexpr size_t kReceiveRingBytes = 64 * 1024;
+
+// The eventfd that stops the serving thread; without one the destructor could never join it.
+int createWakeFd()
+{
+    return eventfd(0, EFD_CLOEXEC);
+}
+
+} // namespace
+
+std::unique_ptr<FirmwareEmulator> FirmwareEmulator::createPty(const Options &options)
+{
+    int master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (master < 0)
+        return nullptr;
+    const char *name = grantpt(master) == 0 && unlockpt(master) == 0 ? ptsname(master) : nullptr;
+    int slave = name ? ::open(name, O_RDWR | O_NOCTTY | O_CLOEXEC) : -1;
+    termios settings;
+    int wakeFd = slave >= 0 && tcgetattr(slave, &settings) == 0 ? createWakeFd() : -1;
+    if (wakeFd < 0)
+    {
+        if (slave >= 0)
+            ::close(slave);
+        ::close(master);
+        return nullptr;
+    }
+    // No echo, no line editing, no CR/LF translation: the line carries binary frames
+    cfmakeraw(&settings);
+    tcsetattr(slave, TCSANOW, &settings);
+    return std::unique_ptr<FirmwareEmulator>(new FirmwareEmulator(options, master, slave, wakeFd, name));
+}
+
+std::unique_ptr<FirmwareEmulator> FirmwareEmulator::createLoopback(const Options &options, int &hostFd)
+{
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0)
+        return nullptr;
+    int wakeFd = createWakeFd();
+    if (wakeFd < 0)
+    {
+        ::close(fds[0]);
+        ::close(fds[1]);
+        return nullptr;
+    }
+    hostFd = fds[0];
+    return std::unique_ptr<FirmwareEmulator>(new FirmwareEmulator(options, fds[1], -1, wakeFd, {}));
+}
+
+FirmwareEmulator::FirmwareEmulator(const Options &options, int fd, int keepAliveFd, int wakeFd,
+                                   std::string devicePath)
+    : fd_(fd), keepAliveFd_(keepAliveFd), wakeFd_(wakeFd), devicePath_(std::move(devicePath))
+{
+    // The bridge answers at once; only the simulated physics take time
+    for (size_t i = 0; i < options.motors; ++i)
+    {
+        motors_.push_back(std::make_unique<MockMotor>(std::string("bridge_motor_").append(std::to_string(i)), engine_));
+        motors_.back()->simulateHardwareDelay(std::chrono::milliseconds(0));
+    }
+    for (size_t i = 0; i < options.servos; ++i)
+    {
+        servos_.push_back(std::make_unique<MockServo>(std::string("bridge_servo_").append(std::to_string(i)), engine_));
+        servos_.back()->simulateHardwareDelay(std::chrono::milliseconds(0));
+    }
+    engine_.start();
+    thread_ = std::thread(&FirmwareEmulator::run, this);
+}
+
+FirmwareEmulator::~FirmwareEmulator()
+{
+    uint64_t one = 1;
+    if (::write(wakeFd_, &one, sizeof(one)) != sizeof(one))
+    {
+        // Cannot fail for a fresh eventfd; the thread wakes regardless
+    }
+    thread_.join();
+    engine_.stop();
+    // The devices release their engine slots before the engine goes
+    motors_.clear();
+    servos_.clear();
+    ::close(wakeFd_);
+    if (keepAliveFd_ >= 0)
+        ::close(keepAliveFd_);
+    ::close(fd_);
+}
+
+void FirmwareEmulator::run()
+{
+    ByteRing ring(kReceiveRingBytes);
+    pollfd fds[2] = {{fd_, POLLIN, 0}, {wakeFd_, POLLIN, 0}};
+    for (;;)
+    {
+        if (::poll(fds, 2, -1) < 0 && errno != EINTR)
+            return;
+        if (fds[1].revents)
+            return;
+        if (!fds[0].revents)
+            continue;
+
+        auto space = ring.writable();
+        const ssize_t count = ::read(fd_, space.data(), space.size());
+        if (count < 0 && (errno == EINTR || errno == EAGAIN))
+            continue;
+        if (count <= 0)
+            return; // the host closed its end of the socket pair
+        ring.commit(static_cast<size_t>(count));
+
+        for (;;)
+        {
+            FrameView frame;
+            size_t consumed = 0;
+            const ParseStatus status = parseFrame(ring.readable(), frame, consumed);
+            if (status == ParseStatus::Frame && frame.type == FrameType::Request)
+            {
+                framesReceived_.fetch_add(1, std::memory_order_relaxed);
+                handle(frame);
+                if (!writeFully(fd_, response_.finish(frame.sequence)))
+                    return;
+            }
+            ring.consume(consumed);
+            if (status == ParseStatus::Incomplete)
+                break;
+        }
+        if (ring.size() == ring.capacity())
+            ring.consume(ring.size());
+    }
+}
+
+void FirmwareEmulator::handle(const FrameView &request)
+{
+    response_.begin(FrameType::Response);
+    RecordReader reader(request.payload);
+    for (Record record; reader.next(record);)
+    {
+        if (record.type == RecordType::MotorRead && record.device < motors_.size())
+        {
+            const MockMotor &motor = *motors_[record.device];
+            response_.addMotorState(record.device, {motor.getCurrentSpeed(), motor.getCurrentPosition(),
+                                                    motor.isMoving(), motor.isError()});
+        }
+        else if (record.type == RecordType::ServoRead && record.device < servos_.size())
+        {
+            const MockServo &servo = *servos_[record.device];
+            response_.addServoState(record.device, {servo.getCurrentAngle(), servo.getCurrentSpeed(),
+                                                    servo.isMoving(), servo.isError()});
+        }
+        else
+            response_.addAck(record.device, applyCommand(record));
+    }
+}
+
+bool FirmwareEmulator::applyCommand(const Record &record)
+{
+    const int32_t value = record.value;
+    if (record.type < RecordType::ServoSetAngle)
+    {
+        if (record.device >= motors_.size())
+            return false;
+        MockMotor &motor = *motors_[record.device];
+        switch (record.type)
+        {
+        case RecordType::MotorSetSpeed:
+            return motor.setSpeed(static_cast<int16_t>(value));
+        case RecordType::MotorSetPosition:
+            return motor.setPosition(value);
+        case RecordType::MotorStop:
+            return motor.stop();
+        case RecordType::MotorEmergencyStop:
+            return motor.emergencyStop();
+        case RecordType::MotorSetMaxSpeed:
+            return motor.setMaxSpeed(static_cast<int16_t>(value));
+        case RecordType::MotorSetAcceleration:
+            return motor.setAcceleration(static_cast<uint16_t>(value));
+        default:
+            return false;
+        }
+    }
+    if (record.device >= servos_.size())
+        return false;
+    MockServo &servo = *servos_[record.device];
+    switch (record.type)
+    {
+    case RecordType::ServoSetAngle:
+        return servo.setAngle(static_cast<uint16_t>(value));
+    case RecordType::ServoSetSpeed:
+        return servo.setSpeed(static_cast<uint8_t>(value));
+    case RecordType::ServoStop:
+        return servo.stop();
+    case RecordType::ServoEmergencyStop:
+        return servo.emergencyStop();
+    case RecordType::ServoSetAngleLimits:
+        return servo.setAngleLimits(static_cast<uint16_t>(value), static_cast<uint16_t>(value >> 16));
+    case RecordType::ServoSetMaxSpeed:
+        return servo.setMaxSpeed(static_cast<uint8_t>(value));
+    default:
+        return false;
+    }
+}
+
+} // namespace FingerFlexAid
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "../utils/SerialProtocol.hpp"
+#include "MockMotor.hpp"
+#include "MockServo.hpp"
+#include "SimulationEngine.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace FingerFlexAid
+{
+
+// Stand-in for the ESP32 bridge firmware: answers the serial protocol on one end of a pseudo-terminal or a
+// socket pair, driving mock devices stepped by its own running SimulationEngine. Lets SerialLink, SerialMotor
+// and SerialServo be tested and benchmarked end to end without hardware.
+class FirmwareEmulator
+{
+  public:
+    struct Options
+    {
+        size_t motors = 5;
+        size_t servos = 5;
+    };
+
+    // Serves the master side of a new pseudo-terminal; open getDevicePath() with SerialLink::open(). Null if
+    // no pseudo-terminal is available.
+    static std::unique_ptr<FirmwareEmulator> createPty(const Options &options);
+    // Serves one end of a socket pair, handing the other end to the host in `hostFd`. Null on failure.
+    static std::unique_ptr<FirmwareEmulator> createLoopback(const Options &options, int &hostFd);
+    ~FirmwareEmulator();
+
+    FirmwareEmulator(const FirmwareEmulator &) = delete;
+    FirmwareEmulator &operator=(const FirmwareEmulator &) = delete;
+
+    // The pseudo-terminal's slave device; empty for a loopback emulator.
+    const std::string &getDevicePath() const
+    {
+        return devicePath_;
+    }
+    MockMotor &getMotor(size_t index)
+    {
+        return *motors_[index];
+    }
+    MockServo &getServo(size_t index)
+    {
+        return *servos_[index];
+    }
+    uint64_t getFramesReceived() const
+    {
+        return framesReceived_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    FirmwareEmulator(const Options &options, int fd, int keepAliveFd, int wakeFd, std::string devicePath);
+
+    void run();
+    // Applies one request and builds its response in response_.
+    void handle(const FrameView &request);
+    bool applyCommand(const Record &record);
+
+    const int fd_;
+    const int keepAliveFd_; // the pty slave, held open so the master never sees a hang-up between clients
+    const int wakeFd_;
+    const std::string devicePath_;
+    SimulationEngine engine_;
+    std::vector<std::unique_ptr<MockMotor>> motors_;
+    std::vector<std::unique_ptr<MockServo>> servos_;
+    FrameWriter response_;
+    std::atomic<uint64_t> framesReceived_{0};
+    std::thread thread_;
+};
+
+} // namespace FingerFlexAid
@@ -5,149 +5,271 @@
 namespace FingerFlexAid
 {
 
+namespace
+{
+
+uint32_t acquireSlot(SimulationEngine &engine, MockMotor *motor)
+{
+    auto lock = engine.lock();
+    return engine.motors().acquire(motor, motor);
+}
+
+// Taken under the lock, since the store may be growing on another thread
+const Seqlock<MotorReadout> &readoutOf(SimulationEngine &engine, uint32_t slot)
+{
+    auto lock = engine.lock();
+    return engine.motors().readouts[slot];
+}
+
+const Seqlock<MotorLimits> &limitsOf(SimulationEngine &engine, uint32_t slot)
+{
+    auto lock = engine.lock();
+    return engine.motors().limits[slot];
+}
+
+} // namespace
+
 MockMotor::MockMotor(const std::string &id)
-    : Motor(id, 100.0, 1.0), id_(id), updateThread_([this]() { updatePosition(); })
+    : Motor(id, 100.0, 1.0), id_(id), ownedEngine_(std::make_unique<SimulationEngine>()), engine_(ownedEngine_.get()),
+      state_(engine_->motors()), slot_(acquireSlot(*engine_, this)),
+      readout_(readoutOf(*engine_, slot_)), limits_(limitsOf(*engine_, slot_))
+{
+    ownedEngine_->start();
+}
+
+MockMotor::MockMotor(const std::string &id, SimulationEngine &engine)
+    : Motor(id, 100.0, 1.0), id_(id), engine_(&engine), state_(engine.motors()), slot_(acquireSlot(engine, this)),
+      readout_(readoutOf(engine, slot_)), limits_(limitsOf(engine, slot_))
 {
 }
 
 MockMotor::~MockMotor()
 {
-    shouldStop_ = true;
-    if (updateThread_.joinable())
+    if (ownedEngine_)
     {
-        updateThread_.join();
+        ownedEngine_->stop();
     }
+    auto lock = engine_->lock();
+    state_.release(slot_);
 }
 
 bool MockMotor::setSpeed(int16_t speed)
 {
-    if (isError_)
+    auto lock = engine_->lock();
+    return setSpeedLocked(speed);
+}
+
+bool MockMotor::setSpeedLocked(int16_t speed)
+{
+    if (state_.error[slot_])
     {
         return false;
     }
 
-    if (!validateSpeed(speed))
+    if (std::abs(speed) > state_.maxSpeed[slot_])
     {
-        std::lock_guard<std::mutex> lock(errorMutex_);
-        lastError_ = "Invalid speed value: " + std::to_string(speed);
-        isError_ = true;
+        raiseError(ErrorRecord::raise(ErrorCode::InvalidSpeed, speed));
         return false;
     }
 
-    targetSpeed_ = speed;
-    // Do not set currentSpeed_ here; let updatePosition handle it gradually
-    isMoving_ = (speed != 0);
+    state_.targetSpeed[slot_] = speed;
+    // Do not set currentSpeed here; let the engine's integration step handle it gradually
+    state_.setMoving(slot_, speed != 0);
     return true;
 }
 
 bool MockMotor::setPosition(int32_t position)
 {
-    if (isError_)
+    auto lock = engine_->lock();
+    return setPositionLocked(position);
+}
+
+bool MockMotor::setPositionLocked(int32_t position)
+{
+    if (state_.error[slot_])
     {
         return false;
     }
 
-    if (!validatePosition(position))
+    if (std::abs(int64_t{position} - state_.currentPosition[slot_]) > kMaxPositionChange)
     {
-        std::lock_guard<std::mutex> lock(errorMutex_);
-        lastError_ = "Invalid position value: " + std::to_string(position);
-        isError_ = true;
+        raiseError(ErrorRecord::raise(ErrorCode::InvalidPosition, position));
         return false;
     }
 
-    targetPosition_ = position;
-    currentPosition_ = position;
-    isMoving_ = true;
+    state_.targetPosition[slot_] = position;
+    state_.currentPosition[slot_] = position;
+    state_.setMoving(slot_, true);
     return true;
 }
 
 bool MockMotor::stop()
 {
-    if (isError_)
+    auto lock = engine_->lock();
+    return stopLocked();
+}
+
+bool MockMotor::stopLocked()
+{
+    if (state_.error[slot_])
     {
         return false;
     }
 
-    targetSpeed_ = 0;
-    currentSpeed_ = 0;
-    isMoving_ = false;
+    state_.targetSpeed[slot_] = 0;
+    state_.currentSpeed[slot_] = 0;
+    state_.setMoving(slot_, false);
     return true;
 }
 
 bool MockMotor::emergencyStop()
 {
-    targetSpeed_ = 0;
-    currentSpeed_ = 0;
-    isMoving_ = false;
-    isError_ = true;
+    auto lock = engine_->lock();
+    return emergencyStopLocked();
+}
 
-    std::lock_guard<std::mutex> lock(errorMutex_);
-    lastError_ = "Emergency stop activated";
+bool MockMotor::emergencyStopLocked()
+{
+    state_.targetSpeed[slot_] = 0;
+    state_.currentSpeed[slot_] = 0;
+    state_.setMoving(slot_, false);
+    raiseError(ErrorRecord::raise(ErrorCode::EmergencyStop));
     return true;
 }
 
 int16_t MockMotor::getCurrentSpeed() const
 {
-    return currentSpeed_;
+    return static_cast<int16_t>(readout_.load().speed);
 }
 
 int32_t MockMotor::getCurrentPosition() const
 {
-    return currentPosition_;
+    return readout_.load().position;
 }
 
 bool MockMotor::isMoving() const
 {
-    return isMoving_;
+    return readout_.load().moving != 0;
 }
 
 bool MockMotor::isError() const
 {
-    return isError_;
+    return readout_.load().error != 0;
+}
+
+MotorSnapshot MockMotor::getSnapshot() const
+{
+    const MotorReadout readout = readout_.load();
+    return {static_cast<double>(readout.speed), static_cast<double>(readout.position), readout.moving != 0,
+            readout.error != 0};
 }
 
 std::optional<std::string> MockMotor::getLastError() const
 {
-    std::lock_guard<std::mutex> lock(errorMutex_);
-    return lastError_;
+    return lastError_.load().message();
+}
+
+ErrorRecord MockMotor::getLastErrorRecord() const
+{
+    return lastError_.load();
 }
 
 bool MockMotor::setMaxSpeed(int16_t maxSpeed)
 {
+    auto lock = engine_->lock();
     if (maxSpeed <= 0)
     {
-        std::lock_guard<std::mutex> lock(errorMutex_);
-        lastError_ = "Invalid max speed value: " + std::to_string(maxSpeed);
-        isError_ = true;
+        raiseError(ErrorRecord::raise(ErrorCode::InvalidMaxSpeed, maxSpeed));
         return false;
     }
 
-    maxSpeed_ = maxSpeed;
+    state_.setMaxSpeed(slot_, maxSpeed);
     return true;
 }
 
 bool MockMotor::setAcceleration(uint16_t acceleration)
 {
+    auto lock = engine_->lock();
     if (acceleration == 0)
     {
-        std::lock_guard<std::mutex> lock(errorMutex_);
-        lastError_ = "Invalid acceleration value: " + std::to_string(acceleration);
-        isError_ = true;
+        raiseError(ErrorRecord::raise(ErrorCode::InvalidAcceleration, acceleration));
         return false;
     }
 
-    acceleration_ = acceleration;
+    state_.setAcceleration(slot_, acceleration);
     return true;
 }
 
 int16_t MockMotor::getMaxSpeed() const
 {
-    return maxSpeed_;
+    return static_cast<int16_t>(limits_.load().maxSpeed);
 }
 
 uint16_t MockMotor::getAcceleration() const
 {
-    return acceleration_;
+    return static_cast<uint16_t>(limits_.load().acceleration);
+}
+
+StatusPublisher *MockMotor::getStatusPublisher()
+{
+    return this;
+}
+
+BatchDomain *MockMotor::getBatchDomain()
+{
+    return engine_;
+}
+
+void MockMotor::requestShutdown()
+{
+    if (ownedEngine_)
+        ownedEngine_->requestStop();
+}
+
+void MockMotor::resume()
+{
+    if (ownedEngine_)
+        ownedEngine_->start();
+}
+
+bool MockMotor::checkCommand(const MotorCommand &command) const
+{
+    if (command.type == MotorCommand::Type::EmergencyStop)
+    {
+        return true;
+    }
+    if (state_.error[slot_])
+    {
+        return false;
+    }
+
+    switch (command.type)
+    {
+    case MotorCommand::Type::SetSpeed:
+        return std::abs(command.value) <= state_.maxSpeed[slot_];
+    case MotorCommand::Type::SetPosition:
+        return std::abs(int64_t{command.value} - state_.currentPosition[slot_]) <= kMaxPositionChange;
+    case MotorCommand::Type::Stop:
+    case MotorCommand::Type::EmergencyStop:
+        return true;
+    }
+    return false;
+}
+
+bool MockMotor::applyCommand(const MotorCommand &command)
+{
+    switch (command.type)
+    {
+    case MotorCommand::Type::SetSpeed:
+        return setSpeedLocked(static_cast<int16_t>(command.value));
+    case MotorCommand::Type::SetPosition:
+        return setPositionLocked(command.value);
+    case MotorCommand::Type::Stop:
+        return stopLocked();
+    case MotorCommand::Type::EmergencyStop:
+        return emergencyStopLocked();
+    }
+    return false;
 }
 
 void MockMotor::simulateHardwareDelay(std::chrono::milliseconds delay)
@@ -157,72 +279,38 @@ void MockMotor::simulateHardwareDelay(std::chrono::milliseconds delay)
 
 void MockMotor::simulateError(const std::string &error)
 {
-    std::lock_guard<std::mutex> lock(errorMutex_);
-    lastError_ = error;
-    isError_ = true;
+    auto lock = engine_->lock();
+    raiseError(ErrorRecord::raise(error));
 }
 
-void MockMotor::clearError()
+void MockMotor::simulateError(const char *error)
 {
-    std::lock_guard<std::mutex> lock(errorMutex_);
-    lastError_.reset();
-    isError_ = false;
+    auto lock = engine_->lock();
+    raiseError(ErrorRecord::raise(error));
 }
 
-void MockMotor::updatePosition()
+void MockMotor::simulateError(bool simulate)
 {
-    while (!shouldStop_)
+    if (!simulate)
     {
-        if (!isError_ && isMoving_)
-        {
-            // Calculate acceleration step based on current acceleration setting
-            // Use a smaller divisor for smoother acceleration
-            int16_t maxStep = std::max<int16_t>(1, static_cast<int16_t>(acceleration_ / 200));
-            // Further limit the step to a fixed maximum to ensure gradual acceleration
-            constexpr int16_t kMaxSpeedStep = 25; // Balanced for realism and test speed
-            maxStep = std::min(maxStep, kMaxSpeedStep);
-
-            // Calculate speed difference and apply acceleration/deceleration
-            int16_t speedDiff = targetSpeed_ - currentSpeed_;
-            if (speedDiff != 0)
-            {
-                // Use a non-linear acceleration curve for more realistic behavior
-                double accelerationFactor = std::min(1.0, std::abs(speedDiff) / static_cast<double>(maxSpeed_));
-                int16_t step =
-                    std::clamp<int16_t>(static_cast<int16_t>(maxStep * (0.5 + accelerationFactor * 0.5)), 1,
-                                        std::min<int16_t>(static_cast<int16_t>(std::abs(speedDiff)), kMaxSpeedStep));
-
-                if (speedDiff > 0)
-                {
-                    currentSpeed_ += step;
-                }
-                else
-                {
-                    currentSpeed_ -= step;
-                }
-            }
-            // Update position based on current speed with non-linear scaling
-            if (currentSpeed_ != 0)
-            {
-                double speedFactor = std::abs(currentSpeed_) / static_cast<double>(maxSpeed_);
-                double positionStep = (currentSpeed_ / 10.0) * (0.7 + speedFactor * 0.3);
-                currentPosition_ += static_cast<int32_t>(positionStep);
-            }
-        }
-        // Increase hardware delay for more observable gradual acceleration
-        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        clearError();
+        return;
     }
+    auto lock = engine_->lock();
+    raiseError(ErrorRecord::raise("Simulated error"));
 }
 
-bool MockMotor::validateSpeed(int16_t speed) const
+void MockMotor::clearError()
 {
-    return std::abs(speed) <= maxSpeed_;
+    auto lock = engine_->lock();
+    lastError_.store({});
+    state_.setError(slot_, false);
 }
 
-bool MockMotor::validatePosition(int32_t position) const
+void MockMotor::raiseError(const ErrorRecord &record)
 {
-    const int32_t maxPositionChange = 1000000;
-    return std::abs(position - currentPosition_) <= maxPositionChange;
+    lastError_.store(record);
+    state_.setError(slot_, true);
 }
 
 } // namespace FingerFlexAid
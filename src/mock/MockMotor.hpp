@@ -1,67 +1,94 @@
 #pragma once
 
 #include "../core/MotorController.hpp"
+#include "../utils/Seqlock.hpp"
+#include "SimulationEngine.hpp"
 #include "models/Motor.hpp"
 #include <atomic>
 #include <chrono>
-#include <mutex>
-#include <thread>
+#include <memory>
 
 namespace FingerFlexAid
 {
 
-class MockMotor : public Motor
+// View onto one motor slot of a SimulationEngine's state store. Writes go through the engine lock; getters
+// read a readout the store republishes after every change, so they never wait for a tick.
+class MockMotor : public Motor, public MotorController
 {
   public:
+    // Standalone mock, integrated by a private engine running on its own thread.
     explicit MockMotor(const std::string &id = "mock_motor");
-    ~MockMotor();
+    // Mock stepped by a shared engine; the engine must outlive the motor.
+    MockMotor(const std::string &id, SimulationEngine &engine);
+    ~MockMotor() override;
 
-    bool setSpeed(int16_t speed);
-    bool setPosition(int32_t position);
-    bool stop();
-    bool emergencyStop();
+    bool setSpeed(int16_t speed) override;
+    bool setPosition(int32_t position) override;
+    bool stop() override;
+    bool emergencyStop() override;
 
-    int16_t getCurrentSpeed() const;
-    int32_t getCurrentPosition() const;
-    bool isMoving() const;
-    bool isError() const;
-    std::optional<std::string> getLastError() const;
+    int16_t getCurrentSpeed() const override;
+    int32_t getCurrentPosition() const override;
+    bool isMoving() const override;
+    bool isError() const override;
+    std::optional<std::string> getLastError() const override;
+    ErrorRecord getLastErrorRecord() const override;
+    ErrorRecord getErrorRecord() const override
+    {
+        return getLastErrorRecord();
+    }
+    // Read from the engine's readout, rather than from the Motor base.
+    MotorSnapshot getSnapshot() const override;
 
-    bool setMaxSpeed(int16_t maxSpeed);
-    bool setAcceleration(uint16_t acceleration);
-    int16_t getMaxSpeed() const;
-    uint16_t getAcceleration() const;
+    bool setMaxSpeed(int16_t maxSpeed) override;
+    bool setAcceleration(uint16_t acceleration) override;
+    int16_t getMaxSpeed() const override;
+    uint16_t getAcceleration() const override;
+
+    StatusPublisher *getStatusPublisher() override;
+    BatchDomain *getBatchDomain() override;
+    // Stops the private engine of a standalone mock; a mock on a shared engine leaves it running.
+    void requestShutdown() override;
+    void resume() override;
+    bool checkCommand(const MotorCommand &command) const override;
+    bool applyCommand(const MotorCommand &command) override;
 
     void simulateHardwareDelay(std::chrono::milliseconds delay);
     void simulateError(const std::string &error);
+    // Same as simulateError(message) / clearError(), matching MockServo
+    void simulateError(bool simulate);
+    // Keeps string literals from binding to simulateError(bool)
+    void simulateError(const char *error);
     void clearError();
     std::string getId() const
     {
         return id_;
     }
 
+  protected:
+    // The engine's store publishes this motor's flags, not the Motor base.
+    void publishStatus() override
+    {
+    }
+
   private:
-    void updatePosition();
-    bool validateSpeed(int16_t speed) const;
-    bool validatePosition(int32_t position) const;
+    // Setter bodies; the caller holds the engine lock.
+    bool setSpeedLocked(int16_t speed);
+    bool setPositionLocked(int32_t position);
+    bool stopLocked();
+    bool emergencyStopLocked();
+    // Records the error and raises the flag; the caller holds the engine lock, which serialises the stores.
+    void raiseError(const ErrorRecord &record);
 
     const std::string id_;
-    std::atomic<int16_t> currentSpeed_{0};
-    std::atomic<int32_t> currentPosition_{0};
-    std::atomic<int16_t> targetSpeed_{0};
-    std::atomic<int32_t> targetPosition_{0};
-    std::atomic<int16_t> maxSpeed_{1000};
-    std::atomic<uint16_t> acceleration_{1000};
-    std::atomic<bool> isMoving_{false};
-    std::atomic<bool> isError_{false};
+    std::unique_ptr<SimulationEngine> ownedEngine_;
+    SimulationEngine *engine_;
+    MotorStateStore &state_;
+    const uint32_t slot_;
+    const Seqlock<MotorReadout> &readout_; // the store's readout for slot_
+    const Seqlock<MotorLimits> &limits_;    // and its limits
     std::atomic<std::chrono::milliseconds> hardwareDelay_{std::chrono::milliseconds(10)};
-
-    mutable std::mutex errorMutex_;
-    std::optional<std::string> lastError_;
-
-    std::thread updateThread_;
-    std::atomic<bool> shouldStop_{false};
-    mutable std::mutex stateMutex_;
+    Seqlock<ErrorRecord> lastError_;
 };
 
 } // namespace FingerFlexAid
@@ -1,24 +1,58 @@
 #include "MockServo.hpp"
 #include <algorithm>
 #include <cmath>
-#include <iostream>
-#include <thread>
 
 using namespace FingerFlexAid;
 using namespace std::chrono_literals;
 
-MockServo::MockServo(const std::string &id) : id_(id)
+namespace
 {
-    updateThread_ = std::thread(&MockServo::updateAngle, this);
+
+uint32_t acquireSlot(SimulationEngine &engine, MockServo *servo)
+{
+    auto lock = engine.lock();
+    return engine.servos().acquire(servo, servo);
+}
+
+// Taken under the lock, since the store may be growing on another thread
+const Seqlock<ServoReadout> &readoutOf(SimulationEngine &engine, uint32_t slot)
+{
+    auto lock = engine.lock();
+    return engine.servos().readouts[slot];
+}
+
+const Seqlock<ServoLimits> &limitsOf(SimulationEngine &engine, uint32_t slot)
+{
+    auto lock = engine.lock();
+    return engine.servos().limits[slot];
+}
+
+} // namespace
+
+MockServo::MockServo(const std::string &id)
+    : id_(id), ownedEngine_(std::make_unique<SimulationEngine>()), engine_(ownedEngine_.get()),
+      state_(engine_->servos()), slot_(acquireSlot(*engine_, this)),
+      readout_(readoutOf(*engine_, slot_)), limits_(limitsOf(*engine_, slot_))
+{
+    setTelemetryIdentity(TelemetryKind::Servo, id_);
+    ownedEngine_->start();
+}
+
+MockServo::MockServo(const std::string &id, SimulationEngine &engine)
+    : id_(id), engine_(&engine), state_(engine.servos()), slot_(acquireSlot(engine, this)),
+      readout_(readoutOf(engine, slot_)), limits_(limitsOf(engine, slot_))
+{
+    setTelemetryIdentity(TelemetryKind::Servo, id_);
 }
 
 MockServo::~MockServo()
 {
-    shouldStop_ = true;
-    if (updateThread_.joinable())
+    if (ownedEngine_)
     {
-        updateThread_.join();
+        ownedEngine_->stop();
     }
+    auto lock = engine_->lock();
+    state_.release(slot_);
 }
 
 void MockServo::setAngle(double angle)
@@ -33,7 +67,7 @@ bool MockServo::setAngleChecked(double angle)
 
 double MockServo::getAngle() const
 {
-    return currentAngle_.load();
+    return readout_.load().angle.toDouble();
 }
 
 void MockServo::setSpeed(double speed)
@@ -48,164 +82,250 @@ bool MockServo::setSpeedChecked(double speed)
 
 double MockServo::getSpeed() const
 {
-    return currentSpeed_.load();
+    return readout_.load().speed.toDouble();
 }
 
 bool MockServo::isMoving() const
 {
-    return isMoving_.load();
+    return readout_.load().moving != 0;
 }
 
 void MockServo::simulateError(bool simulate)
 {
-    std::lock_guard<std::mutex> lock(errorMutex_);
-    error_.store(simulate);
-    if (!simulate)
-    {
-        lastError_.clear();
-    }
+    auto lock = engine_->lock();
+    setErrorLocked(simulate, simulate ? std::nullopt : std::optional<ErrorRecord>(ErrorRecord{}));
 }
 
 bool MockServo::hasError() const
 {
-    return error_.load();
+    return readout_.load().error != 0;
 }
 
-bool MockServo::setAngleLimits(double min, double max)
+ServoSnapshot MockServo::getSnapshot() const
 {
-    if (min >= max || min < 0 || max > 180)
+    const ServoReadout readout = readout_.load();
+    return {readout.angle.toDouble(), readout.speed.toDouble(), readout.moving != 0, readout.error != 0};
+}
+
+bool MockServo::setAngle(uint16_t angle)
+{
+    return setAngleImpl(angle);
+}
+
+bool MockServo::setSpeed(uint8_t speed)
+{
+    return setSpeedImpl(speed);
+}
+
+uint16_t MockServo::getCurrentAngle() const
+{
+    return static_cast<uint16_t>(readout_.load().angle.round());
+}
+
+uint8_t MockServo::getCurrentSpeed() const
+{
+    return static_cast<uint8_t>(readout_.load().speed.round());
+}
+
+uint8_t MockServo::getMaxSpeed() const
+{
+    return static_cast<uint8_t>(limits_.load().maxSpeed.round());
+}
+
+std::pair<uint16_t, uint16_t> MockServo::getAngleLimits() const
+{
+    const ServoLimits limits = limits_.load();
+    return {static_cast<uint16_t>(limits.minAngle.round()), static_cast<uint16_t>(limits.maxAngle.round())};
+}
+
+bool MockServo::setAngleLimits(uint16_t min, uint16_t max)
+{
+    auto lock = engine_->lock();
+    if (min >= max || max > 180)
     {
-        simulateError(true);
+        setErrorLocked(true, ErrorRecord::raise(ErrorCode::InvalidAngleLimits));
         return false;
     }
-    minAngle_.store(min);
-    maxAngle_.store(max);
+    state_.minAngle[slot_] = Fixed::fromInt(min);
+    state_.maxAngle[slot_] = Fixed::fromInt(max);
+    state_.publishReadout(slot_);
     return true;
 }
 
-bool MockServo::setMaxSpeed(double speed)
+bool MockServo::setMaxSpeed(uint8_t speed)
 {
+    auto lock = engine_->lock();
     if (speed <= 0 || speed > 100)
     {
-        simulateError(true);
+        setErrorLocked(true, ErrorRecord::raise(ErrorCode::InvalidMaxSpeed, speed));
         return false;
     }
-    maxSpeed_.store(speed);
+    state_.maxSpeed[slot_] = Fixed::fromInt(speed);
+    state_.publishReadout(slot_);
     return true;
 }
 
+StatusPublisher *MockServo::getStatusPublisher()
+{
+    return this;
+}
+
+BatchDomain *MockServo::getBatchDomain()
+{
+    return engine_;
+}
+
+void MockServo::requestShutdown()
+{
+    if (ownedEngine_)
+        ownedEngine_->requestStop();
+}
+
+void MockServo::resume()
+{
+    if (ownedEngine_)
+        ownedEngine_->start();
+}
+
+bool MockServo::checkCommand(const ServoCommand &command) const
+{
+    if (command.type == ServoCommand::Type::EmergencyStop)
+        return true;
+    if (state_.error[slot_])
+        return false;
+    switch (command.type)
+    {
+    case ServoCommand::Type::SetAngle:
+        return command.value >= state_.minAngle[slot_].round() && command.value <= state_.maxAngle[slot_].round();
+    case ServoCommand::Type::SetSpeed:
+        return command.value >= 0 && command.value <= state_.maxSpeed[slot_].round();
+    case ServoCommand::Type::Stop:
+    case ServoCommand::Type::EmergencyStop:
+        return true;
+    }
+    return false;
+}
+
+bool MockServo::applyCommand(const ServoCommand &command)
+{
+    switch (command.type)
+    {
+    case ServoCommand::Type::SetAngle:
+        return setAngleLocked(command.value);
+    case ServoCommand::Type::SetSpeed:
+        return setSpeedLocked(command.value);
+    case ServoCommand::Type::Stop:
+        return stopLocked();
+    case ServoCommand::Type::EmergencyStop:
+        return emergencyStopLocked();
+    }
+    return false;
+}
+
 bool MockServo::stop()
 {
-    if (hasError())
+    auto lock = engine_->lock();
+    return stopLocked();
+}
+
+bool MockServo::stopLocked()
+{
+    if (state_.error[slot_])
         return false;
-    isMoving_ = false;
+    state_.setMoving(slot_, false);
     return true;
 }
 
 bool MockServo::emergencyStop()
 {
-    isMoving_ = false;
-    simulateError("Emergency stop activated");
+    auto lock = engine_->lock();
+    return emergencyStopLocked();
+}
+
+bool MockServo::emergencyStopLocked()
+{
+    state_.setMoving(slot_, false);
+    setErrorLocked(true, ErrorRecord::raise(ErrorCode::EmergencyStop));
     return true;
 }
 
 void MockServo::clearError()
 {
-    std::lock_guard<std::mutex> lock(errorMutex_);
-    error_ = false;
-    lastError_.clear();
+    auto lock = engine_->lock();
+    setErrorLocked(false, ErrorRecord{});
 }
 
 void MockServo::simulateError(const std::string &errorMsg)
 {
-    std::lock_guard<std::mutex> lock(errorMutex_);
-    error_ = true;
-    lastError_ = errorMsg;
+    auto lock = engine_->lock();
+    setErrorLocked(true, ErrorRecord::raise(errorMsg));
+}
+
+void MockServo::simulateError(const char *errorMsg)
+{
+    auto lock = engine_->lock();
+    setErrorLocked(true, ErrorRecord::raise(errorMsg));
 }
 
 void MockServo::simulateHardwareDelay(std::chrono::milliseconds delay)
 {
     hardwareDelay_ = delay;
+    auto lock = engine_->lock();
+    state_.periodNs[slot_] = std::chrono::nanoseconds(ServoStateStore::kUpdatePeriod + delay).count();
 }
 
 std::optional<std::string> MockServo::getLastError() const
 {
-    std::lock_guard<std::mutex> lock(errorMutex_);
-    return lastError_.empty() ? std::nullopt : std::optional<std::string>(lastError_);
+    return lastError_.load().message();
 }
 
-void MockServo::updateAngle()
+ErrorRecord MockServo::getLastErrorRecord() const
 {
-    while (!shouldStop_)
-    {
-        if (isMoving_ && !hasError())
-        {
-            // Non-linear movement curve for more realistic simulation
-            double current = currentAngle_.load();
-            double target = targetAngle_.load();
-            double diff = target - current;
-            double absDiff = std::abs(diff);
-
-            if (absDiff > 0.1) // Only move if difference is significant
-            {
-                // Calculate step size based on current speed and difference
-                double speed = currentSpeed_.load();
-                double step = std::min(absDiff, speed * 0.1);
-                // Apply non-linear curve (slower at start/end, faster in middle)
-                step *= std::sin(M_PI * (1.0 - absDiff / 180.0));
-
-                if (diff > 0)
-                    currentAngle_.store(current + step);
-                else
-                    currentAngle_.store(current - step);
-            }
-            else
-            {
-                currentAngle_.store(target);
-                isMoving_ = false;
-            }
-        }
-
-        // Gradually update speed
-        double currentSpeed = currentSpeed_.load();
-        double targetSpeed = targetSpeed_.load();
-        double speedDiff = targetSpeed - currentSpeed;
-        if (std::abs(speedDiff) > 0.1)
-        {
-            double step = std::copysign(std::min(std::abs(speedDiff), 5.0), speedDiff);
-            currentSpeed_.store(currentSpeed + step);
-        }
-        else
-        {
-            currentSpeed_.store(targetSpeed);
-        }
-
-        std::this_thread::sleep_for(20ms + hardwareDelay_.load());
-    }
+    return lastError_.load();
+}
+
+void MockServo::setErrorLocked(bool error, std::optional<ErrorRecord> record)
+{
+    if (record)
+        lastError_.store(*record);
+    state_.setError(slot_, error);
 }
 
 bool MockServo::setAngleImpl(double angle)
 {
-    if (hasError())
+    auto lock = engine_->lock();
+    return setAngleLocked(angle);
+}
+
+bool MockServo::setAngleLocked(double angle)
+{
+    if (state_.error[slot_])
         return false;
-    double min = minAngle_.load();
-    double max = maxAngle_.load();
-    if (angle < min || angle > max)
+    // Checked as a double, so a NaN fails the comparison and is refused rather than converted to zero
+    if (!(angle >= state_.minAngle[slot_].toDouble() && angle <= state_.maxAngle[slot_].toDouble()))
         return false;
-    angle = std::clamp(angle, min, max);
-    targetAngle_.store(angle);
-    isMoving_ = true;
+    state_.targetAngle[slot_] = Fixed::fromDouble(angle);
+    state_.setMoving(slot_, true);
     return true;
 }
 
 bool MockServo::setSpeedImpl(double speed)
 {
-    if (hasError())
+    auto lock = engine_->lock();
+    return setSpeedLocked(speed);
+}
+
+bool MockServo::setSpeedLocked(double speed)
+{
+    if (state_.error[slot_])
         return false;
-    double max = maxSpeed_.load();
-    if (speed < 0.0 || speed > max)
+    if (!(speed >= 0.0 && speed <= state_.maxSpeed[slot_].toDouble()))
+    {
+        setErrorLocked(true, ErrorRecord::raise(ErrorCode::InvalidSpeed, static_cast<int32_t>(std::lround(speed))));
         return false;
-    speed = std::clamp(speed, 0.0, max);
-    targetSpeed_.store(speed);
+    }
+    // Speed is a commanded parameter of the servo, so it applies immediately.
+    state_.currentSpeed[slot_] = Fixed::fromDouble(speed);
+    state_.publishReadout(slot_);
     return true;
 }
@@ -1,20 +1,26 @@
 #pragma once
 
+#include "../core/ServoController.hpp"
 #include "../models/Servo.hpp"
+#include "../utils/Seqlock.hpp"
+#include "SimulationEngine.hpp"
 #include <atomic>
 #include <chrono>
-#include <mutex>
+#include <memory>
 #include <optional>
 #include <string>
-#include <thread>
 
 namespace FingerFlexAid
 {
 
-class MockServo : public Servo
+// View onto one servo slot of a SimulationEngine's state store; reads work as for MockMotor.
+class MockServo : public Servo, public ServoController
 {
   public:
+    // Standalone mock, integrated by a private engine running on its own thread.
     explicit MockServo(const std::string &id = "mock_servo");
+    // Mock stepped by a shared engine; the engine must outlive the servo.
+    MockServo(const std::string &id, SimulationEngine &engine);
     ~MockServo() override;
 
     // Base Servo interface implementation
@@ -25,66 +31,69 @@ class MockServo : public Servo
     bool isMoving() const override;
     void simulateError(bool simulate) override;
     bool hasError() const override;
+    // All fields from one readout
+    ServoSnapshot getSnapshot() const override;
+
+    // ServoController interface implementation; angles and speeds are reported rounded to whole units
+    bool setAngle(uint16_t angle) override;
+    bool setSpeed(uint8_t speed) override;
+    bool stop() override;
+    bool emergencyStop() override;
+    uint16_t getCurrentAngle() const override;
+    uint8_t getCurrentSpeed() const override;
+    bool isError() const override
+    {
+        return hasError();
+    }
+    std::optional<std::string> getLastError() const override;
+    ErrorRecord getLastErrorRecord() const override;
+    bool setAngleLimits(uint16_t minAngle, uint16_t maxAngle) override;
+    bool setMaxSpeed(uint8_t maxSpeed) override;
+    std::pair<uint16_t, uint16_t> getAngleLimits() const override;
+    uint8_t getMaxSpeed() const override;
+    StatusPublisher *getStatusPublisher() override;
+    BatchDomain *getBatchDomain() override;
+    void requestShutdown() override;
+    void resume() override;
+    bool checkCommand(const ServoCommand &command) const override;
+    bool applyCommand(const ServoCommand &command) override;
 
     // Additional mock-specific methods
     std::string getId() const
     {
         return id_;
     }
-    double getCurrentAngle() const
-    {
-        return currentAngle_;
-    }
-    double getCurrentSpeed() const
-    {
-        return currentSpeed_;
-    }
-    double getMaxSpeed() const
-    {
-        return maxSpeed_;
-    }
-    std::pair<double, double> getAngleLimits() const
-    {
-        return {minAngle_, maxAngle_};
-    }
-    bool setAngleLimits(double min, double max);
-    bool setMaxSpeed(double speed);
-    bool stop();
-    bool emergencyStop();
     void clearError();
     void simulateError(const std::string &errorMsg);
+    // Keeps string literals from binding to simulateError(bool)
+    void simulateError(const char *errorMsg);
     void simulateHardwareDelay(std::chrono::milliseconds delay);
-    std::optional<std::string> getLastError() const;
-    bool isError() const
-    {
-        return hasError();
-    }
 
-    // Overloads for test compatibility
-    bool setAngle(bool angle); // will be implemented as setAngle(double) and return bool
-    bool setSpeed(bool speed); // will be implemented as setSpeed(double) and return bool
+    // Checked variants of the Servo setters, reporting whether the command was accepted
     bool setAngleChecked(double angle);
     bool setSpeedChecked(double speed);
 
   private:
-    void updateAngle();
     bool setAngleImpl(double angle);
     bool setSpeedImpl(double speed);
+    // Setter bodies; the caller holds the engine lock.
+    bool setAngleLocked(double angle);
+    bool setSpeedLocked(double speed);
+    bool stopLocked();
+    bool emergencyStopLocked();
+    // Sets or clears the error flag, replacing the record if one is given; the caller holds the engine lock,
+    // which serialises the stores.
+    void setErrorLocked(bool error, std::optional<ErrorRecord> record);
+
     const std::string id_;
-    std::atomic<double> currentAngle_{90.0};
-    std::atomic<double> currentSpeed_{50.0};
-    std::atomic<double> targetAngle_{90.0};
-    std::atomic<double> targetSpeed_{50.0};
-    std::atomic<double> maxSpeed_{100.0};
-    std::atomic<double> minAngle_{0.0};
-    std::atomic<double> maxAngle_{180.0};
-    std::atomic<bool> isMoving_{false};
-    std::atomic<bool> error_{false};
-    mutable std::mutex errorMutex_;
-    std::string lastError_;
-    std::thread updateThread_;
-    std::atomic<bool> shouldStop_{false};
+    std::unique_ptr<SimulationEngine> ownedEngine_;
+    SimulationEngine *engine_;
+    ServoStateStore &state_;
+    const uint32_t slot_;
+    const Seqlock<ServoReadout> &readout_; // the store's readout for slot_
+    const Seqlock<ServoLimits> &limits_;    // and its limits
     std::atomic<std::chrono::milliseconds> hardwareDelay_{std::chrono::milliseconds{0}};
+    Seqlock<ErrorRecord> lastError_;
 };
 
 } // namespace FingerFlexAid
@@ -0,0 +1,155 @@
+#include "SimulationEngine.hpp"
+#include <algorithm>
+
+namespace FingerFlexAid
+{
+
+SimulationEngine::SimulationEngine(std::chrono::milliseconds tickPeriod) : tickPeriod_(tickPeriod)
+{
+}
+
+SimulationEngine::~SimulationEngine()
+{
+    stop();
+}
+
+size_t SimulationEngine::getDeviceCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return motors_.getLiveCount() + servos_.getLiveCount();
+}
+
+void SimulationEngine::watchEmergencyStop(const EmergencyStop *stop)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop)
+        emergencyStop_.emplace(*stop);
+    else
+        emergencyStop_.reset();
+}
+
+void SimulationEngine::start()
+{
+    if (running_.exchange(true))
+        return;
+    // A thread asked to stop by requestStop() may still be winding down
+    if (thread_.joinable())
+        thread_.join();
+    thread_ = std::jthread([this](std::stop_token token) { run(std::move(token)); });
+}
+
+void SimulationEngine::stop()
+{
+    requestStop();
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void SimulationEngine::requestStop()
+{
+    running_ = false;
+    // The stop callback registered by the tick wait notifies wake_, so the thread leaves it at once
+    thread_.request_stop();
+}
+
+bool SimulationEngine::isRunning() const
+{
+    return running_;
+}
+
+void SimulationEngine::advance(std::chrono::nanoseconds duration)
+{
+    if (running_)
+        return;
+    pendingAdvance_ += duration;
+    while (pendingAdvance_ >= tickPeriod_)
+    {
+        pendingAdvance_ -= tickPeriod_;
+        tick(tickPeriod_);
+    }
+}
+
+std::chrono::nanoseconds SimulationEngine::now() const
+{
+    return simulatedTime_.load();
+}
+
+std::chrono::milliseconds SimulationEngine::getTickPeriod() const
+{
+    return tickPeriod_;
+}
+
+SimulationTickStats SimulationEngine::getTickStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::unique_lock<std::mutex> SimulationEngine::lock() const
+{
+    return std::unique_lock<std::mutex>(mutex_);
+}
+
+MotorStateStore &SimulationEngine::motors()
+{
+    return motors_;
+}
+
+ServoStateStore &SimulationEngine::servos()
+{
+    return servos_;
+}
+
+void SimulationEngine::beginBatch()
+{
+    mutex_.lock();
+}
+
+void SimulationEngine::endBatch()
+{
+    mutex_.unlock();
+}
+
+void SimulationEngine::run(std::stop_token token)
+{
+    using Clock = std::chrono::steady_clock;
+    auto last = Clock::now();
+    auto deadline = last + tickPeriod_;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(waitMutex_);
+            if (wake_.wait_until(lock, token, deadline, [&token] { return token.stop_requested(); }))
+                return;
+        }
+        auto now = Clock::now();
+        tick(now - last);
+        last = now;
+        // Absolute deadlines keep the tick rate from drifting by the cost of each tick.
+        deadline += tickPeriod_;
+        if (deadline < now)
+            deadline = now + tickPeriod_;
+    }
+}
+
+void SimulationEngine::tick(std::chrono::nanoseconds elapsed)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto begin = std::chrono::steady_clock::now();
+    if (emergencyStop_ && emergencyStop_->poll())
+    {
+        motors_.halt();
+        servos_.halt();
+    }
+    motors_.advance(elapsed);
+    servos_.advance(elapsed);
+    auto duration = std::chrono::steady_clock::now() - begin;
+    simulatedTime_.store(simulatedTime_.load() + elapsed);
+
+    ++stats_.ticks;
+    stats_.lastTick = duration;
+    stats_.maxTick = std::max<std::chrono::nanoseconds>(stats_.maxTick, duration);
+    stats_.totalTick += duration;
+}
+
+} // namespace FingerFlexAid
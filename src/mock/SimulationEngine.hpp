@@ -0,0 +1,99 @@
+#pragma once
+
+#include "../core/DeviceCommand.hpp"
+#include "../core/EmergencyStop.hpp"
+#include "ActuatorStore.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+
+namespace FingerFlexAid
+{
+
+struct SimulationTickStats
+{
+    uint64_t ticks = 0;
+    std::chrono::nanoseconds lastTick{0};
+    std::chrono::nanoseconds maxTick{0};
+    std::chrono::nanoseconds totalTick{0};
+
+    std::chrono::nanoseconds meanTick() const
+    {
+        return ticks ? totalTick / static_cast<int64_t>(ticks) : std::chrono::nanoseconds{0};
+    }
+};
+
+// Owns the state of every simulated motor and servo attached to it and integrates all of them once per tick
+// period, either from its own thread (start/stop) or manually through advance(), which runs the same ticks
+// back to back on a virtual clock with no wall-clock waits.
+// MockMotor and MockServo are views onto a slot in the engine's stores; they must be destroyed before it.
+// An engine told to watch an emergency-stop epoch polls it first thing every tick and halts all of its
+// devices if it has moved, so a stop reaches simulated devices within one tick even if nothing commands them
+// directly.
+// As a batch domain the engine holds its lock across a batch, so no tick or reader sees it half applied.
+class SimulationEngine : public BatchDomain
+{
+  public:
+    explicit SimulationEngine(std::chrono::milliseconds tickPeriod = std::chrono::milliseconds(20));
+    ~SimulationEngine() override;
+
+    SimulationEngine(const SimulationEngine &) = delete;
+    SimulationEngine &operator=(const SimulationEngine &) = delete;
+
+    size_t getDeviceCount() const;
+
+    // Polls `stop` every tick from now on, or nothing if null; typically DeviceManagerImpl::getEmergencyStop()
+    // of the manager the engine's devices are registered with. `stop` must outlive the engine or be replaced.
+    void watchEmergencyStop(const EmergencyStop *stop);
+
+    // Starts the engine thread; after stop() or requestStop() it starts a fresh one.
+    void start();
+    // Wakes the engine thread out of its tick wait and joins it.
+    void stop();
+    // Asks the engine thread to finish without waiting for it, so many engines can wind down at once;
+    // stop() or the destructor still joins it.
+    void requestStop();
+    bool isRunning() const;
+
+    // Manual stepping: runs every tick that falls within `duration` of simulated time, carrying any remainder
+    // over to the next call. Must not be used while the engine thread is running.
+    void advance(std::chrono::nanoseconds duration);
+    // Simulated time elapsed since construction: the sum of every tick step handed to the stores.
+    std::chrono::nanoseconds now() const;
+
+    std::chrono::milliseconds getTickPeriod() const;
+    SimulationTickStats getTickStats() const;
+
+    // Device state, for the mock views. Hold lock() while writing the stores; the mocks read their own
+    // readouts instead, which the stores republish, so reads never wait for a tick.
+    std::unique_lock<std::mutex> lock() const;
+    MotorStateStore &motors();
+    ServoStateStore &servos();
+
+    void beginBatch() override;
+    void endBatch() override;
+
+  private:
+    void run(std::stop_token token);
+    void tick(std::chrono::nanoseconds elapsed);
+
+    const std::chrono::milliseconds tickPeriod_;
+    mutable std::mutex mutex_; // guards the stores and stats_; held for the duration of a tick
+    MotorStateStore motors_;
+    ServoStateStore servos_;
+    SimulationTickStats stats_;
+    std::optional<EmergencyStop::Observer> emergencyStop_; // guarded by mutex_
+    std::atomic<std::chrono::nanoseconds> simulatedTime_{std::chrono::nanoseconds{0}};
+    std::chrono::nanoseconds pendingAdvance_{0};
+    std::mutex waitMutex_; // only for the tick wait, so a stop request never contends with a tick
+    std::condition_variable_any wake_;
+    std::jthread thread_;
+    std::atomic<bool> running_{false};
+};
+
+} // namespace FingerFlexAid
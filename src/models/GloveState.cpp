@@ -1,48 +1,103 @@
 #include "models/GloveState.hpp"
 #include <algorithm>
-#include <iostream>
 
 namespace FingerFlexAid
 {
 
-GloveState::GloveState()
+GloveState::GloveState(EventLog &log) : eventLog(log)
 {
 }
 
+GloveState::~GloveState()
+{
+    // The devices may outlive this glove; stop them publishing to its board
+    for (auto [device, index] : subscriptions)
+        device->unsubscribe(status, index);
+}
+
 void GloveState::addMotor(std::shared_ptr<Motor> motor)
 {
     std::lock_guard<std::mutex> lock(mtx);
+    subscribe(motor.get());
     motors.push_back(motor);
+    motorErrors.push_back(0);
 }
 
 void GloveState::addServo(std::shared_ptr<Servo> servo)
 {
     std::lock_guard<std::mutex> lock(mtx);
+    subscribe(servo.get());
     servos.push_back(servo);
+    servoErrors.push_back(0);
+}
+
+void GloveState::subscribe(StatusPublisher *device)
+{
+    size_t index = motors.size() + servos.size();
+    if (index >= kStatusCapacity)
+        overflow = true;
+    else if (device)
+    {
+        device->subscribe(status, static_cast<uint32_t>(index));
+        subscriptions.emplace_back(device, static_cast<uint32_t>(index));
+    }
+}
+
+void GloveState::setRecorder(SessionRecorder *sessionRecorder)
+{
+    recorder = sessionRecorder;
 }
 
 void GloveState::update()
 {
     std::lock_guard<std::mutex> lock(mtx);
-    for (const auto &m : motors)
+    SessionRecorder *session = recorder.load(std::memory_order_acquire);
+    // Errors go to the event log, which never blocks; its drain thread does the formatting and writing. Only
+    // edges are logged, since update() runs every control tick and a lasting fault would flood the log.
+    for (size_t i = 0; i < motors.size(); ++i)
     {
+        const auto &m = motors[i];
         if (m)
         {
             // Poll motor (e.g. update its state if needed)
             // (In a real implementation, you might call a polling or update method on Motor.)
-            if (m->isError())
+            // The published flag, since Motor::isError() is not virtual and a subclass keeps its own
+            const bool error = m->getPublishedError();
+            if (error != static_cast<bool>(motorErrors[i]))
+            {
+                motorErrors[i] = error;
+                if (error)
+                    eventLog.log(LogSource::Motor, static_cast<uint32_t>(i), LogCode::DeviceError,
+                                 static_cast<uint32_t>(m->getErrorRecord().code), m->getTelemetryId());
+                else
+                    eventLog.log(LogSource::Motor, static_cast<uint32_t>(i), LogCode::DeviceRecovered, 0,
+                                 m->getTelemetryId());
+            }
+            if (session)
             {
-                std::cerr << "Motor (" << m->getId() << ") reports error: " << m->getErrorMessage() << std::endl;
+                MotorSnapshot state = m->getSnapshot();
+                session->record(SessionRecord::state(SessionRecordType::MotorState, m->getTelemetryId(), state.speed,
+                                                     state.position, state.moving, state.error));
             }
         }
     }
-    for (const auto &s : servos)
+    for (size_t i = 0; i < servos.size(); ++i)
     {
+        const auto &s = servos[i];
         if (s)
         {
-            if (s->hasError())
+            const bool error = s->getPublishedError();
+            if (error != static_cast<bool>(servoErrors[i]))
+            {
+                servoErrors[i] = error;
+                eventLog.log(LogSource::Servo, static_cast<uint32_t>(i),
+                             error ? LogCode::DeviceError : LogCode::DeviceRecovered, 0, s->getTelemetryId());
+            }
+            if (session)
             {
-                std::cerr << "Servo reports error." << std::endl;
+                ServoSnapshot state = s->getSnapshot();
+                session->record(SessionRecord::state(SessionRecordType::ServoState, s->getTelemetryId(), state.speed,
+                                                     state.angle, state.moving, state.error));
             }
         }
     }
@@ -70,15 +125,20 @@ void GloveState::reset()
 
 bool GloveState::hasError() const
 {
+    if (status.anyError())
+        return true;
+    if (!overflow)
+        return false;
+
     std::lock_guard<std::mutex> lock(mtx);
     for (const auto &m : motors)
     {
-        if (m && m->isError())
+        if (m && m->getPublishedError())
             return true;
     }
     for (const auto &s : servos)
     {
-        if (s && s->hasError())
+        if (s && s->getPublishedError())
             return true;
     }
     return false;
@@ -1,6 +1,10 @@
 #pragma once
+#include "core/DeviceStatus.hpp"
 #include "models/Motor.hpp"
 #include "models/Servo.hpp"
+#include "utils/EventLog.hpp"
+#include "utils/SessionRecording.hpp"
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -11,18 +15,36 @@ namespace FingerFlexAid
 class GloveState
 {
   public:
-    GloveState();
+    // update() reports each device entering or leaving error to `log`, which must outlive the glove.
+    explicit GloveState(EventLog &log = EventLog::shared());
+    ~GloveState();
     void addMotor(std::shared_ptr<Motor> motor);
     void addServo(std::shared_ptr<Servo> servo);
-    void update();         // update all device states
+    void update();         // update all device states, recording them if a recorder is attached
     void reset();          // reset all device states
-    bool hasError() const; // check for any error
+    bool hasError() const; // check for any error; O(1) while every device fits on the status board
                            // (future: add more safety/coordination methods)
+    // Every update() appends each device's state to `recorder` until detached with nullptr; the recorder
+    // must outlive the glove or be detached first.
+    void setRecorder(SessionRecorder *recorder);
 
   private:
+    void subscribe(StatusPublisher *device);
+
+    EventLog &eventLog;
+    std::atomic<SessionRecorder *> recorder{nullptr};
     mutable std::mutex mtx;
     std::vector<std::shared_ptr<Motor>> motors;
     std::vector<std::shared_ptr<Servo>> servos;
+    // Error flags as of the last update(), parallel to motors and servos, so only changes are logged
+    std::vector<uint8_t> motorErrors;
+    std::vector<uint8_t> servoErrors;
+
+    // Devices publish their flags here as they flip, indexed in the order they were added
+    static constexpr size_t kStatusCapacity = 4096;
+    DeviceStatusBoard status{kStatusCapacity};
+    std::vector<std::pair<StatusPublisher *, uint32_t>> subscriptions;
+    std::atomic<bool> overflow{false}; // more devices than the board holds; hasError() also polls
 };
 
 } // namespace FingerFlexAid
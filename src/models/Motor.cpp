@@ -5,9 +5,9 @@ namespace FingerFlexAid
 {
 
 Motor::Motor(const std::string &id, double maxSpeed, double maxTorque)
-    : id_(id), maxSpeed_(maxSpeed), maxTorque_(maxTorque), speed_(0), position_(0), moving_(false), error_(false),
-      errorMsg_("")
+    : id_(id), maxSpeed_(maxSpeed), maxTorque_(maxTorque), speed_(0), position_(0), moving_(false), error_(false)
 {
+    setTelemetryIdentity(TelemetryKind::Motor, id_);
 }
 
 Motor::~Motor() = default;
@@ -19,6 +19,8 @@ void Motor::setSpeed(double speed)
         return;
     speed_ = std::clamp(speed, -maxSpeed_, maxSpeed_);
     moving_ = (speed != 0);
+    publishSnapshot();
+    publishStatus();
 }
 
 double Motor::getSpeed() const
@@ -32,6 +34,7 @@ void Motor::setPosition(double position)
     if (error_)
         return;
     position_ = position;
+    publishSnapshot();
 }
 
 double Motor::getPosition() const
@@ -64,26 +67,51 @@ bool Motor::isError() const
     return error_.load();
 }
 
+MotorSnapshot Motor::getSnapshot() const
+{
+    return snapshot_.load();
+}
+
 std::string Motor::getErrorMessage() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return errorMsg_;
+    return errorRecord_.load().message().value_or("");
+}
+
+ErrorRecord Motor::getErrorRecord() const
+{
+    return errorRecord_.load();
 }
 
 void Motor::clearError()
 {
     std::lock_guard<std::mutex> lock(mutex_);
     error_ = false;
-    errorMsg_.clear();
+    errorRecord_.store({});
+    publishSnapshot();
+    publishStatus();
 }
 
 void Motor::simulateError(const std::string &msg)
 {
     std::lock_guard<std::mutex> lock(mutex_);
     error_ = true;
-    errorMsg_ = msg;
+    errorRecord_.store(ErrorRecord::raise(msg));
     speed_ = 0;
     moving_ = false;
+    publishSnapshot();
+    publishStatus();
+}
+
+void Motor::publishSnapshot()
+{
+    snapshot_.store({speed_, position_, moving_, error_});
+    publishTelemetry(speed_, position_, moving_, error_);
+}
+
+void Motor::publishStatus()
+{
+    publishError(error_);
+    publishMoving(moving_);
 }
 
 } // namespace FingerFlexAid
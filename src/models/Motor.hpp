@@ -1,5 +1,9 @@
 #pragma once
 
+#include "core/DeviceError.hpp"
+#include "core/DeviceStatus.hpp"
+#include "utils/Seqlock.hpp"
+#include "utils/Telemetry.hpp"
 #include <atomic>
 #include <mutex>
 #include <string>
@@ -7,11 +11,20 @@
 namespace FingerFlexAid
 {
 
-class Motor
+// Every state field at one instant, as returned by Motor::getSnapshot().
+struct MotorSnapshot
+{
+    double speed = 0;
+    double position = 0;
+    bool moving = false;
+    bool error = false;
+};
+
+class Motor : public StatusPublisher, public TelemetrySource
 {
   public:
     Motor(const std::string &id, double maxSpeed, double maxTorque);
-    ~Motor();
+    virtual ~Motor();
 
     void setSpeed(double speed);
     double getSpeed() const;
@@ -26,13 +39,26 @@ class Motor
 
     bool isMoving() const;
     bool isError() const;
+    // Consistent view of speed, position and flags; never takes the motor's mutex.
+    virtual MotorSnapshot getSnapshot() const;
+    // Rendered from the error record; empty while there is no error.
     std::string getErrorMessage() const;
+    // Virtual, so a subclass keeping its own record (MockMotor) reports it through a Motor pointer.
+    virtual ErrorRecord getErrorRecord() const;
     void clearError();
 
     // Simulate error for testing
     void simulateError(const std::string &msg);
 
+  protected:
+    // Pushes the error/moving flags to any subscribed status boards after they change. Subclasses whose
+    // state lives elsewhere publish it from there and override this to do nothing.
+    virtual void publishStatus();
+
   private:
+    // Republishes the snapshot and sends it to any attached telemetry ring; the caller holds mutex_.
+    void publishSnapshot();
+
     std::string id_;
     double maxSpeed_;
     double maxTorque_;
@@ -40,8 +66,9 @@ class Motor
     std::atomic<double> position_;
     std::atomic<bool> moving_;
     std::atomic<bool> error_;
-    std::string errorMsg_;
+    Seqlock<ErrorRecord> errorRecord_; // stored under mutex_
     mutable std::mutex mutex_;
+    Seqlock<MotorSnapshot> snapshot_;
 };
 
 } // namespace FingerFlexAid
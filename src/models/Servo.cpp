@@ -8,6 +8,8 @@ ServoImpl::ServoImpl(double minAngle, double maxAngle, double defaultSpeed, cons
     : _minAngle(minAngle), _maxAngle(maxAngle), _currentAngle(minAngle), _currentSpeed(defaultSpeed), _moving(false),
       _simulateError(false), _hasError(false), _name(name)
 {
+    setTelemetryIdentity(TelemetryKind::Servo, _name);
+    publishSnapshot();
 }
 
 void ServoImpl::setAngle(double angle)
@@ -16,17 +18,20 @@ void ServoImpl::setAngle(double angle)
     if (_simulateError)
     {
         _hasError = true;
+        publishSnapshot();
+        publishStatus();
         return;
     }
     double clamped = std::clamp(angle, _minAngle, _maxAngle);
     _currentAngle = clamped;
     _moving = (_currentAngle != angle); // simplistic: moving if clamped
+    publishSnapshot();
+    publishStatus();
 }
 
 double ServoImpl::getAngle() const
 {
-    std::lock_guard<std::mutex> lock(mtx);
-    return _currentAngle;
+    return _snapshot.load().angle;
 }
 
 void ServoImpl::setSpeed(double speed)
@@ -35,16 +40,19 @@ void ServoImpl::setSpeed(double speed)
     if (_simulateError)
     {
         _hasError = true;
+        publishSnapshot();
+        publishStatus();
         return;
     }
     _currentSpeed = std::max(0.0, speed);
     _moving = (_currentSpeed > 0.0);
+    publishSnapshot();
+    publishStatus();
 }
 
 double ServoImpl::getSpeed() const
 {
-    std::lock_guard<std::mutex> lock(mtx);
-    return _currentSpeed;
+    return _snapshot.load().speed;
 }
 
 bool ServoImpl::isMoving() const
@@ -54,9 +62,12 @@ bool ServoImpl::isMoving() const
 
 void ServoImpl::simulateError(bool simulate)
 {
+    std::lock_guard<std::mutex> lock(mtx);
     _simulateError = simulate;
     if (!simulate)
         _hasError = false;
+    publishSnapshot();
+    publishStatus();
 }
 
 bool ServoImpl::hasError() const
@@ -64,4 +75,21 @@ bool ServoImpl::hasError() const
     return _hasError.load();
 }
 
+ServoSnapshot ServoImpl::getSnapshot() const
+{
+    return _snapshot.load();
+}
+
+void ServoImpl::publishSnapshot()
+{
+    _snapshot.store({_currentAngle, _currentSpeed, _moving, _hasError});
+    publishTelemetry(_currentSpeed, _currentAngle, _moving, _hasError);
+}
+
+void ServoImpl::publishStatus()
+{
+    publishError(_hasError);
+    publishMoving(_moving);
+}
+
 } // namespace FingerFlexAid
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "core/DeviceStatus.hpp"
+#include "utils/Seqlock.hpp"
+#include "utils/Telemetry.hpp"
 #include <atomic>
 #include <mutex>
 #include <string>
@@ -7,7 +10,18 @@
 namespace FingerFlexAid
 {
 
-class Servo
+// Every state field at one instant, as returned by Servo::getSnapshot().
+struct ServoSnapshot
+{
+    double angle = 0;
+    double speed = 0;
+    bool moving = false;
+    bool error = false;
+};
+
+// Implementations publish their error/moving flags through the StatusPublisher base as they change, and
+// their full state through the TelemetrySource base.
+class Servo : public StatusPublisher, public TelemetrySource
 {
   public:
     virtual ~Servo() = default;
@@ -18,6 +32,12 @@ class Servo
     virtual bool isMoving() const = 0;
     virtual void simulateError(bool simulate) = 0;
     virtual bool hasError() const = 0;
+    // Implementations that can do better override this; the default reads each field separately, so the
+    // combination may be torn by a concurrent update.
+    virtual ServoSnapshot getSnapshot() const
+    {
+        return {getAngle(), getSpeed(), isMoving(), hasError()};
+    }
 };
 
 class ServoImpl : public Servo
@@ -32,12 +52,19 @@ class ServoImpl : public Servo
     bool isMoving() const override;
     void simulateError(bool simulate) override;
     bool hasError() const override;
+    // Consistent and lock-free; the getters above read from it too.
+    ServoSnapshot getSnapshot() const override;
 
   private:
+    // Both are called with mtx held, which makes this thread the snapshot's single writer
+    void publishSnapshot();
+    void publishStatus();
+
     mutable std::mutex mtx;
     double _minAngle, _maxAngle, _currentAngle, _currentSpeed;
     std::atomic<bool> _moving, _simulateError, _hasError;
     std::string _name;
+    Seqlock<ServoSnapshot> _snapshot;
 };
 
 } // namespace FingerFlexAid
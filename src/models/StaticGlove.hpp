@@ -0,0 +1,174 @@
+#pragma once
+
+#include "models/Motor.hpp"
+#include "models/Servo.hpp"
+#include "utils/EventLog.hpp"
+#include "utils/SessionRecording.hpp"
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <typeinfo>
+#include <utility>
+
+namespace FingerFlexAid
+{
+
+// What StaticGlove calls on a finger's motor: the Motor model API, which MockMotor also provides.
+template <typename T>
+concept GloveMotor = std::derived_from<T, Motor> && requires(T &motor, const T &view, int16_t speed) {
+    motor.setSpeed(speed);
+    motor.clearError();
+    { view.isError() } -> std::convertible_to<bool>;
+    { view.getSnapshot() } -> std::same_as<MotorSnapshot>;
+};
+
+// The same for a finger's servo, through the Servo API.
+template <typename T>
+concept GloveServo = std::derived_from<T, Servo> && requires(T &servo, const T &view, uint16_t angle) {
+    servo.setAngle(angle);
+    { view.hasError() } -> std::convertible_to<bool>;
+    { view.getSnapshot() } -> std::same_as<ServoSnapshot>;
+};
+
+// One finger of a StaticGlove: a motor and a servo of known concrete types, owned by the caller.
+template <GloveMotor M, GloveServo S> struct Finger
+{
+    using MotorType = M;
+    using ServoType = S;
+
+    M &motor;
+    S &servo;
+};
+
+// GloveState for a layout fixed at build time. Each finger's device types are template parameters, and
+// every call names the implementation (motor.M::isError()), so the compiler resolves it statically and can
+// inline it, with no virtual dispatch or shared_ptr in the update and command loops. The constructor
+// checks that each device is exactly its declared type, since a static call would skip a subclass's
+// overrides. Dynamic layouts keep using GloveState and the virtual interfaces.
+//
+// The layout never changes, so there is no lock; callers serialise update(), reset() and command() as
+// they would for a single device.
+template <typename... Fingers> class StaticGlove
+{
+  public:
+    static constexpr size_t kFingers = sizeof...(Fingers);
+
+    // Device errors found by update() are reported to `log`, which must outlive the glove.
+    explicit StaticGlove(EventLog &log, Fingers... fingers) : eventLog_(log), fingers_(fingers...)
+    {
+        forEachFinger([](auto &finger, size_t) {
+            using F = std::remove_reference_t<decltype(finger)>;
+            if (typeid(finger.motor) != typeid(typename F::MotorType) ||
+                typeid(finger.servo) != typeid(typename F::ServoType))
+                throw std::invalid_argument("StaticGlove: a device is not exactly its declared type");
+        });
+    }
+    explicit StaticGlove(Fingers... fingers) : StaticGlove(EventLog::shared(), fingers...)
+    {
+    }
+
+    // As GloveState::update(): logs devices entering or leaving error and records every state if a recorder
+    // is attached.
+    void update()
+    {
+        SessionRecorder *session = recorder_.load(std::memory_order_acquire);
+        forEachFinger([&](auto &finger, size_t index) {
+            using F = std::remove_reference_t<decltype(finger)>;
+            using M = typename F::MotorType;
+            using S = typename F::ServoType;
+            const auto device = static_cast<uint32_t>(index);
+            const bool motorError = finger.motor.M::isError();
+            if (motorError != motorErrors_[index])
+            {
+                motorErrors_[index] = motorError;
+                if (motorError)
+                    eventLog_.log(LogSource::Motor, device, LogCode::DeviceError, errorCode(finger.motor),
+                                  finger.motor.getTelemetryId());
+                else
+                    eventLog_.log(LogSource::Motor, device, LogCode::DeviceRecovered, 0,
+                                  finger.motor.getTelemetryId());
+            }
+            const bool servoError = finger.servo.S::hasError();
+            if (servoError != servoErrors_[index])
+            {
+                servoErrors_[index] = servoError;
+                eventLog_.log(LogSource::Servo, device, servoError ? LogCode::DeviceError : LogCode::DeviceRecovered,
+                              0, finger.servo.getTelemetryId());
+            }
+            if (!session)
+                return;
+            const MotorSnapshot motor = finger.motor.M::getSnapshot();
+            session->record(SessionRecord::state(SessionRecordType::MotorState, finger.motor.getTelemetryId(),
+                                                 motor.speed, motor.position, motor.moving, motor.error));
+            const ServoSnapshot servo = finger.servo.S::getSnapshot();
+            session->record(SessionRecord::state(SessionRecordType::ServoState, finger.servo.getTelemetryId(),
+                                                 servo.speed, servo.angle, servo.moving, servo.error));
+        });
+    }
+
+    // Command loop: one speed and one angle per finger, in finger order.
+    void command(const std::array<int16_t, kFingers> &speeds, const std::array<uint16_t, kFingers> &angles)
+    {
+        forEachFinger([&](auto &finger, size_t index) {
+            using F = std::remove_reference_t<decltype(finger)>;
+            finger.motor.F::MotorType::setSpeed(speeds[index]);
+            finger.servo.F::ServoType::setAngle(angles[index]);
+        });
+    }
+
+    void reset()
+    {
+        forEachFinger([](auto &finger, size_t) {
+            using F = std::remove_reference_t<decltype(finger)>;
+            finger.motor.F::MotorType::clearError();
+        });
+        command({}, {});
+    }
+
+    bool hasError() const
+    {
+        return std::apply([](const auto &...finger) { return (fingerHasError(finger) || ...); }, fingers_);
+    }
+
+    // As GloveState::setRecorder().
+    void setRecorder(SessionRecorder *recorder)
+    {
+        recorder_ = recorder;
+    }
+
+  private:
+    template <typename Visit> void forEachFinger(Visit &&visit)
+    {
+        std::apply([&](auto &...finger) {
+            size_t index = 0;
+            (visit(finger, index++), ...);
+        }, fingers_);
+    }
+
+    template <typename F> static bool fingerHasError(const F &finger)
+    {
+        return finger.motor.F::MotorType::isError() || finger.servo.F::ServoType::hasError();
+    }
+
+    // The motor's own error record where it keeps one (MockMotor), else the Motor model's.
+    template <typename M> static uint32_t errorCode(const M &motor)
+    {
+        if constexpr (requires { motor.M::getLastErrorRecord(); })
+            return static_cast<uint32_t>(motor.M::getLastErrorRecord().code);
+        else
+            return static_cast<uint32_t>(motor.getErrorRecord().code);
+    }
+
+    EventLog &eventLog_;
+    std::atomic<SessionRecorder *> recorder_{nullptr};
+    std::tuple<Fingers...> fingers_;
+    // Error flags as of the last update(), so only changes are logged
+    std::array<bool, kFingers> motorErrors_{};
+    std::array<bool, kFingers> servoErrors_{};
+};
+
+} // namespace FingerFlexAid
@@ -0,0 +1,73 @@
+#include "ByteRing.hpp"
+#include <algorithm>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace FingerFlexAid
+{
+
+ByteRing::ByteRing(size_t capacity)
+{
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    capacity_ = (std::max<size_t>(capacity, 1) + pageSize - 1) / pageSize * pageSize;
+
+    // Reserve twice the capacity, then map the same memory file over both halves
+    int fd = memfd_create("fingerflexaid-ring", MFD_CLOEXEC);
+    if (fd < 0)
+        throw std::bad_alloc();
+    void *reserved = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(capacity_)) == 0)
+        reserved = mmap(nullptr, 2 * capacity_, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    bool mapped = reserved != MAP_FAILED;
+    if (mapped)
+    {
+        auto *base = static_cast<uint8_t *>(reserved);
+        mapped = mmap(base, capacity_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+                 mmap(base + capacity_, capacity_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) !=
+                     MAP_FAILED;
+        if (!mapped)
+            munmap(reserved, 2 * capacity_);
+    }
+    ::close(fd); // the mappings keep the memory alive
+    if (!mapped)
+        throw std::bad_alloc();
+    base_ = static_cast<uint8_t *>(reserved);
+}
+
+ByteRing::~ByteRing()
+{
+    munmap(base_, 2 * capacity_);
+}
+
+std::span<uint8_t> ByteRing::writable()
+{
+    return {base_ + writePos_ % capacity_, capacity_ - size()};
+}
+
+void ByteRing::commit(size_t count)
+{
+    writePos_ += count;
+}
+
+std::span<const uint8_t> ByteRing::readable() const
+{
+    return {base_ + readPos_ % capacity_, size()};
+}
+
+void ByteRing::consume(size_t count)
+{
+    readPos_ += count;
+}
+
+size_t ByteRing::size() const
+{
+    return static_cast<size_t>(writePos_ - readPos_);
+}
+
+size_t ByteRing::capacity() const
+{
+    return capacity_;
+}
+
+} // namespace FingerFlexAid
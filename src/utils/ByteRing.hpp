@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace FingerFlexAid
+{
+
+// Receive buffer for a byte stream. The ring's pages are mapped twice, back to back, so the unread bytes
+// and the free space are each one contiguous span even when they wrap: read() goes straight into
+// writable(), and a frame straddling the end of the ring parses in place from readable(), never copied.
+// Not synchronised; one thread fills and drains it.
+class ByteRing
+{
+  public:
+    // The capacity is rounded up to a whole number of pages. Throws std::bad_alloc if it cannot be mapped.
+    explicit ByteRing(size_t capacity);
+    ~ByteRing();
+
+    ByteRing(const ByteRing &) = delete;
+    ByteRing &operator=(const ByteRing &) = delete;
+
+    std::span<uint8_t> writable();
+    void commit(size_t count); // `count` bytes of writable() now hold data
+    std::span<const uint8_t> readable() const;
+    void consume(size_t count);
+
+    size_t size() const;
+    size_t capacity() const;
+
+  private:
+    uint8_t *base_ = nullptr;
+    size_t capacity_ = 0;
+    uint64_t readPos_ = 0;
+    uint64_t writePos_ = 0;
+};
+
+} // namespace FingerFlexAid
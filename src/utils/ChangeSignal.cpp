@@ -0,0 +1,47 @@
+#include "ChangeSignal.hpp"
+#include <cerrno>
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace FingerFlexAid
+{
+
+void ChangeSignal::signal()
+{
+    counter_.fetch_add(1, std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_seq_cst) != 0)
+        syscall(SYS_futex, &counter_, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+bool ChangeSignal::waitForChange(uint32_t seen, std::chrono::steady_clock::time_point deadline) const
+{
+    // FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC deadline, which is what steady_clock reads
+    const auto since = deadline.time_since_epoch();
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(since);
+    const timespec until{static_cast<time_t>(seconds.count()),
+                         static_cast<long>(std::chrono::nanoseconds(since - seconds).count())};
+
+    waiters_.fetch_add(1, std::memory_order_seq_cst);
+    bool changed;
+    for (;;)
+    {
+        changed = counter_.load(std::memory_order_seq_cst) != seen;
+        if (changed || std::chrono::steady_clock::now() >= deadline)
+            break;
+        // Returns at once if the counter has already moved on, so a racing signal() is not lost
+        const long result =
+            syscall(SYS_futex, &counter_, FUTEX_WAIT_BITSET_PRIVATE, seen, &until, nullptr, FUTEX_BITSET_MATCH_ANY);
+        if (result != 0 && errno == ETIMEDOUT)
+        {
+            changed = counter_.load(std::memory_order_seq_cst) != seen;
+            break;
+        }
+    }
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+    return changed;
+}
+
+} // namespace FingerFlexAid
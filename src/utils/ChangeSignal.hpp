@@ -0,0 +1,30 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace FingerFlexAid
+{
+
+// A counter that threads block on until it moves, on a futex rather than by polling. The pattern is to
+// read value(), check the condition of interest, and only then wait for a change from the value read, so a
+// signal() between the check and the wait is never missed. signal() costs one atomic add and one load
+// while nobody waits; the wake-up system call is made only when someone does.
+class ChangeSignal
+{
+  public:
+    uint32_t value() const
+    {
+        return counter_.load(std::memory_order_acquire);
+    }
+    void signal();
+    // Blocks until the counter differs from `seen` or `deadline` passes; true if it changed.
+    bool waitForChange(uint32_t seen, std::chrono::steady_clock::time_point deadline) const;
+
+  private:
+    mutable std::atomic<uint32_t> counter_{0};
+    mutable std::atomic<uint32_t> waiters_{0};
+};
+
+} // namespace FingerFlexAid
@@ -0,0 +1,198 @@
+#include "EventLog.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+
+namespace FingerFlexAid
+{
+
+namespace
+{
+
+const char *sourceName(LogSource source)
+{
+    switch (source)
+    {
+    case LogSource::System:
+        return "system";
+    case LogSource::Motor:
+        return "motor";
+    case LogSource::Servo:
+        return "servo";
+    }
+    return "unknown";
+}
+
+const char *codeName(LogCode code)
+{
+    switch (code)
+    {
+    case LogCode::DeviceError:
+        return "reports error";
+    case LogCode::DeviceRecovered:
+        return "recovered";
+    case LogCode::EmergencyStop:
+        return "emergency stop";
+    }
+    return "unknown event";
+}
+
+} // namespace
+
+EventLog::EventLog(size_t capacity, Sink sink, std::chrono::milliseconds drainPeriod)
+    : mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1), cells_(std::make_unique<Cell[]>(mask_ + 1)),
+      sink_(std::move(sink)), drainPeriod_(drainPeriod)
+{
+    // Each cell's sequence says whose turn it is: equal to a position, it is free for the producer claiming
+    // that position; one past it, it holds that position's record for the consumer.
+    for (size_t i = 0; i <= mask_; ++i)
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    thread_ = std::thread(&EventLog::run, this);
+}
+
+EventLog::~EventLog()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+bool EventLog::log(LogSource source, uint32_t device, LogCode code, uint32_t detail, std::string_view id)
+{
+    uint64_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;)
+    {
+        cell = &cells_[pos & mask_];
+        uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        auto lag = static_cast<int64_t>(sequence - pos);
+        if (lag == 0)
+        {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (lag < 0)
+        {
+            // The consumer has not freed this cell yet: the ring is full
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->record = LogRecord{std::chrono::steady_clock::now(), device, source, code, detail};
+    // An empty view may carry a null pointer, which memcpy must not be given even for zero bytes
+    if (!id.empty())
+        std::memcpy(cell->record.id, id.data(), std::min(id.size(), LogRecord::kIdLength - 1));
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+void EventLog::flush()
+{
+    const uint64_t target = enqueuePos_.load(std::memory_order_acquire);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        wakeRequested_ = true;
+    }
+    wake_.notify_one();
+    for (uint64_t drained = drained_.load(std::memory_order_acquire); drained < target;
+         drained = drained_.load(std::memory_order_acquire))
+        drained_.wait(drained, std::memory_order_acquire);
+}
+
+uint64_t EventLog::getLoggedCount() const
+{
+    return enqueuePos_.load(std::memory_order_relaxed);
+}
+
+uint64_t EventLog::getDroppedCount() const
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+size_t EventLog::getCapacity() const
+{
+    return mask_ + 1;
+}
+
+std::string EventLog::format(const LogRecord &record)
+{
+    auto micros =
+        std::chrono::duration_cast<std::chrono::microseconds>(record.timestamp.time_since_epoch()).count();
+    const std::string_view id(record.id, strnlen(record.id, LogRecord::kIdLength));
+    char line[160];
+    if (id.empty())
+        std::snprintf(line, sizeof(line), "[%lld.%06lld] %s %u %s (%u)", static_cast<long long>(micros / 1000000),
+                      static_cast<long long>(micros % 1000000), sourceName(record.source), record.device,
+                      codeName(record.code), record.detail);
+    else
+        std::snprintf(line, sizeof(line), "[%lld.%06lld] %s %u \"%.*s\" %s (%u)",
+                      static_cast<long long>(micros / 1000000), static_cast<long long>(micros % 1000000),
+                      sourceName(record.source), record.device, static_cast<int>(id.size()), id.data(),
+                      codeName(record.code), record.detail);
+    return line;
+}
+
+void EventLog::writeToStderr(const LogRecord &record)
+{
+    std::fprintf(stderr, "%s\n", format(record).c_str());
+}
+
+EventLog &EventLog::shared()
+{
+    static EventLog instance;
+    return instance;
+}
+
+bool EventLog::pop(LogRecord &record)
+{
+    const uint64_t pos = dequeuePos_;
+    Cell &cell = cells_[pos & mask_];
+    // A producer may have claimed the position but not finished writing it; pick it up next drain
+    if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+        return false;
+    record = cell.record;
+    cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+    dequeuePos_ = pos + 1;
+    return true;
+}
+
+void EventLog::drain()
+{
+    LogRecord record;
+    bool any = false;
+    while (pop(record))
+    {
+        if (sink_)
+            sink_(record);
+        drained_.store(dequeuePos_, std::memory_order_release);
+        any = true;
+    }
+    if (any)
+        drained_.notify_all();
+}
+
+void EventLog::run()
+{
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    while (!stopping_)
+    {
+        lock.unlock();
+        drain();
+        lock.lock();
+        wake_.wait_for(lock, drainPeriod_, [this] { return stopping_ || wakeRequested_; });
+        wakeRequested_ = false;
+    }
+    lock.unlock();
+    drain();
+}
+
+} // namespace FingerFlexAid
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace FingerFlexAid
+{
+
+enum class LogSource : uint8_t
+{
+    System,
+    Motor,
+    Servo
+};
+
+enum class LogCode : uint16_t
+{
+    DeviceError,
+    DeviceRecovered,
+    EmergencyStop
+};
+
+// One binary log entry. Formatting is left to the sink, off the hot path.
+struct LogRecord
+{
+    static constexpr size_t kIdLength = 24;
+
+    std::chrono::steady_clock::time_point timestamp;
+    uint32_t device = 0; // index or slot of the device within its owner
+    LogSource source = LogSource::System;
+    LogCode code = LogCode::DeviceError;
+    uint32_t detail = 0;      // code-specific argument
+    char id[kIdLength] = {}; // the device's own id, truncated and NUL-padded; empty if none was given
+};
+
+// Asynchronous event log: producers push fixed-size records into a bounded lock-free ring (multi-producer,
+// single-consumer), and a background thread drains it into the sink. log() never blocks or allocates; when
+// the ring is full the record is dropped and counted instead.
+class EventLog
+{
+  public:
+    using Sink = std::function<void(const LogRecord &)>;
+
+    explicit EventLog(size_t capacity = 1024, Sink sink = writeToStderr,
+                      std::chrono::milliseconds drainPeriod = std::chrono::milliseconds(10));
+    // Drains whatever is still queued before returning.
+    ~EventLog();
+
+    EventLog(const EventLog &) = delete;
+    EventLog &operator=(const EventLog &) = delete;
+
+    bool log(LogSource source, uint32_t device, LogCode code, uint32_t detail = 0, std::string_view id = {});
+
+    // Blocks until every record logged before the call has reached the sink.
+    void flush();
+
+    uint64_t getLoggedCount() const;
+    uint64_t getDroppedCount() const;
+    size_t getCapacity() const;
+
+    static std::string format(const LogRecord &record);
+    static void writeToStderr(const LogRecord &record);
+    // Process-wide log writing to stderr, for owners that are not handed one.
+    static EventLog &shared();
+
+  private:
+    struct Cell
+    {
+        std::atomic<uint64_t> sequence;
+        LogRecord record;
+    };
+
+    bool pop(LogRecord &record);
+    void drain();
+    void run();
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<uint64_t> enqueuePos_{0};
+    alignas(64) uint64_t dequeuePos_ = 0; // drain thread only
+    std::atomic<uint64_t> drained_{0};    // records handed to the sink; what flush() waits on
+    std::atomic<uint64_t> dropped_{0};
+
+    Sink sink_;
+    const std::chrono::milliseconds drainPeriod_;
+    std::mutex wakeMutex_; // taken by flush() and the drain thread only, never by log()
+    std::condition_variable wake_;
+    bool wakeRequested_ = false;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace FingerFlexAid
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+
+namespace FingerFlexAid
+{
+
+// Q16.16 fixed point: a signed 32-bit count of 1/65536ths, covering ±32768 with a resolution of about
+// 0.000015. Used for servo angles and speeds in the simulation store and its step kernel; the motor kernel
+// works in whole counts and needs no fractions.
+//
+// Everything except the double conversions is integer arithmetic with fixed rounding, and the header needs
+// nothing beyond <cstdint> and <compare>, so the bridge firmware can build it and step a servo to the same
+// bits as the host.
+struct Fixed
+{
+    static constexpr int kFractionBits = 16;
+    static constexpr int32_t kOne = int32_t{1} << kFractionBits;
+
+    int32_t raw = 0;
+
+    static constexpr Fixed fromRaw(int32_t raw)
+    {
+        return {raw};
+    }
+    static constexpr Fixed fromInt(int32_t value)
+    {
+        return {static_cast<int32_t>(static_cast<uint32_t>(value) << kFractionBits)};
+    }
+    // numerator / denominator, rounded to the nearest step, halves away from zero.
+    static constexpr Fixed fromRatio(int32_t numerator, int32_t denominator)
+    {
+        return {roundedQuotient(static_cast<int64_t>(numerator) * kOne, denominator)};
+    }
+    // Rounds to the nearest step, halves away from zero; host side only. Values beyond the range saturate
+    // to its ends and NaN becomes zero, so no input reaches an out-of-range conversion.
+    static constexpr Fixed fromDouble(double value)
+    {
+        const double scaled = value * kOne;
+        if (!(scaled == scaled))
+            return {0};
+        if (scaled >= static_cast<double>(INT32_MAX))
+            return {INT32_MAX};
+        if (scaled <= static_cast<double>(INT32_MIN))
+            return {INT32_MIN};
+        return {static_cast<int32_t>(scaled < 0 ? scaled - 0.5 : scaled + 0.5)};
+    }
+
+    constexpr double toDouble() const
+    {
+        return static_cast<double>(raw) / kOne;
+    }
+    // Nearest whole number, halves away from zero.
+    constexpr int32_t round() const
+    {
+        return roundedQuotient(raw, kOne);
+    }
+
+    constexpr Fixed operator-() const
+    {
+        return {-raw};
+    }
+    friend constexpr Fixed operator+(Fixed a, Fixed b)
+    {
+        return {a.raw + b.raw};
+    }
+    friend constexpr Fixed operator-(Fixed a, Fixed b)
+    {
+        return {a.raw - b.raw};
+    }
+    // Products and quotients are rounded to the nearest step, halves away from zero.
+    friend constexpr Fixed operator*(Fixed a, Fixed b)
+    {
+        return {roundedQuotient(static_cast<int64_t>(a.raw) * b.raw, kOne)};
+    }
+    friend constexpr Fixed operator/(Fixed a, Fixed b)
+    {
+        return {roundedQuotient(static_cast<int64_t>(a.raw) * kOne, b.raw)};
+    }
+    friend constexpr auto operator<=>(Fixed, Fixed) = default;
+
+    // Found by argument-dependent lookup only, so they never hide the integer overloads
+    friend constexpr Fixed abs(Fixed value)
+    {
+        return value.raw < 0 ? -value : value;
+    }
+    friend constexpr Fixed min(Fixed a, Fixed b)
+    {
+        return b < a ? b : a;
+    }
+    friend constexpr Fixed max(Fixed a, Fixed b)
+    {
+        return a < b ? b : a;
+    }
+
+  private:
+    static constexpr int32_t roundedQuotient(int64_t numerator, int64_t denominator)
+    {
+        if (denominator < 0)
+        {
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+        const int64_t half = denominator / 2;
+        return static_cast<int32_t>((numerator < 0 ? numerator - half : numerator + half) / denominator);
+    }
+};
+
+// sin of an angle in degrees, for angles in [0, 180]; others are clamped into it. Bhaskara I's rational
+// approximation, within 0.0017 of the true value, in integer arithmetic only.
+constexpr Fixed sinDegrees(Fixed degrees)
+{
+    constexpr int64_t kHalfTurn = int64_t{180} * Fixed::kOne;
+    const int64_t x = degrees.raw < 0 ? 0 : degrees.raw > kHalfTurn ? kHalfTurn : degrees.raw;
+    // x(180 - x) peaks at 8100, so every intermediate below fits comfortably in 64 bits
+    const int64_t product = x * (kHalfTurn - x) / Fixed::kOne;
+    const int64_t denominator = int64_t{40500} * Fixed::kOne - product;
+    return Fixed::fromRaw(static_cast<int32_t>((4 * product * Fixed::kOne + denominator / 2) / denominator));
+}
+
+} // namespace FingerFlexAid
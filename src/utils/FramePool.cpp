@@ -0,0 +1,81 @@
+#include "FramePool.hpp"
+#include <new>
+
+namespace FingerFlexAid
+{
+
+namespace
+{
+
+constexpr std::align_val_t kChunkAlignment{FramePool::kGranularity};
+
+} // namespace
+
+FramePool::~FramePool()
+{
+    for (void *chunk : chunks_)
+        ::operator delete(chunk, kChunkAlignment);
+}
+
+FramePool &FramePool::shared()
+{
+    // Never destroyed, so frames of coroutines still alive during static destruction stay valid
+    static FramePool *instance = new FramePool();
+    return *instance;
+}
+
+void *FramePool::allocate(size_t size)
+{
+    const size_t sizeClass = (size + kGranularity - 1) / kGranularity - 1;
+    if (size == 0 || sizeClass >= kClasses)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        ++stats_.allocations;
+        ++stats_.oversized;
+        return ::operator new(size);
+    }
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    ++stats_.allocations;
+    if (FreeFrame *frame = free_[sizeClass])
+    {
+        free_[sizeClass] = frame->next;
+        ++stats_.reused;
+        return frame;
+    }
+
+    // Carve a fresh chunk for this class: hand out the first frame, free-list the rest
+    const size_t frameBytes = (sizeClass + 1) * kGranularity;
+    auto *chunk = static_cast<std::byte *>(::operator new(frameBytes * kChunkFrames, kChunkAlignment));
+    chunks_.push_back(chunk);
+    stats_.reservedBytes += frameBytes * kChunkFrames;
+    for (size_t i = kChunkFrames - 1; i > 0; --i)
+    {
+        auto *frame = reinterpret_cast<FreeFrame *>(chunk + i * frameBytes);
+        frame->next = free_[sizeClass];
+        free_[sizeClass] = frame;
+    }
+    return chunk;
+}
+
+void FramePool::deallocate(void *frame, size_t size)
+{
+    const size_t sizeClass = (size + kGranularity - 1) / kGranularity - 1;
+    if (size == 0 || sizeClass >= kClasses)
+    {
+        ::operator delete(frame);
+        return;
+    }
+    auto *freed = static_cast<FreeFrame *>(frame);
+    std::lock_guard<std::mutex> lock(mtx_);
+    freed->next = free_[sizeClass];
+    free_[sizeClass] = freed;
+}
+
+FramePoolStats FramePool::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return stats_;
+}
+
+} // namespace FingerFlexAid
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace FingerFlexAid
+{
+
+struct FramePoolStats
+{
+    uint64_t allocations = 0;
+    uint64_t reused = 0;    // served from a free list rather than fresh chunk space
+    uint64_t oversized = 0; // too large for the pool; went to the global allocator
+    size_t reservedBytes = 0;
+};
+
+// Size-class pool for coroutine frames. Frames are rounded up to a multiple of 64 bytes and carved out of
+// 64-frame chunks; a freed frame goes on its class's free list, so a script scheduler spawning the same
+// few coroutine types over and over stops touching the global allocator once warmed up. Memory is kept
+// for reuse until the pool is destroyed. Thread-safe; allocation and release take one short lock.
+class FramePool
+{
+  public:
+    static constexpr size_t kGranularity = 64;
+    static constexpr size_t kClasses = 32; // frames up to 2 KiB; larger ones bypass the pool
+    static constexpr size_t kChunkFrames = 64;
+
+    FramePool() = default;
+    ~FramePool();
+
+    FramePool(const FramePool &) = delete;
+    FramePool &operator=(const FramePool &) = delete;
+
+    // The pool coroutine promises allocate from.
+    static FramePool &shared();
+
+    void *allocate(size_t size);
+    // `size` must be the size passed to allocate().
+    void deallocate(void *frame, size_t size);
+
+    FramePoolStats getStats() const;
+
+  private:
+    struct FreeFrame
+    {
+        FreeFrame *next;
+    };
+
+    mutable std::mutex mtx_;
+    std::array<FreeFrame *, kClasses> free_{};
+    std::vector<void *> chunks_;
+    FramePoolStats stats_;
+};
+
+} // namespace FingerFlexAid
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace FingerFlexAid
+{
+
+template <typename Signature> class FunctionRef;
+
+// Non-owning reference to a callable, for callbacks that run only during the call they are passed to, such
+// as visitors across a virtual interface. Unlike std::function it never allocates and is two pointers wide;
+// the callable must outlive the reference.
+template <typename R, typename... Args> class FunctionRef<R(Args...)>
+{
+  public:
+    template <typename F>
+        requires(!std::is_same_v<std::remove_cvref_t<F>, FunctionRef> && std::is_invocable_r_v<R, F &, Args...>)
+    FunctionRef(F &&f) noexcept
+        : object_(const_cast<void *>(static_cast<const void *>(std::addressof(f)))),
+          call_([](void *object, Args... args) -> R {
+              return (*static_cast<std::add_pointer_t<std::remove_reference_t<F>>>(object))(
+                  std::forward<Args>(args)...);
+          })
+    {
+    }
+
+    R operator()(Args... args) const
+    {
+        return call_(object_, std::forward<Args>(args)...);
+    }
+
+  private:
+    void *object_;
+    R (*call_)(void *, Args...);
+};
+
+} // namespace FingerFlexAid
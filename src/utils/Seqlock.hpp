@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace FingerFlexAid
+{
+
+// Sequence lock publishing a small trivially copyable value from one writer to any number of readers.
+// Readers never block the writer or each other: they copy the value and retry only if a store overlapped
+// the copy. Concurrent store() calls must be serialised by the caller, typically under the owner's mutex.
+//
+// The value is kept as relaxed atomic words rather than plain memory, so overlapping reads and writes are
+// not data races; the fences order the words against the sequence counter.
+template <typename T> class Seqlock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock values are copied word by word");
+    static_assert(std::is_default_constructible_v<T>);
+
+  public:
+    Seqlock() : Seqlock(T{})
+    {
+    }
+
+    explicit Seqlock(const T &value)
+    {
+        store(value);
+    }
+
+    Seqlock(const Seqlock &) = delete;
+    Seqlock &operator=(const Seqlock &) = delete;
+
+    T load() const
+    {
+        Words words;
+        uint64_t before;
+        uint64_t after;
+        do
+        {
+            before = sequence_.load(std::memory_order_acquire);
+            if (before & 1)
+            {
+                // A store is in progress; let the writer finish rather than spin through its time slice
+                std::this_thread::yield();
+                after = before;
+                continue;
+            }
+            for (size_t i = 0; i < kWords; ++i)
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence_.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+
+        T value;
+        std::memcpy(static_cast<void *>(&value), words.data(), sizeof(T));
+        return value;
+    }
+
+    void store(const T &value)
+    {
+        Words words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+        uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i)
+            words_[i].store(words[i], std::memory_order_relaxed);
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Number of completed stores, including the initial one.
+    uint64_t version() const
+    {
+        return sequence_.load(std::memory_order_acquire) / 2;
+    }
+
+  private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    using Words = std::array<uint64_t, kWords>;
+
+    std::atomic<uint64_t> sequence_{0};
+    std::array<std::atomic<uint64_t>, kWords> words_{};
+};
+
+} // namespace FingerFlexAid
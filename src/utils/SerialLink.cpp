@@ -0,0 +1,213 @@
+#include "SerialLink.hpp"
+#include "ByteRing.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace FingerFlexAid
+{
+
+namespace
+{
+
+constexpr size_t kReceiveRingBytes = 64 * 1024;
+
+} // namespace
+
+bool writeFully(int fd, std::span<const uint8_t> bytes)
+{
+    while (!bytes.empty())
+    {
+        ssize_t written = ::send(fd, bytes.data(), bytes.size(), MSG_NOSIGNAL);
+        if (written < 0 && errno == ENOTSOCK)
+            written = ::write(fd, bytes.data(), bytes.size());
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        bytes = bytes.subspan(static_cast<size_t>(written));
+    }
+    return true;
+}
+
+std::unique_ptr<SerialLink> SerialLink::open(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (fd < 0)
+        return nullptr;
+    termios settings;
+    if (isatty(fd) && tcgetattr(fd, &settings) == 0)
+    {
+        cfmakeraw(&settings);
+        settings.c_cc[VMIN] = 1;
+        settings.c_cc[VTIME] = 0;
+        tcsetattr(fd, TCSANOW, &settings);
+    }
+    return adopt(fd);
+}
+
+std::unique_ptr<SerialLink> SerialLink::adopt(int fd)
+{
+    // Without the eventfd the destructor could never wake the receive thread to join it
+    int wakeFd = eventfd(0, EFD_CLOEXEC);
+    if (wakeFd < 0)
+    {
+        ::close(fd);
+        return nullptr;
+    }
+    return std::unique_ptr<SerialLink>(new SerialLink(fd, wakeFd));
+}
+
+SerialLink::SerialLink(int fd, int wakeFd) : fd_(fd), wakeFd_(wakeFd)
+{
+    thread_ = std::thread(&SerialLink::run, this);
+}
+
+SerialLink::~SerialLink()
+{
+    uint64_t one = 1;
+    if (::write(wakeFd_, &one, sizeof(one)) != sizeof(one))
+    {
+        // The eventfd cannot be full after a single write; the thread wakes regardless
+    }
+    thread_.join();
+    ::close(wakeFd_);
+    ::close(fd_);
+}
+
+bool SerialLink::transact(FrameWriter &request, void (*handler)(const FrameView &, void *), void *context,
+                          std::chrono::milliseconds timeout)
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::unique_lock<std::mutex> lock(mtx_);
+    // Claim the next free sequence number; all 256 in flight is the only reason to wait
+    size_t sequence = pending_.size();
+    while (sequence == pending_.size())
+    {
+        if (!connected_.load(std::memory_order_acquire))
+            return false;
+        for (size_t i = 0; i < pending_.size(); ++i)
+        {
+            const uint8_t candidate = static_cast<uint8_t>(nextSequence_ + i);
+            if (!pending_[candidate].active)
+            {
+                sequence = candidate;
+                break;
+            }
+        }
+        if (sequence == pending_.size() && responded_.wait_until(lock, deadline) == std::cv_status::timeout)
+        {
+            timeouts_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    nextSequence_ = static_cast<uint8_t>(sequence + 1);
+    Pending &pending = pending_[sequence];
+    pending = Pending{handler, context, true, false};
+    lock.unlock();
+
+    bool sent;
+    {
+        std::lock_guard<std::mutex> writeLock(writeMutex_);
+        sent = writeFully(fd_, request.finish(static_cast<uint8_t>(sequence)));
+    }
+    framesSent_.fetch_add(sent, std::memory_order_relaxed);
+
+    lock.lock();
+    const bool done = sent && responded_.wait_until(lock, deadline, [&] {
+        return pending.done || !connected_.load(std::memory_order_acquire);
+    }) && pending.done;
+    if (sent && !done)
+        timeouts_.fetch_add(1, std::memory_order_relaxed);
+    pending.active = false;
+    responded_.notify_all(); // a sequence number is free again
+    return done;
+}
+
+bool SerialLink::isConnected() const
+{
+    return connected_.load(std::memory_order_acquire);
+}
+
+SerialLinkStats SerialLink::getStats() const
+{
+    SerialLinkStats stats;
+    stats.framesSent = framesSent_.load(std::memory_order_relaxed);
+    stats.framesReceived = framesReceived_.load(std::memory_order_relaxed);
+    stats.bytesDiscarded = bytesDiscarded_.load(std::memory_order_relaxed);
+    stats.unmatched = unmatched_.load(std::memory_order_relaxed);
+    stats.timeouts = timeouts_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SerialLink::run()
+{
+    ByteRing ring(kReceiveRingBytes);
+    pollfd fds[2] = {{fd_, POLLIN, 0}, {wakeFd_, POLLIN, 0}};
+    for (;;)
+    {
+        if (::poll(fds, 2, -1) < 0 && errno != EINTR)
+            break;
+        if (fds[1].revents)
+            break;
+        if (!fds[0].revents)
+            continue;
+
+        auto space = ring.writable();
+        const ssize_t count = ::read(fd_, space.data(), space.size());
+        if (count < 0 && (errno == EINTR || errno == EAGAIN))
+            continue;
+        if (count <= 0)
+            break; // closed, or the pty's other side hung up
+        ring.commit(static_cast<size_t>(count));
+
+        for (;;)
+        {
+            FrameView frame;
+            size_t consumed = 0;
+            const ParseStatus status = parseFrame(ring.readable(), frame, consumed);
+            if (status == ParseStatus::Frame)
+            {
+                framesReceived_.fetch_add(1, std::memory_order_relaxed);
+                dispatch(frame);
+            }
+            else
+                bytesDiscarded_.fetch_add(consumed, std::memory_order_relaxed);
+            ring.consume(consumed);
+            if (status == ParseStatus::Incomplete)
+                break;
+        }
+        // A full ring that still holds no complete frame can only be garbage
+        if (ring.size() == ring.capacity())
+        {
+            bytesDiscarded_.fetch_add(ring.size(), std::memory_order_relaxed);
+            ring.consume(ring.size());
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    connected_.store(false, std::memory_order_release);
+    responded_.notify_all();
+}
+
+void SerialLink::dispatch(const FrameView &frame)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    Pending &pending = pending_[frame.sequence];
+    if (frame.type != FrameType::Response || !pending.active || pending.done)
+    {
+        unmatched_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    pending.handler(frame, pending.context);
+    pending.done = true;
+    responded_.notify_all();
+}
+
+} // namespace FingerFlexAid
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "SerialProtocol.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+namespace FingerFlexAid
+{
+
+struct SerialLinkStats
+{
+    uint64_t framesSent = 0;
+    uint64_t framesReceived = 0;
+    uint64_t bytesDiscarded = 0; // line noise and corrupt frames skipped while resynchronising
+    uint64_t unmatched = 0;      // responses nobody was waiting for, e.g. after a timeout
+    uint64_t timeouts = 0;
+};
+
+// Writes all of `bytes`, retrying short writes; false on error. Never raises SIGPIPE on sockets.
+bool writeFully(int fd, std::span<const uint8_t> bytes);
+
+// Request/response transport for the serial protocol over a file descriptor: a serial port, the slave side
+// of a pseudo-terminal, or a socket. A receive thread reads into a ByteRing and parses frames in place;
+// each response is matched to its request by sequence number, so up to 256 requests may be in flight from
+// any number of threads.
+class SerialLink
+{
+  public:
+    static constexpr std::chrono::milliseconds kDefaultTimeout{200};
+
+    // Opens a tty (or pty slave) and puts it in raw mode. Null if it cannot be opened.
+    static std::unique_ptr<SerialLink> open(const std::string &path);
+    // Takes ownership of an open, connected descriptor, closing it if the link cannot be set up. Null then.
+    static std::unique_ptr<SerialLink> adopt(int fd);
+    ~SerialLink();
+
+    SerialLink(const SerialLink &) = delete;
+    SerialLink &operator=(const SerialLink &) = delete;
+
+    // Sends `request` under a fresh sequence number and waits for the response. `handler` is called with
+    // the response on the receive thread, while the frame still sits in the receive ring, and must neither
+    // block nor use the link. False on timeout or if the link is down.
+    template <typename Handler>
+    bool transact(FrameWriter &request, Handler &&handler, std::chrono::milliseconds timeout = kDefaultTimeout)
+    {
+        using Callable = std::remove_reference_t<Handler>;
+        return transact(
+            request, [](const FrameView &frame, void *context) { (*static_cast<Callable *>(context))(frame); },
+            &handler, timeout);
+    }
+    bool transact(FrameWriter &request, void (*handler)(const FrameView &, void *), void *context,
+                  std::chrono::milliseconds timeout);
+
+    // False once the other end has closed or the descriptor failed.
+    bool isConnected() const;
+    SerialLinkStats getStats() const;
+
+  private:
+    SerialLink(int fd, int wakeFd);
+
+    struct Pending
+    {
+        void (*handler)(const FrameView &, void *) = nullptr;
+        void *context = nullptr;
+        bool active = false;
+        bool done = false;
+    };
+
+    void run();
+    void dispatch(const FrameView &frame);
+
+    const int fd_;
+    const int wakeFd_; // stops the receive thread
+    std::atomic<bool> connected_{true};
+
+    std::mutex writeMutex_;
+    mutable std::mutex mtx_; // guards pending_ and nextSequence_
+    std::condition_variable responded_;
+    std::array<Pending, 256> pending_;
+    uint8_t nextSequence_ = 0;
+
+    std::atomic<uint64_t> framesSent_{0};
+    std::atomic<uint64_t> framesReceived_{0};
+    std::atomic<uint64_t> bytesDiscarded_{0};
+    std::atomic<uint64_t> unmatched_{0};
+    std::atomic<uint64_t> timeouts_{0};
+
+    std::thread thread_;
+};
+
+} // namespace FingerFlexAid
@@ -0,0 +1,258 @@
+#include "SerialProtocol.hpp"
+#include <algorithm>
+
+namespace FingerFlexAid
+{
+
+namespace
+{
+
+constexpr std::array<uint16_t, 256> makeCrcTable()
+{
+    std::array<uint16_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint16_t crc = static_cast<uint16_t>(i << 8);
+        for (int bit = 0; bit < 8; ++bit)
+            crc = static_cast<uint16_t>(crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1);
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<uint16_t, 256> kCrcTable = makeCrcTable();
+
+void put16(uint8_t *out, uint16_t value)
+{
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void put32(uint8_t *out, uint32_t value)
+{
+    put16(out, static_cast<uint16_t>(value));
+    put16(out + 2, static_cast<uint16_t>(value >> 16));
+}
+
+uint16_t get16(const uint8_t *in)
+{
+    return static_cast<uint16_t>(in[0] | in[1] << 8);
+}
+
+uint32_t get32(const uint8_t *in)
+{
+    return get16(in) | static_cast<uint32_t>(get16(in + 2)) << 16;
+}
+
+constexpr uint8_t kMoving = 0x01;
+constexpr uint8_t kError = 0x02;
+
+// Commands carrying a MotorController/ServoController argument
+bool hasValue(RecordType type)
+{
+    return type < RecordType::Ack && recordBodySize(type) == 4;
+}
+
+uint8_t flags(bool moving, bool error)
+{
+    return static_cast<uint8_t>((moving ? kMoving : 0) | (error ? kError : 0));
+}
+
+} // namespace
+
+uint16_t crc16(std::span<const uint8_t> data, uint16_t crc)
+{
+    for (uint8_t byte : data)
+        crc = static_cast<uint16_t>(crc << 8) ^ kCrcTable[static_cast<uint8_t>(crc >> 8) ^ byte];
+    return crc;
+}
+
+int recordBodySize(RecordType type)
+{
+    switch (type)
+    {
+    case RecordType::MotorSetSpeed:
+    case RecordType::MotorSetPosition:
+    case RecordType::MotorSetMaxSpeed:
+    case RecordType::MotorSetAcceleration:
+    case RecordType::ServoSetAngle:
+    case RecordType::ServoSetSpeed:
+    case RecordType::ServoSetAngleLimits:
+    case RecordType::ServoSetMaxSpeed:
+        return 4;
+    case RecordType::MotorStop:
+    case RecordType::MotorEmergencyStop:
+    case RecordType::MotorRead:
+    case RecordType::ServoStop:
+    case RecordType::ServoEmergencyStop:
+    case RecordType::ServoRead:
+        return 0;
+    case RecordType::Ack:
+        return 1;
+    case RecordType::MotorState:
+        return 7; // speed i16, position i32, flags
+    case RecordType::ServoState:
+        return 4; // angle u16, speed u8, flags
+    }
+    return -1;
+}
+
+void FrameWriter::begin(FrameType type)
+{
+    buffer_[0] = kFrameSync[0];
+    buffer_[1] = kFrameSync[1];
+    buffer_[2] = static_cast<uint8_t>(type);
+    size_ = kFrameHeaderSize;
+    records_ = 0;
+}
+
+uint8_t *FrameWriter::reserve(RecordType type, uint8_t device)
+{
+    const int bodySize = recordBodySize(type);
+    const size_t size = 2 + static_cast<size_t>(bodySize);
+    if (bodySize < 0 || size_ + size > kFrameHeaderSize + kMaxPayload)
+        return nullptr;
+    uint8_t *record = buffer_.data() + size_;
+    record[0] = static_cast<uint8_t>(type);
+    record[1] = device;
+    size_ += size;
+    ++records_;
+    return record + 2;
+}
+
+bool FrameWriter::add(RecordType type, uint8_t device, int32_t value)
+{
+    uint8_t *body = reserve(type, device);
+    if (!body)
+        return false;
+    if (hasValue(type))
+        put32(body, static_cast<uint32_t>(value));
+    else if (type == RecordType::Ack)
+        body[0] = static_cast<uint8_t>(value);
+    return true;
+}
+
+bool FrameWriter::addAck(uint8_t device, bool applied)
+{
+    return add(RecordType::Ack, device, applied ? 1 : 0);
+}
+
+bool FrameWriter::addMotorState(uint8_t device, const MotorReading &reading)
+{
+    uint8_t *body = reserve(RecordType::MotorState, device);
+    if (!body)
+        return false;
+    put16(body, static_cast<uint16_t>(reading.speed));
+    put32(body + 2, static_cast<uint32_t>(reading.position));
+    body[6] = flags(reading.moving, reading.error);
+    return true;
+}
+
+bool FrameWriter::addServoState(uint8_t device, const ServoReading &reading)
+{
+    uint8_t *body = reserve(RecordType::ServoState, device);
+    if (!body)
+        return false;
+    put16(body, reading.angle);
+    body[2] = reading.speed;
+    body[3] = flags(reading.moving, reading.error);
+    return true;
+}
+
+std::span<const uint8_t> FrameWriter::finish(uint8_t sequence)
+{
+    buffer_[3] = sequence;
+    put16(buffer_.data() + 4, static_cast<uint16_t>(size_ - kFrameHeaderSize));
+    put16(buffer_.data() + size_, crc16(std::span<const uint8_t>(buffer_.data() + 2, size_ - 2)));
+    return {buffer_.data(), size_ + kFrameTrailerSize};
+}
+
+size_t FrameWriter::getRecordCount() const
+{
+    return records_;
+}
+
+size_t FrameWriter::getPayloadSize() const
+{
+    return size_ - kFrameHeaderSize;
+}
+
+ParseStatus parseFrame(std::span<const uint8_t> bytes, FrameView &frame, size_t &consumed)
+{
+    // Anything before the first possible sync is noise; a lone 0xA5 at the end may be the start of one
+    const uint8_t *begin = bytes.data();
+    const uint8_t *sync = std::find(begin, begin + bytes.size(), kFrameSync[0]);
+    consumed = static_cast<size_t>(sync - begin);
+    if (consumed > 0)
+        return ParseStatus::Invalid;
+    const size_t available = bytes.size();
+    if (available < 2)
+        return ParseStatus::Incomplete;
+    if (sync[1] != kFrameSync[1])
+    {
+        consumed = 1;
+        return ParseStatus::Invalid;
+    }
+    if (available < kFrameHeaderSize)
+        return ParseStatus::Incomplete;
+
+    const size_t length = get16(sync + 4);
+    if (length > kMaxPayload)
+    {
+        consumed = 1;
+        return ParseStatus::Invalid;
+    }
+    const size_t total = kFrameHeaderSize + length + kFrameTrailerSize;
+    if (available < total)
+        return ParseStatus::Incomplete;
+    if (crc16(std::span<const uint8_t>(sync + 2, kFrameHeaderSize - 2 + length)) !=
+        get16(sync + kFrameHeaderSize + length))
+    {
+        // Only the sync is known bad: the real next frame may start inside this one
+        consumed = 1;
+        return ParseStatus::Invalid;
+    }
+
+    frame.type = static_cast<FrameType>(sync[2]);
+    frame.sequence = sync[3];
+    frame.payload = std::span<const uint8_t>(sync + kFrameHeaderSize, length);
+    consumed = total;
+    return ParseStatus::Frame;
+}
+
+bool RecordReader::next(Record &record)
+{
+    if (malformed_ || offset_ >= payload_.size())
+        return false;
+    if (payload_.size() - offset_ < 2)
+    {
+        malformed_ = true;
+        return false;
+    }
+    const uint8_t *data = payload_.data() + offset_;
+    const auto type = static_cast<RecordType>(data[0]);
+    const int bodySize = recordBodySize(type);
+    if (bodySize < 0 || payload_.size() - offset_ - 2 < static_cast<size_t>(bodySize))
+    {
+        malformed_ = true;
+        return false;
+    }
+
+    record.type = type;
+    record.device = data[1];
+    record.value = 0;
+    const uint8_t *body = data + 2;
+    if (hasValue(type))
+        record.value = static_cast<int32_t>(get32(body));
+    else if (type == RecordType::Ack)
+        record.value = body[0];
+    else if (type == RecordType::MotorState)
+        record.motor = {static_cast<int16_t>(get16(body)), static_cast<int32_t>(get32(body + 2)),
+                        (body[6] & kMoving) != 0, (body[6] & kError) != 0};
+    else if (type == RecordType::ServoState)
+        record.servo = {get16(body), body[2], (body[3] & kMoving) != 0, (body[3] & kError) != 0};
+    offset_ += 2 + static_cast<size_t>(bodySize);
+    return true;
+}
+
+} // namespace FingerFlexAid
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace FingerFlexAid
+{
+
+// Wire format between the host and the ESP32 bridge. Every frame is
+//
+//     0xA5 0x5A | type u8 | sequence u8 | payload length u16 | payload | CRC-16 u16
+//
+// little-endian, with the CRC (CCITT-FALSE) covering type through payload. The payload is a run of
+// records, each a type byte and a device index followed by a body whose size the type fixes, so one frame
+// carries any mix of commands to, or readings from, every device on the bridge. A response echoes its
+// request's sequence number and answers its records in order: an Ack per command, a state record per read.
+
+// CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF. Pass a previous result to continue it.
+uint16_t crc16(std::span<const uint8_t> data, uint16_t crc = 0xFFFF);
+
+enum class FrameType : uint8_t
+{
+    Request = 1,
+    Response = 2
+};
+
+enum class RecordType : uint8_t
+{
+    // Host to bridge; the value is the MotorController/ServoController argument
+    MotorSetSpeed = 0x01,
+    MotorSetPosition,
+    MotorStop,
+    MotorEmergencyStop,
+    MotorSetMaxSpeed,
+    MotorSetAcceleration,
+    MotorRead,
+    ServoSetAngle = 0x11,
+    ServoSetSpeed,
+    ServoStop,
+    ServoEmergencyStop,
+    ServoSetAngleLimits, // minimum angle in the low 16 bits, maximum in the high 16
+    ServoSetMaxSpeed,
+    ServoRead,
+    // Bridge to host
+    Ack = 0x80, // value 1 if the command was applied, 0 if the device rejected it
+    MotorState,
+    ServoState
+};
+
+struct MotorReading
+{
+    int16_t speed = 0;
+    int32_t position = 0;
+    bool moving = false;
+    bool error = false;
+};
+
+struct ServoReading
+{
+    uint16_t angle = 0;
+    uint8_t speed = 0;
+    bool moving = false;
+    bool error = false;
+};
+
+// One decoded record. Only the fields for its type are meaningful.
+struct Record
+{
+    RecordType type = RecordType::Ack;
+    uint8_t device = 0;
+    int32_t value = 0;
+    MotorReading motor;
+    ServoReading servo;
+};
+
+constexpr uint8_t kFrameSync[2] = {0xA5, 0x5A};
+constexpr size_t kFrameHeaderSize = 6;
+constexpr size_t kFrameTrailerSize = 2;
+constexpr size_t kMaxPayload = 1024;
+constexpr size_t kMaxFrameSize = kFrameHeaderSize + kMaxPayload + kFrameTrailerSize;
+
+// Size of a record's body for `type`; -1 for unknown types.
+int recordBodySize(RecordType type);
+
+// Builds one frame in place. add*() return false, adding nothing, once the payload is full.
+class FrameWriter
+{
+  public:
+    void begin(FrameType type);
+    bool add(RecordType type, uint8_t device, int32_t value = 0);
+    bool addAck(uint8_t device, bool applied);
+    bool addMotorState(uint8_t device, const MotorReading &reading);
+    bool addServoState(uint8_t device, const ServoReading &reading);
+    // Stamps the sequence number, length and CRC; the frame stays valid until the next begin().
+    std::span<const uint8_t> finish(uint8_t sequence);
+
+    size_t getRecordCount() const;
+    size_t getPayloadSize() const;
+
+  private:
+    uint8_t *reserve(RecordType type, uint8_t device);
+
+    std::array<uint8_t, kMaxFrameSize> buffer_{};
+    size_t size_ = kFrameHeaderSize;
+    size_t records_ = 0;
+};
+
+// A parsed frame; the payload points into the bytes it was parsed from.
+struct FrameView
+{
+    FrameType type = FrameType::Request;
+    uint8_t sequence = 0;
+    std::span<const uint8_t> payload;
+};
+
+enum class ParseStatus
+{
+    Frame,      // `frame` is valid and `consumed` bytes long; drop them once done with it
+    Incomplete, // a frame has started but not arrived in full; wait for more bytes
+    Invalid     // noise, a stray sync or a corrupt frame; drop `consumed` bytes to resynchronise
+};
+
+// Parses the frame at the start of `bytes` without copying it.
+ParseStatus parseFrame(std::span<const uint8_t> bytes, FrameView &frame, size_t &consumed);
+
+// Walks the records of a payload in place.
+class RecordReader
+{
+  public:
+    explicit RecordReader(std::span<const uint8_t> payload) : payload_(payload)
+    {
+    }
+
+    // False at the end of the payload or at a malformed record (see isMalformed()).
+    bool next(Record &record);
+    bool isMalformed() const
+    {
+        return malformed_;
+    }
+
+  private:
+    std::span<const uint8_t> payload_;
+    size_t offset_ = 0;
+    bool malformed_ = false;
+};
+
+} // namespace FingerFlexAid
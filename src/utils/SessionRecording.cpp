@@ -0,0 +1,306 @@
+#include "SessionRecording.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace FingerFlexAid
+{
+
+namespace
+{
+
+constexpr char kMagic[8] = {'F', 'F', 'A', 'S', 'E', 'S', 'S', '\0'};
+constexpr uint32_t kFormatVersion = 1;
+constexpr size_t kChunkBytes = size_t{16} << 20;
+constexpr size_t kChunkRecords = kChunkBytes / sizeof(SessionRecord);
+constexpr std::chrono::milliseconds kGrowPeriod{10};
+
+struct SessionFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    int64_t startTime;    // Unix epoch nanoseconds
+    uint64_t recordCount; // valid once `complete` is set by the recorder closing the file
+    uint32_t complete;
+    uint8_t reserved[28];
+};
+
+static_assert(sizeof(SessionFileHeader) == 64);
+static_assert(sizeof(SessionRecord) == 56, "the record layout is part of the file format");
+static_assert(std::is_trivially_copyable_v<SessionRecord>);
+
+} // namespace
+
+SessionRecord SessionRecord::state(SessionRecordType type, std::string_view device, double speed,
+                                   double position, bool moving, bool error)
+{
+    SessionRecord record;
+    record.type = type;
+    record.speed = speed;
+    record.position = position;
+    record.moving = moving;
+    record.error = error;
+    device.copy(record.device, kDeviceLength - 1);
+    return record;
+}
+
+SessionRecord SessionRecord::command(SessionRecordType type, std::string_view device, uint8_t command,
+                                     int32_t value)
+{
+    SessionRecord record;
+    record.type = type;
+    record.commandType = command;
+    record.value = value;
+    device.copy(record.device, kDeviceLength - 1);
+    return record;
+}
+
+std::string_view SessionRecord::getDevice() const
+{
+    return std::string_view(device, strnlen(device, kDeviceLength));
+}
+
+std::unique_ptr<SessionRecorder> SessionRecorder::create(const std::string &path, size_t maxBytes)
+{
+    const size_t maxRecords = (std::max(maxBytes, sizeof(SessionFileHeader)) - sizeof(SessionFileHeader)) /
+                              sizeof(SessionRecord);
+    int fd = ::open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+    if (fd < 0)
+        return nullptr;
+    // Reserve address space for the whole file up front; only the extended part is ever touched
+    const size_t mappedSize = sizeof(SessionFileHeader) + maxRecords * sizeof(SessionRecord);
+    void *mapping = MAP_FAILED;
+    if (ftruncate(fd, sizeof(SessionFileHeader)) == 0)
+        mapping = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        ::close(fd);
+        return nullptr;
+    }
+
+    std::unique_ptr<SessionRecorder> recorder(
+        new SessionRecorder(path, fd, static_cast<char *>(mapping), maxRecords));
+    if (!recorder->grow())
+        return nullptr;
+    recorder->thread_ = std::thread(&SessionRecorder::run, recorder.get());
+    return recorder;
+}
+
+SessionRecorder::SessionRecorder(std::string path, int fd, char *mapping, size_t maxRecords)
+    : path_(std::move(path)), fd_(fd), mapping_(mapping),
+      records_(reinterpret_cast<SessionRecord *>(mapping + sizeof(SessionFileHeader))), maxRecords_(maxRecords),
+      start_(std::chrono::steady_clock::now())
+{
+    SessionFileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.recordSize = sizeof(SessionRecord);
+    header.startTime =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    std::memcpy(mapping_, &header, sizeof(header));
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    if (thread_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    const uint64_t count = next_.load(std::memory_order_acquire);
+    auto *header = reinterpret_cast<SessionFileHeader *>(mapping_);
+    header->recordCount = count;
+    header->complete = 1;
+    munmap(mapping_, sizeof(SessionFileHeader) + maxRecords_ * sizeof(SessionRecord));
+    if (ftruncate(fd_, static_cast<off_t>(sizeof(SessionFileHeader) + count * sizeof(SessionRecord))) != 0)
+    {
+        // The file keeps its zero-filled tail, which readers skip
+    }
+    ::close(fd_);
+}
+
+bool SessionRecorder::record(SessionRecord record)
+{
+    // The timestamp is taken inside the claim loop, so timestamps never decrease in file order: a writer that
+    // loses the race to another re-reads the clock after seeing that writer's claim.
+    uint64_t index = next_.load(std::memory_order_acquire);
+    do
+    {
+        if (index >= available_.load(std::memory_order_acquire))
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        record.timeNs = (std::chrono::steady_clock::now() - start_).count();
+    } while (!next_.compare_exchange_weak(index, index + 1, std::memory_order_acq_rel, std::memory_order_acquire));
+
+    records_[index] = record;
+    return true;
+}
+
+bool SessionRecorder::record(size_t count, FunctionRef<SessionRecord(size_t)> make)
+{
+    uint64_t index = next_.load(std::memory_order_acquire);
+    int64_t timeNs;
+    do
+    {
+        if (index + count > available_.load(std::memory_order_acquire))
+        {
+            dropped_.fetch_add(count, std::memory_order_relaxed);
+            return false;
+        }
+        timeNs = (std::chrono::steady_clock::now() - start_).count();
+    } while (!next_.compare_exchange_weak(index, index + count, std::memory_order_acq_rel, std::memory_order_acquire));
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        SessionRecord &record = records_[index + i];
+        record = make(i);
+        record.timeNs = timeNs;
+    }
+    return true;
+}
+
+uint64_t SessionRecorder::getRecordedCount() const
+{
+    return next_.load(std::memory_order_relaxed);
+}
+
+uint64_t SessionRecorder::getDroppedCount() const
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+const std::string &SessionRecorder::getPath() const
+{
+    return path_;
+}
+
+bool SessionRecorder::grow()
+{
+    const uint64_t available = available_.load(std::memory_order_relaxed);
+    const uint64_t target = std::min<uint64_t>(available + kChunkRecords, maxRecords_);
+    if (target == available)
+        return false;
+    if (ftruncate(fd_, static_cast<off_t>(sizeof(SessionFileHeader) + target * sizeof(SessionRecord))) != 0)
+        return false;
+#ifdef MADV_POPULATE_WRITE
+    // Fault the new pages in here rather than one at a time on the recording threads. Best effort: the
+    // range is page-aligned outwards, and older kernels simply refuse.
+    const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    auto begin = reinterpret_cast<uintptr_t>(records_ + available) & ~(pageSize - 1);
+    auto end = reinterpret_cast<uintptr_t>(records_ + target) & ~(pageSize - 1);
+    if (end > begin)
+        madvise(reinterpret_cast<void *>(begin), end - begin, MADV_POPULATE_WRITE);
+#endif
+    available_.store(target, std::memory_order_release);
+    return true;
+}
+
+void SessionRecorder::run()
+{
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    while (!stopping_)
+    {
+        // Keep at least half a chunk of headroom ahead of the writers
+        while (available_.load(std::memory_order_relaxed) - next_.load(std::memory_order_relaxed) <
+                   kChunkRecords / 2 &&
+               grow())
+        {
+        }
+        wake_.wait_for(lock, kGrowPeriod, [this] { return stopping_; });
+    }
+}
+
+std::unique_ptr<SessionReader> SessionReader::open(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+    struct stat info;
+    void *mapping = MAP_FAILED;
+    size_t size = 0;
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(SessionFileHeader))
+    {
+        size = static_cast<size_t>(info.st_size);
+        mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+        return nullptr;
+
+    const auto *header = static_cast<const SessionFileHeader *>(mapping);
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kFormatVersion ||
+        header->recordSize != sizeof(SessionRecord))
+    {
+        munmap(mapping, size);
+        return nullptr;
+    }
+
+    size_t count = (size - sizeof(SessionFileHeader)) / sizeof(SessionRecord);
+    if (header->complete)
+        count = std::min<size_t>(count, header->recordCount);
+    else
+    {
+        const auto *records = reinterpret_cast<const SessionRecord *>(static_cast<const char *>(mapping) +
+                                                                      sizeof(SessionFileHeader));
+        while (count > 0 && records[count - 1].type == SessionRecordType::None)
+            --count;
+    }
+    return std::unique_ptr<SessionReader>(new SessionReader(static_cast<const char *>(mapping), size, count));
+}
+
+SessionReader::SessionReader(const char *mapping, size_t mappedSize, size_t count)
+    : mapping_(mapping), mappedSize_(mappedSize), count_(count)
+{
+}
+
+SessionReader::~SessionReader()
+{
+    munmap(const_cast<char *>(mapping_), mappedSize_);
+}
+
+std::span<const SessionRecord> SessionReader::records() const
+{
+    return {reinterpret_cast<const SessionRecord *>(mapping_ + sizeof(SessionFileHeader)), count_};
+}
+
+size_t SessionReader::size() const
+{
+    return count_;
+}
+
+const SessionRecord &SessionReader::operator[](size_t index) const
+{
+    return records()[index];
+}
+
+std::chrono::nanoseconds SessionReader::getDuration() const
+{
+    return count_ ? records().back().time() : std::chrono::nanoseconds{0};
+}
+
+int64_t SessionReader::getStartTime() const
+{
+    return reinterpret_cast<const SessionFileHeader *>(mapping_)->startTime;
+}
+
+size_t SessionReader::seek(std::chrono::nanoseconds time) const
+{
+    auto all = records();
+    auto it = std::partition_point(all.begin(), all.end(),
+                                   [&](const SessionRecord &record) { return record.timeNs < time.count(); });
+    return static_cast<size_t>(it - all.begin());
+}
+
+} // namespace FingerFlexAid
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "FunctionRef.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace FingerFlexAid
+{
+
+enum class SessionRecordType : uint8_t
+{
+    None, // zero-filled space past the last record of an unfinished file
+    MotorState,
+    ServoState,
+    MotorCommand,
+    ServoCommand,
+    EmergencyStop
+};
+
+// One fixed-size entry of a session file. State records carry speed/position/flags (position is the angle
+// for servos); command records carry the command type and argument, as MotorCommand/ServoCommand hold them.
+struct SessionRecord
+{
+    static constexpr size_t kDeviceLength = 24;
+
+    int64_t timeNs = 0; // since the recording started
+    SessionRecordType type = SessionRecordType::None;
+    uint8_t commandType = 0;
+    uint8_t moving = 0;
+    uint8_t error = 0;
+    int32_t value = 0;
+    double speed = 0;
+    double position = 0;
+    char device[kDeviceLength] = {}; // id, truncated and NUL-padded
+
+    static SessionRecord state(SessionRecordType type, std::string_view device, double speed, double position,
+                               bool moving, bool error);
+    static SessionRecord command(SessionRecordType type, std::string_view device, uint8_t command,
+                                 int32_t value);
+    std::string_view getDevice() const;
+    std::chrono::nanoseconds time() const
+    {
+        return std::chrono::nanoseconds(timeNs);
+    }
+};
+
+// Append-only session file: a header followed by SessionRecords in the order they were recorded. The file
+// is mapped once for its maximum size and a background thread extends it a chunk ahead of the writers, so
+// record() is a slot claim and a copy into the mapping, with no system call, lock or allocation. When the
+// file cannot keep up (or reaches its maximum size) records are dropped and counted instead of waiting.
+//
+// Any thread may record; the recorder must outlive every device and manager recording into it.
+class SessionRecorder
+{
+  public:
+    static constexpr size_t kDefaultMaxBytes = size_t{4} << 30;
+
+    // Creates or truncates `path`; returns nullptr if the file cannot be created and mapped.
+    static std::unique_ptr<SessionRecorder> create(const std::string &path, size_t maxBytes = kDefaultMaxBytes);
+    // Trims the file to the records written and marks it complete.
+    ~SessionRecorder();
+
+    SessionRecorder(const SessionRecorder &) = delete;
+    SessionRecorder &operator=(const SessionRecorder &) = delete;
+
+    // Stamps the record with the time since the recording started and appends it.
+    bool record(SessionRecord record);
+    // Appends make(0) .. make(count - 1) as adjacent records with one timestamp, e.g. the commands of one
+    // batch, so a player can tell them apart from commands that merely followed each other. All or none of
+    // them are recorded.
+    bool record(size_t count, FunctionRef<SessionRecord(size_t)> make);
+
+    uint64_t getRecordedCount() const;
+    uint64_t getDroppedCount() const;
+    const std::string &getPath() const;
+
+  private:
+    SessionRecorder(std::string path, int fd, char *mapping, size_t maxRecords);
+
+    bool grow(); // extends the file by a chunk; false once at the maximum or if the file system refuses
+    void run();
+
+    const std::string path_;
+    const int fd_;
+    char *const mapping_;
+    SessionRecord *const records_;
+    const size_t maxRecords_;
+    const std::chrono::steady_clock::time_point start_;
+
+    alignas(64) std::atomic<uint64_t> next_{0};      // next record index to claim
+    alignas(64) std::atomic<uint64_t> available_{0}; // records that fit in the file as extended so far
+    std::atomic<uint64_t> dropped_{0};
+
+    std::mutex wakeMutex_; // growth thread only; never taken by record()
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+// Read-only view of a session file. Records are fixed size and in time order, so the file is its own time
+// index: seek() is a binary search touching a few dozen pages, however long the session.
+class SessionReader
+{
+  public:
+    // Returns nullptr if the file is missing or not a session file. Unfinished files (the recorder is still
+    // running or crashed) are read up to the last complete record.
+    static std::unique_ptr<SessionReader> open(const std::string &path);
+    ~SessionReader();
+
+    SessionReader(const SessionReader &) = delete;
+    SessionReader &operator=(const SessionReader &) = delete;
+
+    std::span<const SessionRecord> records() const;
+    size_t size() const;
+    const SessionRecord &operator[](size_t index) const;
+    std::chrono::nanoseconds getDuration() const;
+    // Wall-clock time the recording started, as nanoseconds since the Unix epoch.
+    int64_t getStartTime() const;
+
+    // Index of the first record at or after `time`; size() if there is none.
+    size_t seek(std::chrono::nanoseconds time) const;
+
+  private:
+    SessionReader(const char *mapping, size_t mappedSize, size_t count);
+
+    const char *mapping_;
+    size_t mappedSize_;
+    size_t count_;
+};
+
+} // namespace FingerFlexAid
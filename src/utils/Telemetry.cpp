@@ -0,0 +1,273 @@
+#include "Telemetry.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace FingerFlexAid
+{
+
+namespace
+{
+
+constexpr uint32_t kMagic = 0x46464154; // "FFAT"
+constexpr uint32_t kLayoutVersion = 1;
+constexpr size_t kWords = (sizeof(TelemetryRecord) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+static_assert(std::is_trivially_copyable_v<TelemetryRecord>);
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "the ring is shared between processes");
+
+size_t roundCapacity(size_t capacity)
+{
+    return std::bit_ceil(std::max<size_t>(capacity, 2));
+}
+
+} // namespace
+
+struct TelemetryRing::Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    uint64_t recordSize;
+    alignas(64) std::atomic<uint64_t> head; // next index to claim
+};
+
+// For index i the sequence is 2i + 1 while a publisher writes it and 2i + 2 once complete; 0 means unused.
+struct alignas(64) TelemetryRing::Slot
+{
+    std::atomic<uint64_t> sequence;
+    std::array<std::atomic<uint64_t>, kWords> words;
+};
+
+size_t TelemetryRing::mappingSize(size_t capacity)
+{
+    return sizeof(Header) + capacity * sizeof(Slot);
+}
+
+TelemetryRing::TelemetryRing(size_t capacity)
+    : TelemetryRing(mmap(nullptr, mappingSize(roundCapacity(capacity)), PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0),
+                    mappingSize(roundCapacity(capacity)), std::string())
+{
+    if (mapping_ == MAP_FAILED)
+        throw std::bad_alloc();
+}
+
+TelemetryRing::TelemetryRing(void *mapping, size_t mappedSize, std::string name)
+    : mapping_(mapping), mappedSize_(mappedSize), name_(std::move(name)), header_(nullptr), slots_(nullptr)
+{
+    if (mapping_ == MAP_FAILED)
+        return;
+    // Fresh mappings are zero-filled, which is already the unused state of every slot
+    header_ = new (mapping_) Header{kMagic, kLayoutVersion, (mappedSize_ - sizeof(Header)) / sizeof(Slot),
+                                    sizeof(TelemetryRecord), {0}};
+    slots_ = reinterpret_cast<Slot *>(static_cast<char *>(mapping_) + sizeof(Header));
+}
+
+TelemetryRing::~TelemetryRing()
+{
+    if (mapping_ != MAP_FAILED)
+        munmap(mapping_, mappedSize_);
+    if (name_.empty())
+        return;
+    // Another ring may have taken the name over with Existing::Replace; its object is not ours to unlink
+    int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        return;
+    struct stat status{};
+    if (fstat(fd, &status) == 0 && static_cast<uint64_t>(status.st_ino) == inode_)
+        shm_unlink(name_.c_str());
+    close(fd);
+}
+
+std::unique_ptr<TelemetryRing> TelemetryRing::createShared(const std::string &name, size_t capacity,
+                                                           Existing existing)
+{
+    const size_t size = mappingSize(roundCapacity(capacity));
+    if (existing == Existing::Replace)
+        shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+        return nullptr;
+    void *mapping = MAP_FAILED;
+    struct stat status{};
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0 && fstat(fd, &status) == 0)
+        mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    auto ring = std::unique_ptr<TelemetryRing>(new TelemetryRing(mapping, size, name));
+    ring->inode_ = static_cast<uint64_t>(status.st_ino);
+    return ring;
+}
+
+void TelemetryRing::publish(const TelemetryRecord &record)
+{
+    std::array<uint64_t, kWords> words{};
+    std::memcpy(words.data(), &record, sizeof(record));
+
+    const uint64_t capacity = header_->capacity;
+    const uint64_t index = header_->head.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots_[index & (capacity - 1)];
+
+    // The previous lap's publisher of this slot must be done before it is reused. It only ever waits if
+    // the ring wraps completely while one publisher is preempted mid-write.
+    const uint64_t previous = index >= capacity ? 2 * (index - capacity) + 2 : 0;
+    while (slot.sequence.load(std::memory_order_acquire) < previous)
+        std::this_thread::yield();
+
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < kWords; ++i)
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+uint64_t TelemetryRing::getPublishedCount() const
+{
+    return header_->head.load(std::memory_order_relaxed);
+}
+
+size_t TelemetryRing::getCapacity() const
+{
+    return header_->capacity;
+}
+
+const std::string &TelemetryRing::getName() const
+{
+    return name_;
+}
+
+TelemetryReader::TelemetryReader(const TelemetryRing &ring)
+    : TelemetryReader(ring.mapping_, ring.mappedSize_, false)
+{
+}
+
+TelemetryReader::TelemetryReader(const void *mapping, size_t mappedSize, bool owned)
+    : mapping_(mapping), mappedSize_(mappedSize), owned_(owned),
+      header_(static_cast<const TelemetryRing::Header *>(mapping)),
+      slots_(reinterpret_cast<const TelemetryRing::Slot *>(static_cast<const char *>(mapping) +
+                                                             sizeof(TelemetryRing::Header))),
+      cursor_(header_->head.load(std::memory_order_acquire))
+{
+}
+
+TelemetryReader::~TelemetryReader()
+{
+    if (owned_)
+        munmap(const_cast<void *>(mapping_), mappedSize_);
+}
+
+std::unique_ptr<TelemetryReader> TelemetryReader::openShared(const std::string &name)
+{
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        return nullptr;
+    struct stat info;
+    void *mapping = MAP_FAILED;
+    size_t size = 0;
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(TelemetryRing::Header))
+    {
+        size = static_cast<size_t>(info.st_size);
+        mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return nullptr;
+
+    auto *header = static_cast<const TelemetryRing::Header *>(mapping);
+    if (header->magic != kMagic || header->version != kLayoutVersion ||
+        header->recordSize != sizeof(TelemetryRecord) || TelemetryRing::mappingSize(header->capacity) != size)
+    {
+        munmap(mapping, size);
+        return nullptr;
+    }
+    return std::unique_ptr<TelemetryReader>(new TelemetryReader(mapping, size, true));
+}
+
+bool TelemetryReader::next(TelemetryRecord &record)
+{
+    const uint64_t capacity = header_->capacity;
+    while (true)
+    {
+        const TelemetryRing::Slot &slot = slots_[cursor_ & (capacity - 1)];
+        const uint64_t expected = 2 * cursor_ + 2;
+        const uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before < expected)
+            return false; // not published yet, or still being written
+
+        std::array<uint64_t, kWords> words;
+        if (before == expected)
+        {
+            for (size_t i = 0; i < kWords; ++i)
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == expected)
+            {
+                std::memcpy(static_cast<void *>(&record), words.data(), sizeof(record));
+                ++cursor_;
+                return true;
+            }
+        }
+
+        // Lapped: skip to the oldest record the ring can still hold
+        const uint64_t head = header_->head.load(std::memory_order_acquire);
+        const uint64_t oldest = head > capacity ? head - capacity : 0;
+        const uint64_t resume = std::max(oldest, cursor_ + 1);
+        lost_ += resume - cursor_;
+        cursor_ = resume;
+    }
+}
+
+uint64_t TelemetryReader::getLostCount() const
+{
+    return lost_;
+}
+
+void TelemetrySource::attachTelemetry(TelemetryRing *ring)
+{
+    ring_.store(ring, std::memory_order_release);
+}
+
+TelemetryRing *TelemetrySource::getTelemetry() const
+{
+    return ring_.load(std::memory_order_acquire);
+}
+
+void TelemetrySource::publishTelemetry(double speed, double position, bool moving, bool error) const
+{
+    TelemetryRing *ring = getTelemetry();
+    if (!ring)
+        return;
+    TelemetryRecord record;
+    record.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now().time_since_epoch())
+                             .count();
+    record.speed = speed;
+    record.position = position;
+    std::memcpy(record.device, device_, sizeof(device_));
+    record.kind = kind_;
+    record.moving = moving;
+    record.error = error;
+    ring->publish(record);
+}
+
+void TelemetrySource::setTelemetryIdentity(TelemetryKind kind, std::string_view id)
+{
+    kind_ = kind;
+    std::memset(device_, 0, sizeof(device_));
+    std::memcpy(device_, id.data(), std::min(id.size(), sizeof(device_) - 1));
+}
+
+} // namespace FingerFlexAid
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace FingerFlexAid
+{
+
+enum class TelemetryKind : uint8_t
+{
+    Motor,
+    Servo
+};
+
+// One device state sample. Plain data with a fixed layout, so other processes can read it out of shared
+// memory; position is the servo angle for servos.
+struct TelemetryRecord
+{
+    static constexpr size_t kDeviceLength = 24;
+
+    int64_t timestampNs = 0; // steady clock
+    double speed = 0;
+    double position = 0;
+    char device[kDeviceLength] = {}; // id, truncated and NUL-padded
+    TelemetryKind kind = TelemetryKind::Motor;
+    uint8_t moving = 0;
+    uint8_t error = 0;
+};
+
+// Broadcast ring of telemetry records. Any thread may publish; every reader sees every record until the
+// ring laps it, at which point the reader skips ahead and counts what it lost. Nothing a reader does can
+// slow down or block a publisher, so readers may live in other processes (see createShared()).
+//
+// Each slot carries its own sequence number, seqlock style: a publisher claims the next index, marks the
+// slot busy, writes the record as relaxed atomic words and then marks it complete for that index. A reader
+// copies a slot only when its sequence says it holds the index it wants, and rechecks afterwards.
+class TelemetryRing
+{
+  public:
+    // In-process ring; capacity is rounded up to a power of two.
+    explicit TelemetryRing(size_t capacity = 4096);
+    ~TelemetryRing();
+
+    TelemetryRing(const TelemetryRing &) = delete;
+    TelemetryRing &operator=(const TelemetryRing &) = delete;
+
+    // What createShared() does when an object of the name already exists.
+    enum class Existing
+    {
+        Fail,   // return nullptr; the object may belong to a live ring in another process
+        Replace // unlink it first, e.g. one left behind by a crashed process
+    };
+
+    // Ring in the POSIX shared-memory object `name` (e.g. "/fingerflexaid-telemetry"); unlinked again when
+    // the ring is destroyed. Returns nullptr if it cannot be created, including when the name is taken and
+    // `existing` is Fail.
+    static std::unique_ptr<TelemetryRing> createShared(const std::string &name, size_t capacity = 4096,
+                                                       Existing existing = Existing::Fail);
+
+    void publish(const TelemetryRecord &record);
+
+    uint64_t getPublishedCount() const;
+    size_t getCapacity() const;
+    // Shared-memory name, empty for an in-process ring.
+    const std::string &getName() const;
+
+  private:
+    friend class TelemetryReader;
+    struct Header;
+    struct Slot;
+
+    TelemetryRing(void *mapping, size_t mappedSize, std::string name);
+    static size_t mappingSize(size_t capacity);
+
+    void *mapping_;
+    size_t mappedSize_;
+    std::string name_;
+    uint64_t inode_ = 0; // of the shared-memory object, so the destructor unlinks the name only while it is ours
+    Header *header_;
+    Slot *slots_;
+};
+
+// Cursor over a TelemetryRing, in this process or another. A new reader starts at the newest record, so it
+// only sees what is published after it was opened.
+class TelemetryReader
+{
+  public:
+    explicit TelemetryReader(const TelemetryRing &ring);
+    ~TelemetryReader();
+
+    TelemetryReader(const TelemetryReader &) = delete;
+    TelemetryReader &operator=(const TelemetryReader &) = delete;
+
+    // Maps the ring another process created with TelemetryRing::createShared(); read-only. Returns nullptr
+    // if there is no such ring or it has an incompatible layout.
+    static std::unique_ptr<TelemetryReader> openShared(const std::string &name);
+
+    // Copies the next record and returns true, or returns false when caught up with the publishers.
+    bool next(TelemetryRecord &record);
+    // Records overwritten before this reader got to them.
+    uint64_t getLostCount() const;
+
+  private:
+    TelemetryReader(const void *mapping, size_t mappedSize, bool owned);
+
+    const void *mapping_;
+    size_t mappedSize_;
+    bool owned_;
+    const TelemetryRing::Header *header_;
+    const TelemetryRing::Slot *slots_;
+    uint64_t cursor_ = 0;
+    uint64_t lost_ = 0;
+};
+
+// Mixin for devices that report their state to a TelemetryRing. Devices publish through it whenever their
+// speed, position or flags change; with no ring attached that costs one atomic load.
+class TelemetrySource
+{
+  public:
+    // The ring must outlive the device, or be detached (nullptr) first.
+    void attachTelemetry(TelemetryRing *ring);
+    TelemetryRing *getTelemetry() const;
+    // The id records are published under, truncated to fit a record.
+    std::string_view getTelemetryId() const
+    {
+        return device_;
+    }
+
+    void publishTelemetry(double speed, double position, bool moving, bool error) const;
+
+  protected:
+    TelemetrySource() = default;
+    ~TelemetrySource() = default;
+
+    void setTelemetryIdentity(TelemetryKind kind, std::string_view id);
+
+  private:
+    std::atomic<TelemetryRing *> ring_{nullptr};
+    TelemetryKind kind_ = TelemetryKind::Motor;
+    char device_[TelemetryRecord::kDeviceLength] = {};
+};
+
+} // namespace FingerFlexAid
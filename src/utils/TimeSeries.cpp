@@ -0,0 +1,298 @@
+#include "TimeSeries.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace FingerFlexAid
+{
+
+namespace
+{
+
+// Largest encoding of one sample after the first: a raw 64-bit delta-of-delta behind its 4-bit prefix,
+// and a value XOR with a new window (2-bit prefix, 5-bit leading zeros, 6-bit length, 64 bits).
+constexpr unsigned kWorstCaseBits = 4 + 64 + 2 + 5 + 6 + 64;
+constexpr int kMaxLeading = 31; // what fits in the 5-bit leading-zero count
+
+bool fitsSigned(int64_t value, unsigned bits)
+{
+    const int64_t limit = int64_t{1} << (bits - 1);
+    return value >= -limit && value < limit;
+}
+
+int64_t signExtend(uint64_t value, unsigned bits)
+{
+    return static_cast<int64_t>(value << (64 - bits)) >> (64 - bits);
+}
+
+// Reads bit fields back in the order TimeSeries::writeBits packed them: most significant bit first.
+class BitReader
+{
+  public:
+    explicit BitReader(const uint64_t *words) : words_(words)
+    {
+    }
+
+    uint64_t read(unsigned count)
+    {
+        if (count == 0)
+            return 0;
+        const size_t word = position_ / 64;
+        const unsigned free = 64 - position_ % 64;
+        uint64_t value;
+        if (count <= free)
+            value = words_[word] >> (free - count);
+        else
+            value = (words_[word] << (count - free)) | (words_[word + 1] >> (64 - (count - free)));
+        if (count < 64)
+            value &= (uint64_t{1} << count) - 1;
+        position_ += count;
+        return value;
+    }
+
+    bool bit()
+    {
+        return read(1) != 0;
+    }
+
+  private:
+    const uint64_t *words_;
+    uint32_t position_ = 0;
+};
+
+} // namespace
+
+bool TimeSeries::append(std::chrono::microseconds time, double value)
+{
+    const int64_t t = time.count();
+    const uint64_t bits = std::bit_cast<uint64_t>(value);
+    if (samples_ > 0 && t < state_.time)
+        return false;
+
+    if (blocks_.empty() || blocks_.back().bits + kWorstCaseBits > kBlockWords * 64)
+    {
+        // Start a new block from a raw sample, so it decodes without its predecessors
+        blocks_.emplace_back().firstTime = t;
+        writeBits(static_cast<uint64_t>(t), 64);
+        writeBits(bits, 64);
+        state_ = EncoderState{t, 0, bits, -1, 0};
+    }
+    else
+    {
+        const int64_t delta = t - state_.time;
+        const int64_t deltaOfDelta = delta - state_.delta;
+        const auto raw = static_cast<uint64_t>(deltaOfDelta);
+        if (deltaOfDelta == 0)
+            writeBits(0b0, 1);
+        else if (fitsSigned(deltaOfDelta, 7))
+        {
+            writeBits(0b10, 2);
+            writeBits(raw, 7);
+        }
+        else if (fitsSigned(deltaOfDelta, 9))
+        {
+            writeBits(0b110, 3);
+            writeBits(raw, 9);
+        }
+        else if (fitsSigned(deltaOfDelta, 12))
+        {
+            writeBits(0b1110, 4);
+            writeBits(raw, 12);
+        }
+        else
+        {
+            writeBits(0b1111, 4);
+            writeBits(raw, 64);
+        }
+        state_.time = t;
+        state_.delta = delta;
+
+        const uint64_t x = bits ^ state_.value;
+        if (x == 0)
+            writeBits(0b0, 1);
+        else
+        {
+            const int leading = std::min(std::countl_zero(x), kMaxLeading);
+            const int trailing = std::countr_zero(x);
+            if (state_.leading >= 0 && leading >= state_.leading && trailing >= state_.trailing)
+            {
+                // The meaningful bits fit the previous window: reuse it
+                writeBits(0b10, 2);
+                writeBits(x >> state_.trailing, static_cast<unsigned>(64 - state_.leading - state_.trailing));
+            }
+            else
+            {
+                const int length = 64 - leading - trailing;
+                writeBits(0b11, 2);
+                writeBits(static_cast<uint64_t>(leading), 5);
+                writeBits(static_cast<uint64_t>(length - 1), 6);
+                writeBits(x >> trailing, static_cast<unsigned>(length));
+                state_.leading = leading;
+                state_.trailing = trailing;
+            }
+        }
+        state_.value = bits;
+    }
+
+    Block &block = blocks_.back();
+    block.lastTime = t;
+    ++block.count;
+    ++samples_;
+    return true;
+}
+
+size_t TimeSeries::query(std::chrono::microseconds from, std::chrono::microseconds to,
+                         std::vector<TimeSample> &out) const
+{
+    // Blocks are in time order, so the first one that can hold `from` is found by binary search
+    auto first = std::partition_point(blocks_.begin(), blocks_.end(),
+                                      [&](const Block &block) { return block.lastTime < from.count(); });
+    size_t decoded = 0;
+    for (auto it = first; it != blocks_.end() && it->firstTime <= to.count(); ++it, ++decoded)
+        decode(*it, from.count(), to.count(), out);
+    return decoded;
+}
+
+std::vector<TimeSample> TimeSeries::query(std::chrono::microseconds from, std::chrono::microseconds to) const
+{
+    std::vector<TimeSample> samples;
+    query(from, to, samples);
+    return samples;
+}
+
+size_t TimeSeries::getSampleCount() const
+{
+    return samples_;
+}
+
+size_t TimeSeries::getBlockCount() const
+{
+    return blocks_.size();
+}
+
+size_t TimeSeries::getCompressedBytes() const
+{
+    if (blocks_.empty())
+        return 0;
+    return (blocks_.size() - 1) * sizeof(Block) + sizeof(Block) - sizeof(Block::words) + (blocks_.back().bits + 7) / 8;
+}
+
+void TimeSeries::writeBits(uint64_t value, unsigned count)
+{
+    Block &block = blocks_.back();
+    if (count < 64)
+        value &= (uint64_t{1} << count) - 1;
+    const size_t word = block.bits / 64;
+    const unsigned free = 64 - block.bits % 64;
+    if (count <= free)
+        block.words[word] |= value << (free - count);
+    else
+    {
+        block.words[word] |= value >> (count - free);
+        block.words[word + 1] |= value << (64 - (count - free));
+    }
+    block.bits += count;
+}
+
+size_t TimeSeries::decode(const Block &block, int64_t from, int64_t to, std::vector<TimeSample> &out)
+{
+    BitReader reader(block.words.data());
+    int64_t time = static_cast<int64_t>(reader.read(64));
+    uint64_t value = reader.read(64);
+    int64_t delta = 0;
+    int leading = 0;
+    int trailing = 0;
+
+    const size_t before = out.size();
+    for (uint32_t i = 0; i < block.count; ++i)
+    {
+        if (i > 0)
+        {
+            int64_t deltaOfDelta;
+            if (!reader.bit())
+                deltaOfDelta = 0;
+            else if (!reader.bit())
+                deltaOfDelta = signExtend(reader.read(7), 7);
+            else if (!reader.bit())
+                deltaOfDelta = signExtend(reader.read(9), 9);
+            else if (!reader.bit())
+                deltaOfDelta = signExtend(reader.read(12), 12);
+            else
+                deltaOfDelta = static_cast<int64_t>(reader.read(64));
+            delta += deltaOfDelta;
+            time += delta;
+
+            if (reader.bit())
+            {
+                if (reader.bit())
+                {
+                    leading = static_cast<int>(reader.read(5));
+                    const int length = static_cast<int>(reader.read(6)) + 1;
+                    trailing = 64 - leading - length;
+                }
+                value ^= reader.read(static_cast<unsigned>(64 - leading - trailing)) << trailing;
+            }
+        }
+        if (time > to)
+            break;
+        if (time >= from)
+            out.push_back({std::chrono::microseconds(time), std::bit_cast<double>(value)});
+    }
+    return out.size() - before;
+}
+
+bool TimeSeriesStore::append(std::string_view channel, std::chrono::microseconds time, double value)
+{
+    auto it = channels_.find(channel);
+    if (it == channels_.end())
+        it = channels_.emplace(std::string(channel), TimeSeries()).first;
+    return it->second.append(time, value);
+}
+
+void TimeSeriesStore::ingest(const TelemetryRecord &record)
+{
+    const std::chrono::microseconds time(record.timestampNs / 1000);
+    const std::string_view device(record.device, strnlen(record.device, TelemetryRecord::kDeviceLength));
+    key_.assign(device).append(".speed");
+    append(key_, time, record.speed);
+    key_.assign(device).append(".position");
+    append(key_, time, record.position);
+}
+
+size_t TimeSeriesStore::ingest(TelemetryReader &reader)
+{
+    size_t count = 0;
+    TelemetryRecord record;
+    while (reader.next(record))
+    {
+        ingest(record);
+        ++count;
+    }
+    return count;
+}
+
+const TimeSeries *TimeSeriesStore::find(std::string_view channel) const
+{
+    auto it = channels_.find(channel);
+    return it != channels_.end() ? &it->second : nullptr;
+}
+
+std::vector<std::string> TimeSeriesStore::getChannels() const
+{
+    std::vector<std::string> names;
+    names.reserve(channels_.size());
+    for (const auto &entry : channels_)
+        names.push_back(entry.first);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+size_t TimeSeriesStore::getCompressedBytes() const
+{
+    size_t bytes = 0;
+    for (const auto &entry : channels_)
+        bytes += entry.second.getCompressedBytes();
+    return bytes;
+}
+
+} // namespace FingerFlexAid
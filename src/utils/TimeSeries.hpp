@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Telemetry.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace FingerFlexAid
+{
+
+struct TimeSample
+{
+    std::chrono::microseconds time{0};
+    double value = 0;
+
+    bool operator==(const TimeSample &) const = default;
+};
+
+// One compressed channel of (time, value) samples, Gorilla style: timestamps as delta-of-deltas in
+// variable-width buckets, values as the XOR with the previous value, storing only its meaningful bits.
+// Regularly sampled, slowly changing series such as positions and angles take a few bits per sample.
+//
+// Samples are packed into fixed-size blocks; each block starts from a raw sample, so any block decodes on
+// its own and a range query decodes only the blocks overlapping the range. Appends must be in time order.
+// Not synchronised.
+class TimeSeries
+{
+  public:
+    static constexpr size_t kBlockWords = 128; // 1 KiB of encoded bits per block
+
+    // False, leaving the series unchanged, if `time` is earlier than the last sample.
+    bool append(std::chrono::microseconds time, double value);
+
+    // Appends the samples in [from, to] to `out`, in time order; returns how many blocks were decoded.
+    size_t query(std::chrono::microseconds from, std::chrono::microseconds to, std::vector<TimeSample> &out) const;
+    std::vector<TimeSample> query(std::chrono::microseconds from, std::chrono::microseconds to) const;
+
+    size_t getSampleCount() const;
+    size_t getBlockCount() const;
+    // Encoded size, counting only the used part of the open block.
+    size_t getCompressedBytes() const;
+
+  private:
+    struct Block
+    {
+        int64_t firstTime = 0;
+        int64_t lastTime = 0;
+        uint32_t count = 0;
+        uint32_t bits = 0;
+        std::array<uint64_t, kBlockWords> words{};
+    };
+
+    // Encoder state carried between appends to the open block.
+    struct EncoderState
+    {
+        int64_t time = 0;
+        int64_t delta = 0;
+        uint64_t value = 0;
+        int leading = -1; // -1 until a non-zero XOR has set the window
+        int trailing = 0;
+    };
+
+    void writeBits(uint64_t value, unsigned count);
+    static size_t decode(const Block &block, int64_t from, int64_t to, std::vector<TimeSample> &out);
+
+    std::vector<Block> blocks_; // the last one is open for appends
+    EncoderState state_;
+    size_t samples_ = 0;
+};
+
+// Long-term store for telemetry: one TimeSeries per channel, named "<device>.speed" and "<device>.position"
+// (the angle, for servos) when fed from TelemetryRecords. Not synchronised.
+class TimeSeriesStore
+{
+  public:
+    bool append(std::string_view channel, std::chrono::microseconds time, double value);
+    // Appends the record's speed and position to its device's channels, at its timestamp.
+    void ingest(const TelemetryRecord &record);
+    // Ingests everything the reader has pending; returns how many records that was.
+    size_t ingest(TelemetryReader &reader);
+
+    // Null if nothing was ever appended to the channel.
+    const TimeSeries *find(std::string_view channel) const;
+    std::vector<std::string> getChannels() const;
+    size_t getCompressedBytes() const;
+
+  private:
+    struct Hash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view key) const
+        {
+            return std::hash<std::string_view>{}(key);
+        }
+    };
+
+    std::unordered_map<std::string, TimeSeries, Hash, std::equal_to<>> channels_;
+    std::string key_; // reused to build channel names without allocating per record
+};
+
+} // namespace FingerFlexAid
@@ -0,0 +1,206 @@
+#include "core/CommandCoalescing.hpp"
+#include "core/SerialDevices.hpp"
+#include "mock/FirmwareEmulator.hpp"
+#include "mock/MockMotor.hpp"
+#include "mock/MockServo.hpp"
+#include "mock/SimulationEngine.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+
+using namespace FingerFlexAid;
+
+namespace
+{
+
+void expectAccountedFor(const CoalescingStats &stats)
+{
+    EXPECT_EQ(stats.requested, stats.sent + stats.dropped + stats.rejected);
+}
+
+class CoalescingTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        motor = std::make_shared<MockMotor>("motor", engine);
+        servo = std::make_shared<MockServo>("servo", engine);
+        motor->simulateHardwareDelay(std::chrono::milliseconds(0));
+    }
+
+    SimulationEngine engine;
+    std::shared_ptr<MockMotor> motor;
+    std::shared_ptr<MockServo> servo;
+};
+
+} // namespace
+
+TEST_F(CoalescingTest, WritesOnlyTheLatestValuePerFlush)
+{
+    CoalescingOptions options;
+    options.motorPositionThreshold = CoalescingOptions::kNever;
+    CoalescingMotor coalesced(motor, options);
+
+    for (int32_t position = 1; position <= 10; ++position)
+        EXPECT_TRUE(coalesced.setPosition(position * 10));
+    EXPECT_EQ(motor->getCurrentPosition(), 0); // nothing written yet
+    EXPECT_TRUE(coalesced.flush());
+    EXPECT_EQ(motor->getCurrentPosition(), 100);
+
+    auto stats = coalesced.getStats();
+    EXPECT_EQ(stats.requested, 10u);
+    EXPECT_EQ(stats.sent, 1u);
+    EXPECT_EQ(stats.dropped, 9u);
+    expectAccountedFor(stats);
+}
+
+TEST_F(CoalescingTest, DropsRepeatsOfTheLastWrittenValue)
+{
+    CoalescingServo coalesced(servo);
+    coalesced.setAngle(90);
+    coalesced.setSpeed(40);
+    coalesced.flush();
+    coalesced.setAngle(90);
+    coalesced.setSpeed(40);
+    EXPECT_TRUE(coalesced.flush());
+
+    auto stats = coalesced.getStats();
+    EXPECT_EQ(stats.sent, 2u);
+    EXPECT_EQ(stats.dropped, 2u);
+    expectAccountedFor(stats);
+
+    // A stop forgets what was written: the same angle afterwards is a real command again
+    coalesced.stop();
+    coalesced.setAngle(90);
+    coalesced.flush();
+    EXPECT_EQ(coalesced.getStats().sent, 3u);
+}
+
+TEST_F(CoalescingTest, RepeatsAfterAStopTheStageDidNotSeeAreWrittenAgain)
+{
+    EmergencyStop stop;
+    engine.watchEmergencyStop(&stop);
+    CoalescingMotor coalesced(motor);
+    coalesced.setSpeed(500);
+    coalesced.flush();
+    engine.advance(std::chrono::milliseconds(200));
+    ASSERT_TRUE(motor->isMoving());
+
+    // Stopped on the device itself, then recovered
+    motor->emergencyStop();
+    motor->clearError();
+    EXPECT_TRUE(coalesced.setSpeed(500));
+    EXPECT_TRUE(coalesced.flush());
+    engine.advance(std::chrono::milliseconds(200));
+    EXPECT_TRUE(motor->isMoving());
+
+    // Halted by the epoch, with no error at all
+    stop.trigger();
+    engine.advance(engine.getTickPeriod());
+    ASSERT_FALSE(motor->isMoving());
+    EXPECT_TRUE(coalesced.setSpeed(500));
+    EXPECT_TRUE(coalesced.flush());
+    engine.advance(std::chrono::milliseconds(200));
+    EXPECT_TRUE(motor->isMoving());
+    EXPECT_EQ(coalesced.getStats().sent, 3u);
+}
+
+TEST_F(CoalescingTest, LargeChangesAreWrittenAtOnce)
+{
+    CoalescingOptions options;
+    options.motorPositionThreshold = 1000;
+    CoalescingMotor coalesced(motor, options);
+    coalesced.setPosition(100);
+    coalesced.flush();
+
+    coalesced.setPosition(600);
+    EXPECT_EQ(motor->getCurrentPosition(), 100); // within the threshold: waits for the flush
+    coalesced.setPosition(5000);
+    EXPECT_EQ(motor->getCurrentPosition(), 5000);
+    EXPECT_EQ(coalesced.getStats().sent, 2u);
+    expectAccountedFor(coalesced.getStats());
+}
+
+TEST_F(CoalescingTest, StopDiscardsPendingWrites)
+{
+    CoalescingOptions options;
+    options.motorPositionThreshold = CoalescingOptions::kNever;
+    CoalescingMotor coalesced(motor, options);
+    coalesced.setPosition(250);
+    EXPECT_TRUE(coalesced.stop());
+    EXPECT_TRUE(coalesced.flush());
+    EXPECT_EQ(motor->getCurrentPosition(), 0);
+    EXPECT_EQ(coalesced.getStats().dropped, 1u);
+}
+
+TEST_F(CoalescingTest, InvalidValuesReachTheDeviceImmediately)
+{
+    CoalescingMotor coalesced(motor);
+    EXPECT_FALSE(coalesced.setSpeed(5000)); // above the motor's maximum speed
+    EXPECT_TRUE(motor->isError());
+    EXPECT_TRUE(coalesced.getLastError().has_value());
+    EXPECT_EQ(coalesced.getStats().rejected, 1u);
+
+    // A staged value the device refuses at flush time goes through its setter, so it reports why
+    motor->clearError();
+    CoalescingServo servoStage(servo);
+    servoStage.setAngle(120);
+    servo->simulateError("jammed");
+    EXPECT_FALSE(servoStage.flush());
+    EXPECT_EQ(servoStage.getStats().rejected, 1u);
+    expectAccountedFor(servoStage.getStats());
+}
+
+TEST_F(CoalescingTest, BatchedCommandsSupersedeStagedValues)
+{
+    CoalescingOptions options;
+    options.motorPositionThreshold = CoalescingOptions::kNever;
+    CoalescingMotor coalesced(motor, options);
+    coalesced.setPosition(300);
+    engine.beginBatch();
+    EXPECT_TRUE(coalesced.applyCommand(MotorCommand::position(700)));
+    engine.endBatch();
+    coalesced.flush();
+    EXPECT_EQ(motor->getCurrentPosition(), 700);
+    EXPECT_EQ(coalesced.getStats().dropped, 1u);
+}
+
+TEST(CoalescingGroupTest, FlushesADomainAsOneTransmission)
+{
+    int hostFd = -1;
+    auto emulator = FirmwareEmulator::createLoopback({3, 2}, hostFd);
+    auto bus = std::make_shared<SerialBus>(SerialLink::adopt(hostFd));
+
+    CoalescingOptions options;
+    options.motorPositionThreshold = CoalescingOptions::kNever;
+    options.servoAngleThreshold = CoalescingOptions::kNever;
+    CoalescingGroup group;
+    std::vector<std::shared_ptr<CoalescingMotor>> motors;
+    for (uint8_t i = 0; i < 3; ++i)
+    {
+        motors.push_back(std::make_shared<CoalescingMotor>(std::make_shared<SerialMotor>(bus, i), options));
+        group.add(motors.back());
+    }
+    auto servo = std::make_shared<CoalescingServo>(std::make_shared<SerialServo>(bus, 1), options);
+    group.add(servo);
+
+    const uint64_t before = emulator->getFramesReceived();
+    for (int step = 0; step < 20; ++step)
+    {
+        for (uint8_t i = 0; i < 3; ++i)
+            motors[i]->setPosition(step * 10 + i);
+        servo->setAngle(static_cast<uint16_t>(step + 30));
+    }
+    EXPECT_EQ(emulator->getFramesReceived(), before); // all staged
+    EXPECT_TRUE(group.flush());
+    EXPECT_EQ(emulator->getFramesReceived(), before + 1);
+    EXPECT_EQ(emulator->getMotor(2).getCurrentPosition(), 192);
+
+    auto stats = group.getStats();
+    EXPECT_EQ(stats.requested, 80u);
+    EXPECT_EQ(stats.sent, 4u);
+    EXPECT_EQ(stats.dropped, 76u);
+
+    // Nothing pending: no frame at all
+    EXPECT_TRUE(group.flush());
+    EXPECT_EQ(emulator->getFramesReceived(), before + 1);
+}
@@ -0,0 +1,85 @@
+#include "core/ControlLoop.hpp"
+#include <algorithm>
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace FingerFlexAid;
+using namespace std::chrono_literals;
+
+TEST(ControlLoopTest, RunsTickAtConfiguredRate)
+{
+    std::atomic<int> calls{0};
+    ControlLoopOptions options;
+    options.period = 2ms;
+    ControlLoop loop([&calls] { ++calls; }, options);
+    EXPECT_TRUE(loop.start());
+    EXPECT_FALSE(loop.start());
+    std::this_thread::sleep_for(100ms);
+    loop.stop();
+    EXPECT_FALSE(loop.isRunning());
+
+    auto stats = loop.getStats();
+    EXPECT_EQ(stats.ticks, static_cast<uint64_t>(calls.load()));
+    // Generous bounds: the sandbox may be loaded, but the rate must be in the right range
+    EXPECT_GT(stats.ticks, 20u);
+    EXPECT_LE(stats.ticks, 51u);
+    EXPECT_EQ(stats.jitter.samples, stats.ticks);
+}
+
+TEST(ControlLoopTest, OverrunsSkipMissedDeadlines)
+{
+    ControlLoopOptions options;
+    options.period = 1ms;
+    ControlLoop loop([] { std::this_thread::sleep_for(3500us); }, options);
+    loop.start();
+    std::this_thread::sleep_for(50ms);
+    loop.stop();
+
+    auto stats = loop.getStats();
+    EXPECT_GT(stats.overruns, 0u);
+    EXPECT_EQ(stats.overruns, stats.overrun.samples);
+    EXPECT_GE(stats.missedTicks, 3 * stats.overruns); // each 3.5ms tick passes at least three deadlines
+    EXPECT_GE(stats.duration.percentile(0.5), 2ms);
+}
+
+TEST(ControlLoopTest, HistogramPercentiles)
+{
+    LatencyHistogram histogram;
+    for (std::chrono::nanoseconds value : {500ns, 1500ns, 3000ns, 3000ns, 100000ns})
+    {
+        histogram.counts[LatencyHistogram::bucketFor(value)]++;
+        histogram.samples++;
+        histogram.max = std::max<std::chrono::nanoseconds>(histogram.max, value);
+    }
+    EXPECT_EQ(LatencyHistogram::bucketFor(500ns), 0u);
+    EXPECT_EQ(LatencyHistogram::bucketFor(1500ns), 1u);
+    EXPECT_EQ(histogram.percentile(0.2), 1us);
+    EXPECT_EQ(histogram.percentile(0.8), 4us);
+    EXPECT_EQ(histogram.percentile(1.0), 100us);
+}
+
+TEST(ControlLoopTest, EmergencyStopReplacesOneTick)
+{
+    std::atomic<int> ticks{0};
+    std::atomic<int> stops{0};
+    EmergencyStop stop;
+    ControlLoopOptions options;
+    options.period = 1ms;
+    options.emergencyStop = &stop;
+    options.onEmergencyStop = [&stops] { ++stops; };
+    ControlLoop loop([&ticks] { ++ticks; }, options);
+    loop.start();
+    while (ticks.load() == 0)
+        std::this_thread::sleep_for(1ms);
+    stop.trigger();
+    while (loop.getStats().emergencyStops == 0)
+        std::this_thread::sleep_for(1ms);
+    const int after = ticks.load();
+    while (ticks.load() == after)
+        std::this_thread::sleep_for(1ms);
+    loop.stop();
+
+    EXPECT_EQ(stops.load(), 1);
+    EXPECT_EQ(loop.getStats().ticks, static_cast<uint64_t>(ticks.load() + stops.load()));
+}
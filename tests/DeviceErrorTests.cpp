@@ -0,0 +1,60 @@
+#include "../src/core/DeviceError.hpp"
+#include "../src/mock/MockMotor.hpp"
+#include "../src/mock/MockServo.hpp"
+#include "../src/mock/SimulationEngine.hpp"
+#include "../src/models/Motor.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace FingerFlexAid;
+
+TEST(ErrorRecordTest, RendersMessagesOnDemand)
+{
+    EXPECT_FALSE(ErrorRecord{});
+    EXPECT_FALSE(ErrorRecord{}.message().has_value());
+
+    auto record = ErrorRecord::raise(ErrorCode::InvalidSpeed, -1200);
+    EXPECT_TRUE(record);
+    EXPECT_EQ(record.value, -1200);
+    EXPECT_LE(record.timestamp(), std::chrono::steady_clock::now());
+    EXPECT_EQ(record.message(), "Invalid speed value: -1200");
+    EXPECT_EQ(ErrorRecord::raise(ErrorCode::EmergencyStop).message(), "Emergency stop activated");
+}
+
+TEST(ErrorRecordTest, InternsFreeFormText)
+{
+    const uint32_t id = ErrorText::intern("tendon slipped");
+    EXPECT_EQ(ErrorText::intern(std::string("tendon ").append("slipped")), id);
+    EXPECT_NE(ErrorText::intern("tendon snapped"), id);
+    EXPECT_EQ(ErrorText::lookup(id), "tendon slipped");
+
+    auto record = ErrorRecord::raise("tendon slipped");
+    EXPECT_EQ(record.code, ErrorCode::Text);
+    EXPECT_EQ(static_cast<uint32_t>(record.value), id);
+    EXPECT_EQ(record.message(), "tendon slipped");
+}
+
+TEST(ErrorRecordTest, DevicesKeepRecords)
+{
+    SimulationEngine engine;
+    MockMotor motor("motor", engine);
+    EXPECT_FALSE(motor.setSpeed(5000));
+    EXPECT_EQ(motor.getLastErrorRecord().code, ErrorCode::InvalidSpeed);
+    EXPECT_EQ(motor.getLastErrorRecord().value, 5000);
+    motor.clearError();
+    EXPECT_FALSE(motor.getLastErrorRecord());
+
+    MockServo servo("servo", engine);
+    servo.emergencyStop();
+    EXPECT_EQ(servo.getLastErrorRecord().code, ErrorCode::EmergencyStop);
+    // Re-raising the flag alone keeps the record that explains it
+    servo.simulateError(true);
+    EXPECT_EQ(servo.getLastErrorRecord().code, ErrorCode::EmergencyStop);
+    servo.simulateError(false);
+    EXPECT_FALSE(servo.getLastError().has_value());
+
+    Motor model("model", 50.0, 1.0);
+    model.simulateError("overheated");
+    EXPECT_EQ(model.getErrorRecord().code, ErrorCode::Text);
+    EXPECT_EQ(model.getErrorMessage(), "overheated");
+}
@@ -1,8 +1,15 @@
 #include "../src/core/DeviceManagerImpl.hpp"
+#include "../src/core/EmergencyStop.hpp"
 #include "../src/mock/MockMotor.hpp"
 #include "../src/mock/MockServo.hpp"
+#include "../src/mock/SimulationEngine.hpp"
+#include <algorithm>
+#include <atomic>
 #include <gtest/gtest.h>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace FingerFlexAid;
 
@@ -73,7 +80,7 @@ TEST_F(DeviceManagerImplTest, IsAnyDeviceMovingAndError)
     manager->registerMotor("m4", motor);
     manager->registerServo("s4", servo);
     motor->setSpeed(100);
-    servo->setAngle(45);
+    servo->setAngleChecked(45);
     EXPECT_TRUE(manager->isAnyDeviceMoving());
     motor->simulateError("fail");
     EXPECT_TRUE(manager->isAnyDeviceInError());
@@ -81,3 +88,479 @@ TEST_F(DeviceManagerImplTest, IsAnyDeviceMovingAndError)
     EXPECT_EQ(errors.size(), 1u);
     EXPECT_EQ(errors[0], "m4");
 }
+
+TEST_F(DeviceManagerImplTest, LookupsStayConsistentDuringRegistration)
+{
+    SimulationEngine engine;
+    auto stable = std::make_shared<MockMotor>("stable", engine);
+    manager->registerMotor("stable", stable);
+
+    std::atomic<bool> done{false};
+    std::atomic<int> misses{0};
+    std::thread reader([&]() {
+        while (!done)
+        {
+            if (manager->getMotor("stable") != stable)
+                ++misses;
+            auto ids = manager->getMotorIds();
+            if (ids.empty())
+                ++misses;
+        }
+    });
+
+    std::vector<std::shared_ptr<MockMotor>> motors;
+    for (int i = 0; i < 200; ++i)
+    {
+        auto id = std::string("m").append(std::to_string(i));
+        motors.push_back(std::make_shared<MockMotor>(id, engine));
+        EXPECT_TRUE(manager->registerMotor(id, motors.back()));
+        if (i % 2)
+        {
+            EXPECT_TRUE(manager->unregisterDevice(id));
+        }
+    }
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(misses, 0);
+    EXPECT_EQ(manager->getMotorCount(), 101u);
+    manager.reset(); // drop the registered motors before the engine they live in
+}
+
+TEST_F(DeviceManagerImplTest, ErrorsNeverReportAReusedSlotUnderTheOldId)
+{
+    SimulationEngine engine;
+    auto trigger = std::make_shared<MockMotor>("trigger", engine);
+    auto healthy = std::make_shared<MockServo>("healthy", engine);
+    auto faulty = std::make_shared<MockServo>("faulty", engine);
+    trigger->simulateError("stalled");
+    faulty->simulateError("jammed");
+    manager->registerMotor("trigger", trigger);
+    manager->registerServo("healthy", healthy);
+
+    // Motors are reported before the servo board is read, so the visitor can hand the healthy servo's slot
+    // to a faulty one behind the walk's snapshot
+    std::vector<std::string> reported;
+    manager->forEachDeviceInError([&](std::string_view id) {
+        reported.emplace_back(id);
+        if (id == "trigger")
+        {
+            EXPECT_TRUE(manager->unregisterDevice("healthy"));
+            EXPECT_TRUE(manager->registerServo("faulty", faulty));
+        }
+    });
+
+    EXPECT_EQ(reported, std::vector<std::string>{"trigger"});
+    EXPECT_EQ(manager->getDevicesInError(), (std::vector<std::string>{"trigger", "faulty"}));
+    manager.reset(); // drop the registered devices before the engine they live in
+}
+
+TEST_F(DeviceManagerImplTest, HandlesResolveByIndexAndGeneration)
+{
+    auto motor = std::make_shared<MockMotor>("m5");
+    auto servo = std::make_shared<MockServo>("s5");
+    MotorHandle motorHandle = manager->registerMotor("m5", motor);
+    ServoHandle servoHandle = manager->registerServo("s5", servo);
+    ASSERT_TRUE(motorHandle.isValid());
+    ASSERT_TRUE(servoHandle.isValid());
+
+    EXPECT_EQ(manager->getMotor(motorHandle), motor);
+    EXPECT_EQ(manager->getServo(servoHandle), servo);
+    EXPECT_EQ(manager->findMotor("m5"), motorHandle);
+    EXPECT_EQ(manager->findServo("s5"), servoHandle);
+    EXPECT_FALSE(manager->findMotor("s5").isValid());
+    EXPECT_FALSE(manager->registerMotor("m5", motor).isValid());
+    EXPECT_EQ(manager->getMotor(MotorHandle{}), nullptr);
+}
+
+TEST_F(DeviceManagerImplTest, StaleHandleDoesNotReachReusedSlot)
+{
+    auto first = std::make_shared<MockMotor>("m6");
+    auto second = std::make_shared<MockMotor>("m7");
+    MotorHandle stale = manager->registerMotor("m6", first);
+    EXPECT_TRUE(manager->unregisterDevice("m6"));
+    EXPECT_EQ(manager->getMotor(stale), nullptr);
+
+    MotorHandle fresh = manager->registerMotor("m7", second);
+    EXPECT_EQ(fresh.index(), stale.index()); // the slot is reused...
+    EXPECT_NE(fresh.generation(), stale.generation());
+    EXPECT_EQ(manager->getMotor(stale), nullptr); // ...but the old handle stays dead
+    EXPECT_EQ(manager->getMotor(fresh), second);
+}
+
+TEST_F(DeviceManagerImplTest, ApplyBatchAppliesEveryCommand)
+{
+    SimulationEngine engine;
+    auto motor = std::make_shared<MockMotor>("bm", engine);
+    auto servo = std::make_shared<MockServo>("bs", engine);
+    CommandBatch batch;
+    batch.add(manager->registerMotor("bm", motor), MotorCommand::speed(300));
+    batch.add(manager->registerServo("bs", servo), ServoCommand::angle(45));
+    batch.add(manager->findServo("bs"), ServoCommand::speed(80));
+
+    EXPECT_TRUE(manager->applyBatch(batch));
+    EXPECT_TRUE(motor->isMoving());
+    EXPECT_TRUE(servo->isMoving());
+    EXPECT_EQ(servo->getCurrentSpeed(), 80);
+    engine.advance(std::chrono::seconds(5));
+    EXPECT_EQ(motor->getCurrentSpeed(), 300);
+    EXPECT_NEAR(servo->getAngle(), 45.0, 1.0);
+    manager.reset();
+}
+
+TEST_F(DeviceManagerImplTest, ApplyBatchIsAllOrNothing)
+{
+    SimulationEngine engine;
+    auto motor = std::make_shared<MockMotor>("bm", engine);
+    auto servo = std::make_shared<MockServo>("bs", engine);
+    MotorHandle motorHandle = manager->registerMotor("bm", motor);
+    ServoHandle servoHandle = manager->registerServo("bs", servo);
+
+    CommandBatch rejected;
+    rejected.add(motorHandle, MotorCommand::speed(300));
+    rejected.add(servoHandle, ServoCommand::angle(200)); // beyond the angle limits
+    EXPECT_FALSE(manager->applyBatch(rejected));
+    EXPECT_FALSE(motor->isMoving());
+    EXPECT_FALSE(servo->isError()); // a rejected batch leaves no trace on the devices
+
+    CommandBatch stale;
+    stale.add(motorHandle, MotorCommand::speed(300));
+    stale.add(ServoHandle(servoHandle.index(), servoHandle.generation() + 1), ServoCommand::stop());
+    EXPECT_FALSE(manager->applyBatch(stale));
+    EXPECT_FALSE(motor->isMoving());
+    manager.reset();
+}
+
+TEST_F(DeviceManagerImplTest, ApplyBatchRefusesCommandsAfterEmergencyStop)
+{
+    SimulationEngine engine;
+    auto motor = std::make_shared<MockMotor>("bm", engine);
+    MotorHandle handle = manager->registerMotor("bm", motor);
+
+    // Each command passes its check alone, but the speed would fail once the stop had latched the error
+    CommandBatch stopThenMove;
+    stopThenMove.add(handle, MotorCommand::emergencyStop());
+    stopThenMove.add(handle, MotorCommand::speed(300));
+    EXPECT_FALSE(manager->applyBatch(stopThenMove));
+    EXPECT_FALSE(motor->isError());
+
+    CommandBatch twoPositions;
+    twoPositions.add(handle, MotorCommand::position(900000));
+    twoPositions.add(handle, MotorCommand::position(1800000));
+    EXPECT_FALSE(manager->applyBatch(twoPositions));
+    EXPECT_EQ(motor->getCurrentPosition(), 0);
+
+    CommandBatch moveThenStop;
+    moveThenStop.add(handle, MotorCommand::speed(300));
+    moveThenStop.add(handle, MotorCommand::emergencyStop());
+    EXPECT_TRUE(manager->applyBatch(moveThenStop));
+    EXPECT_TRUE(motor->isError());
+    manager.reset();
+}
+
+TEST_F(DeviceManagerImplTest, EmergencyStopAllReachesEveryEngine)
+{
+    SimulationEngine left;
+    SimulationEngine right;
+    std::vector<std::shared_ptr<MockMotor>> motors;
+    for (int i = 0; i < 8; ++i)
+    {
+        std::string id = std::string("m").append(std::to_string(i));
+        motors.push_back(std::make_shared<MockMotor>(id, i % 2 ? left : right));
+        manager->registerMotor(id, motors.back());
+        motors.back()->setSpeed(200);
+    }
+    auto servo = std::make_shared<MockServo>("s", left);
+    manager->registerServo("s", servo);
+
+    uint64_t epoch = manager->getEmergencyStop().epoch();
+    EXPECT_TRUE(manager->emergencyStopAll());
+    EXPECT_GT(manager->getEmergencyStop().epoch(), epoch);
+    EXPECT_FALSE(manager->isAnyDeviceMoving());
+    for (auto &motor : motors)
+        EXPECT_TRUE(motor->isError());
+    EXPECT_TRUE(servo->isError());
+    manager.reset();
+}
+
+TEST_F(DeviceManagerImplTest, EmergencyStopAllLeavesOtherManagersAlone)
+{
+    SimulationEngine engine;
+    engine.watchEmergencyStop(&manager->getEmergencyStop());
+    auto mine = std::make_shared<MockMotor>("mine", engine);
+    manager->registerMotor("mine", mine);
+
+    SimulationEngine otherEngine;
+    DeviceManagerImpl other;
+    otherEngine.watchEmergencyStop(&other.getEmergencyStop());
+    auto theirs = std::make_shared<MockMotor>("theirs", otherEngine);
+    other.registerMotor("theirs", theirs);
+    theirs->setSpeed(200);
+    otherEngine.advance(std::chrono::milliseconds(200));
+
+    uint64_t otherEpoch = other.getEmergencyStop().epoch();
+    EXPECT_TRUE(manager->emergencyStopAll());
+    otherEngine.advance(otherEngine.getTickPeriod());
+    EXPECT_TRUE(mine->isError());
+    EXPECT_EQ(other.getEmergencyStop().epoch(), otherEpoch);
+    EXPECT_TRUE(theirs->isMoving());
+    EXPECT_FALSE(theirs->isError());
+    manager.reset();
+}
+
+TEST_F(DeviceManagerImplTest, EmergencyStopAllSkipsUnregisteredDevices)
+{
+    SimulationEngine engine;
+    auto kept = std::make_shared<MockMotor>("kept", engine);
+    auto dropped = std::make_shared<MockMotor>("dropped", engine);
+    manager->registerMotor("kept", kept);
+    manager->registerMotor("dropped", dropped);
+    EXPECT_TRUE(manager->unregisterDevice("dropped"));
+
+    // The engine is not ticking, so only the manager itself can latch the errors
+    EXPECT_TRUE(manager->emergencyStopAll());
+    EXPECT_TRUE(kept->isError());
+    EXPECT_FALSE(dropped->isError());
+    EXPECT_TRUE(manager->unregisterDevice("kept"));
+    EXPECT_FALSE(manager->emergencyStopAll());
+    manager.reset();
+}
+
+namespace
+{
+
+// A device without a batch domain whose emergency stop takes a while, as a serial round-trip would
+class SlowStopMotor : public MockMotor
+{
+  public:
+    using MockMotor::MockMotor;
+    BatchDomain *getBatchDomain() override
+    {
+        return nullptr;
+    }
+    bool applyCommand(const MotorCommand &command) override
+    {
+        // Not under a domain hold, so through the locking entry point
+        if (command.type != MotorCommand::Type::EmergencyStop)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return emergencyStop();
+    }
+};
+
+} // namespace
+
+TEST_F(DeviceManagerImplTest, EmergencyStopAllStopsDevicesWithoutADomainInParallel)
+{
+    std::vector<std::shared_ptr<SlowStopMotor>> motors;
+    for (int i = 0; i < 6; ++i)
+    {
+        std::string id = std::string("slow").append(std::to_string(i));
+        motors.push_back(std::make_shared<SlowStopMotor>(id));
+        manager->registerMotor(id, motors.back());
+    }
+    auto fast = std::make_shared<MockMotor>("fast");
+    manager->registerMotor("fast", fast);
+
+    const auto begin = std::chrono::steady_clock::now();
+    EXPECT_TRUE(manager->emergencyStopAll());
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    // One after another they would take 600ms
+    EXPECT_LT(elapsed, std::chrono::milliseconds(400));
+    for (auto &motor : motors)
+        EXPECT_TRUE(motor->isError());
+    EXPECT_TRUE(fast->isError());
+
+    // The workers persist, so a second stop runs on them as well
+    EXPECT_TRUE(manager->emergencyStopAll());
+}
+
+namespace
+{
+
+// A controller that does not publish its flags, so the manager has to poll it
+class PolledMotor : public MockMotor
+{
+  public:
+    using MockMotor::MockMotor;
+    StatusPublisher *getStatusPublisher() override
+    {
+        return nullptr;
+    }
+};
+
+// A controller with no batch domain, so nothing holds it across a batch
+class UnbatchedMotor : public MockMotor
+{
+  public:
+    using MockMotor::MockMotor;
+    BatchDomain *getBatchDomain() override
+    {
+        return nullptr;
+    }
+};
+
+} // namespace
+
+TEST_F(DeviceManagerImplTest, ApplyBatchTakesUnbatchedDevicesOnlyAlone)
+{
+    SimulationEngine engine;
+    auto unbatched = std::make_shared<UnbatchedMotor>("unbatched", engine);
+    auto batched = std::make_shared<MockMotor>("batched", engine);
+    MotorHandle unbatchedHandle = manager->registerMotor("unbatched", unbatched);
+    MotorHandle batchedHandle = manager->registerMotor("batched", batched);
+
+    CommandBatch mixed;
+    mixed.add(batchedHandle, MotorCommand::speed(300));
+    mixed.add(unbatchedHandle, MotorCommand::speed(300));
+    EXPECT_FALSE(manager->applyBatch(mixed));
+    EXPECT_FALSE(batched->isMoving());
+
+    CommandBatch alone;
+    alone.add(unbatchedHandle, MotorCommand::speed(300));
+    EXPECT_TRUE(manager->applyBatch(alone));
+    EXPECT_TRUE(unbatched->isMoving());
+    manager.reset();
+}
+
+TEST_F(DeviceManagerImplTest, HealthQueriesUseStatusBoardAndPollTheRest)
+{
+    SimulationEngine engine;
+    auto published = std::make_shared<MockMotor>("published", engine);
+    auto polled = std::make_shared<PolledMotor>("polled", engine);
+    auto servo = std::make_shared<MockServo>("servo", engine);
+    manager->registerMotor("published", published);
+    manager->registerMotor("polled", polled);
+    manager->registerServo("servo", servo);
+    EXPECT_FALSE(manager->isAnyDeviceMoving());
+    EXPECT_FALSE(manager->isAnyDeviceInError());
+
+    polled->setSpeed(100);
+    EXPECT_TRUE(manager->isAnyDeviceMoving());
+    polled->stop();
+    servo->setAngleChecked(90.05); // within the arrival threshold of where it stands
+    EXPECT_TRUE(manager->isAnyDeviceMoving());
+    engine.advance(engine.getTickPeriod()); // the servo arrives and the engine publishes it
+    EXPECT_FALSE(manager->isAnyDeviceMoving());
+
+    polled->simulateError("polled");
+    servo->simulateError("servo");
+    published->simulateError("published");
+    auto errors = manager->getDevicesInError();
+    std::sort(errors.begin(), errors.end());
+    EXPECT_EQ(errors, (std::vector<std::string>{"polled", "published", "servo"}));
+
+    EXPECT_TRUE(manager->unregisterDevice("published"));
+    EXPECT_TRUE(manager->unregisterDevice("servo"));
+    polled->clearError();
+    EXPECT_FALSE(manager->isAnyDeviceInError()); // unregistered devices leave the board
+    manager.reset();
+}
+
+TEST_F(DeviceManagerImplTest, WaitAnyErrorWakesOnFault)
+{
+    auto motor = std::make_shared<MockMotor>("m9");
+    auto servo = std::make_shared<MockServo>("s9");
+    manager->registerMotor("m9", motor);
+    manager->registerServo("s9", servo);
+    EXPECT_FALSE(manager->waitAnyError(std::chrono::milliseconds(5)));
+
+    std::thread fault([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        servo->simulateError("jammed");
+    });
+    EXPECT_TRUE(manager->waitAnyError(std::chrono::seconds(5)));
+    fault.join();
+
+    // Already in error: returns without waiting
+    EXPECT_TRUE(manager->waitAnyError(std::chrono::nanoseconds(0)));
+}
+
+TEST_F(DeviceManagerImplTest, ShutdownAllStopsStandaloneEngines)
+{
+    SimulationEngine shared;
+    shared.start();
+    auto standalone = std::make_shared<MockMotor>("m10");
+    auto attached = std::make_shared<MockServo>("s10", shared);
+    manager->registerMotor("m10", standalone);
+    manager->registerServo("s10", attached);
+
+    EXPECT_TRUE(manager->shutdownAll());
+    auto *engine = dynamic_cast<SimulationEngine *>(standalone->getBatchDomain());
+    ASSERT_NE(engine, nullptr);
+    EXPECT_FALSE(engine->isRunning());
+    EXPECT_TRUE(shared.isRunning()); // not the mock's to stop
+    manager.reset(); // the servo must go before the engine it is attached to
+    attached.reset();
+}
+
+TEST_F(DeviceManagerImplTest, InitializeAllRestartsStandaloneEngines)
+{
+    auto motor = std::make_shared<MockMotor>("m11");
+    auto servo = std::make_shared<MockServo>("s11");
+    manager->registerMotor("m11", motor);
+    manager->registerServo("s11", servo);
+    EXPECT_TRUE(manager->initializeAll());
+    EXPECT_TRUE(manager->shutdownAll());
+    EXPECT_TRUE(manager->initializeAll());
+
+    auto *engine = dynamic_cast<SimulationEngine *>(motor->getBatchDomain());
+    ASSERT_NE(engine, nullptr);
+    EXPECT_TRUE(engine->isRunning());
+    motor->simulateHardwareDelay(std::chrono::milliseconds(0));
+    EXPECT_TRUE(motor->setSpeed(200));
+    EXPECT_TRUE(servo->setAngle(uint16_t{120}));
+    // Only a running engine moves them
+    for (int i = 0; i < 500 && (motor->getCurrentSpeed() == 0 || servo->getCurrentAngle() == 90); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_GT(motor->getCurrentSpeed(), 0);
+    EXPECT_GT(servo->getCurrentAngle(), 90);
+}
+
+TEST_F(DeviceManagerImplTest, LooksUpByStringView)
+{
+    auto motor = std::make_shared<MockMotor>("index_finger");
+    manager->registerMotor("index_finger", motor);
+    const std::string path = "left/index_finger";
+    const std::string_view id = std::string_view(path).substr(5);
+    EXPECT_EQ(manager->getMotor(id), motor);
+    EXPECT_TRUE(manager->findMotor(id).isValid());
+    EXPECT_FALSE(manager->findMotor(std::string_view(path)).isValid());
+    EXPECT_TRUE(manager->unregisterDevice(id));
+    EXPECT_EQ(manager->getMotor(id), nullptr);
+}
+
+TEST_F(DeviceManagerImplTest, FillsCallerBuffersInPlace)
+{
+    auto m1 = std::make_shared<MockMotor>("m1");
+    auto m2 = std::make_shared<MockMotor>("m2");
+    auto s1 = std::make_shared<MockServo>("s1");
+    manager->registerMotor("m1", m1);
+    manager->registerMotor("m2", m2);
+    manager->registerServo("s1", s1);
+
+    std::vector<std::string> ids;
+    auto motors = manager->fillMotorIds(ids);
+    std::vector<std::string> sorted(motors.begin(), motors.end());
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_EQ(sorted, (std::vector<std::string>{"m1", "m2"}));
+
+    // The same buffer again: one id fits, the spare entry is kept and cleared
+    const std::string *storage = ids.data();
+    auto servos = manager->fillServoIds(ids);
+    ASSERT_EQ(servos.size(), 1u);
+    EXPECT_EQ(servos[0], "s1");
+    EXPECT_EQ(ids.size(), 2u);
+    EXPECT_TRUE(ids[1].empty());
+    EXPECT_EQ(ids.data(), storage);
+
+    EXPECT_TRUE(manager->fillDevicesInError(ids).empty());
+    m2->simulateError("stalled");
+    auto errors = manager->fillDevicesInError(ids);
+    ASSERT_EQ(errors.size(), 1u);
+    EXPECT_EQ(errors[0], "m2");
+
+    size_t visited = 0;
+    manager->forEachMotorId([&](std::string_view) { ++visited; });
+    EXPECT_EQ(visited, 2u);
+}
@@ -0,0 +1,97 @@
+#include "../src/core/DeviceStatus.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace FingerFlexAid;
+
+namespace
+{
+
+class Device : public StatusPublisher
+{
+};
+
+} // namespace
+
+TEST(DeviceStatusBoardTest, CountsFollowFlips)
+{
+    DeviceStatusBoard board(256);
+    board.setError(3, true);
+    board.setError(3, true); // idempotent
+    board.setError(130, true);
+    board.setMoving(7, true);
+    EXPECT_EQ(board.getErrorCount(), 2u);
+    EXPECT_TRUE(board.anyMoving());
+
+    std::vector<uint32_t> errors;
+    board.forEachError([&](uint32_t index) { errors.push_back(index); });
+    EXPECT_EQ(errors, (std::vector<uint32_t>{3, 130}));
+
+    board.setError(3, false);
+    board.clear(7);
+    board.clear(130);
+    EXPECT_FALSE(board.anyError());
+    EXPECT_FALSE(board.anyMoving());
+}
+
+TEST(DeviceStatusBoardTest, PublisherFeedsEveryBoard)
+{
+    DeviceStatusBoard first(64);
+    DeviceStatusBoard second(64);
+    Device device;
+    device.publishError(true); // before subscribing: picked up on subscribe
+    device.subscribe(first, 1);
+    device.subscribe(second, 9);
+    EXPECT_TRUE(first.anyError());
+    EXPECT_TRUE(second.anyError());
+
+    device.publishMoving(true);
+    device.unsubscribe(second, 9);
+    EXPECT_FALSE(second.anyError());
+    device.publishError(false);
+    EXPECT_FALSE(first.anyError());
+    EXPECT_TRUE(first.anyMoving());
+    EXPECT_FALSE(second.anyMoving());
+    device.unsubscribe(first, 1);
+}
+
+TEST(StatusPublisherTest, WaitsWakeOnFlip)
+{
+    Device device;
+    device.publishMoving(true);
+    std::thread stopper([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        device.publishMoving(false);
+        device.publishError(true);
+    });
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(device.waitUntilStopped(std::chrono::seconds(5)));
+    EXPECT_TRUE(device.waitForError(std::chrono::seconds(5)));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    stopper.join();
+}
+
+TEST(StatusPublisherTest, WaitsTimeOut)
+{
+    Device device;
+    device.publishMoving(true);
+    EXPECT_FALSE(device.waitUntilStopped(std::chrono::milliseconds(10)));
+    EXPECT_FALSE(device.waitForError(std::chrono::nanoseconds(0)));
+    device.publishMoving(false);
+    EXPECT_TRUE(device.waitUntilStopped(std::chrono::nanoseconds(0)));
+}
+
+TEST(StatusPublisherTest, ListenersHearFlipsUntilRemoved)
+{
+    Device device;
+    std::vector<std::pair<bool, bool>> heard;
+    const uint64_t id = device.addStatusListener([&](bool error, bool moving) { heard.emplace_back(error, moving); });
+    device.publishMoving(true);
+    device.publishMoving(true); // unchanged: not a flip
+    device.publishError(true);
+    device.removeStatusListener(id);
+    device.publishError(false);
+    EXPECT_EQ(heard, (std::vector<std::pair<bool, bool>>{{false, true}, {true, true}}));
+}
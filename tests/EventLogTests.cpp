@@ -0,0 +1,99 @@
+#include "utils/EventLog.hpp"
+#include <gtest/gtest.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace FingerFlexAid;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+struct Capture
+{
+    std::mutex mutex;
+    std::vector<LogRecord> records;
+
+    EventLog::Sink sink()
+    {
+        return [this](const LogRecord &record) {
+            std::lock_guard<std::mutex> lock(mutex);
+            records.push_back(record);
+        };
+    }
+};
+
+} // namespace
+
+TEST(EventLogTest, DeliversRecordsInOrder)
+{
+    Capture capture;
+    EventLog log(16, capture.sink());
+    EXPECT_TRUE(log.log(LogSource::Motor, 3, LogCode::DeviceError, 42));
+    EXPECT_TRUE(log.log(LogSource::Servo, 1, LogCode::DeviceRecovered));
+    log.flush();
+
+    ASSERT_EQ(capture.records.size(), 2u);
+    EXPECT_EQ(capture.records[0].source, LogSource::Motor);
+    EXPECT_EQ(capture.records[0].device, 3u);
+    EXPECT_EQ(capture.records[0].detail, 42u);
+    EXPECT_EQ(capture.records[1].code, LogCode::DeviceRecovered);
+    EXPECT_LE(capture.records[0].timestamp, capture.records[1].timestamp);
+    EXPECT_NE(EventLog::format(capture.records[0]).find("motor 3 reports error (42)"), std::string::npos);
+}
+
+TEST(EventLogTest, CarriesTheDeviceId)
+{
+    Capture capture;
+    EventLog log(16, capture.sink());
+    EXPECT_TRUE(log.log(LogSource::Servo, 2, LogCode::DeviceError, 0, "index_finger"));
+    EXPECT_TRUE(log.log(LogSource::Motor, 0, LogCode::DeviceError, 0, std::string(40, 'x')));
+    log.flush();
+
+    ASSERT_EQ(capture.records.size(), 2u);
+    EXPECT_STREQ(capture.records[0].id, "index_finger");
+    EXPECT_NE(EventLog::format(capture.records[0]).find("servo 2 \"index_finger\" reports error"), std::string::npos);
+    // Truncated, leaving room for the terminator
+    EXPECT_EQ(std::string(capture.records[1].id), std::string(LogRecord::kIdLength - 1, 'x'));
+}
+
+TEST(EventLogTest, DropsAndCountsWhenFull)
+{
+    Capture capture;
+    // A drain period far beyond the test, so nothing frees the ring while it is being filled
+    EventLog log(8, capture.sink(), std::chrono::hours(1));
+    EXPECT_EQ(log.getCapacity(), 8u);
+    for (uint32_t i = 0; i < 20; ++i)
+        log.log(LogSource::System, i, LogCode::EmergencyStop);
+
+    EXPECT_GT(log.getDroppedCount(), 0u);
+    EXPECT_EQ(log.getLoggedCount() + log.getDroppedCount(), 20u);
+    log.flush();
+    EXPECT_EQ(capture.records.size(), log.getLoggedCount());
+}
+
+TEST(EventLogTest, ConcurrentProducersKeepTheirOrder)
+{
+    constexpr uint32_t kProducers = 4;
+    constexpr uint32_t kRecords = 1000;
+    Capture capture;
+    {
+        EventLog log(kProducers * kRecords, capture.sink(), 1ms);
+        std::vector<std::thread> producers;
+        for (uint32_t p = 0; p < kProducers; ++p)
+            producers.emplace_back([&log, p] {
+                for (uint32_t i = 0; i < kRecords; ++i)
+                    log.log(LogSource::Motor, p, LogCode::DeviceError, i);
+            });
+        for (auto &producer : producers)
+            producer.join();
+        EXPECT_EQ(log.getDroppedCount(), 0u);
+    } // the destructor drains what is left
+
+    ASSERT_EQ(capture.records.size(), kProducers * kRecords);
+    std::vector<uint32_t> next(kProducers, 0);
+    for (const auto &record : capture.records)
+        EXPECT_EQ(record.detail, next[record.device]++);
+}
@@ -0,0 +1,166 @@
+#include "mock/ActuatorStore.hpp"
+#include "utils/FixedPoint.hpp"
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <vector>
+
+using namespace FingerFlexAid;
+
+static_assert(Fixed::fromInt(3).raw == 3 * 65536);
+static_assert(Fixed::fromInt(-2) + Fixed::fromRatio(1, 2) == Fixed::fromRatio(-3, 2));
+static_assert((Fixed::fromInt(6) * Fixed::fromRatio(1, 4)).round() == 2); // 1.5 rounds away from zero
+static_assert((Fixed::fromInt(-6) * Fixed::fromRatio(1, 4)).round() == -2);
+
+TEST(FixedPointTest, RoundsToNearestStep)
+{
+    EXPECT_EQ(Fixed::fromDouble(0.1).raw, 6554); // 6553.6
+    EXPECT_EQ(Fixed::fromDouble(-0.1).raw, -6554);
+    EXPECT_EQ(Fixed::fromRatio(1, 10), Fixed::fromDouble(0.1));
+    EXPECT_EQ(Fixed::fromDouble(123.25).toDouble(), 123.25);
+    EXPECT_EQ(Fixed::fromDouble(89.5).round(), 90);
+    EXPECT_EQ(Fixed::fromDouble(89.4999).round(), 89);
+    EXPECT_EQ((Fixed::fromInt(1) / Fixed::fromInt(3)).raw, 21845);
+    EXPECT_EQ((Fixed::fromInt(-1) / Fixed::fromInt(3)).raw, -21845);
+}
+
+TEST(FixedPointTest, FromDoubleSaturates)
+{
+    EXPECT_EQ(Fixed::fromDouble(40000.0).raw, INT32_MAX);
+    EXPECT_EQ(Fixed::fromDouble(-40000.0).raw, INT32_MIN);
+    EXPECT_EQ(Fixed::fromDouble(HUGE_VAL).raw, INT32_MAX);
+    EXPECT_EQ(Fixed::fromDouble(-HUGE_VAL).raw, INT32_MIN);
+    EXPECT_EQ(Fixed::fromDouble(NAN).raw, 0);
+    EXPECT_EQ(Fixed::fromDouble(32767.99999).raw, INT32_MAX);
+}
+
+TEST(FixedPointTest, SineStaysCloseToTheLibrary)
+{
+    for (int tenths = 0; tenths <= 1800; ++tenths)
+    {
+        const Fixed degrees = Fixed::fromRatio(tenths, 10);
+        EXPECT_NEAR(sinDegrees(degrees).toDouble(), std::sin(M_PI * degrees.toDouble() / 180.0), 0.002) << tenths;
+    }
+    EXPECT_EQ(sinDegrees(Fixed::fromInt(0)).raw, 0);
+    EXPECT_EQ(sinDegrees(Fixed::fromInt(90)), Fixed::fromInt(1));
+    EXPECT_EQ(sinDegrees(Fixed::fromInt(-10)).raw, 0);
+}
+
+// The servo kernel is pure integer arithmetic, so these bits are what the bridge firmware has to produce
+TEST(FixedPointTest, ServoStepIsPinnedToTheBit)
+{
+    ServoStateStore store;
+    const uint32_t slot = store.acquire();
+    store.targetAngle[slot] = Fixed::fromInt(30);
+    store.moving[slot] = 1;
+
+    store.advance(ServoStateStore::kUpdatePeriod);
+    EXPECT_EQ(store.currentAngle[slot].raw, 5614840);
+    for (int i = 0; i < 49; ++i)
+        store.advance(ServoStateStore::kUpdatePeriod);
+    EXPECT_EQ(store.currentAngle[slot].raw, 2074493);
+}
+
+// Likewise for the motor kernel, which works in whole counts
+TEST(FixedPointTest, MotorStepIsPinnedToTheBit)
+{
+    MotorStateStore store;
+    const uint32_t slot = store.acquire();
+    store.targetSpeed[slot] = -700;
+    store.moving[slot] = 1;
+
+    store.step();
+    EXPECT_EQ(store.currentSpeed[slot], -4);
+    EXPECT_EQ(store.currentPosition[slot], 0);
+    for (int i = 0; i < 49; ++i)
+        store.step();
+    EXPECT_EQ(store.currentSpeed[slot], -176);
+    EXPECT_EQ(store.currentPosition[slot], -329);
+}
+
+// The kernel divides through per-slot reciprocals; it must still truncate exactly as integer division does,
+// across the whole range of speeds and maxima a motor accepts
+TEST(FixedPointTest, MotorStepMatchesIntegerDivision)
+{
+    struct Motor
+    {
+        int32_t max;
+        int32_t acceleration;
+        int32_t speed;
+        int32_t target;
+    };
+    const Motor motors[] = {{1, 1, 0, 1},           {1, 5000, 32767, -32767}, {2, 200, -3, 2},
+                            {3, 999, 0, -3},        {7, 65535, 100, 7},       {99, 4000, 0, 99},
+                            {100, 1000, -500, 100}, {999, 1000, 0, -999},     {1000, 1000, 0, 1000},
+                            {1000, 5000, 20000, 0}, {4096, 2500, 0, -4096},   {32767, 65535, 0, 32767},
+                            {32767, 65535, -32767, 32767},
+                            // Holds a speed whose position quotient is whole, where an unadjusted reciprocal
+                            // lands just below it
+                            {17, 1000, -952, -952}};
+
+    MotorStateStore store;
+    std::vector<int32_t> speed, position;
+    for (const Motor &motor : motors)
+    {
+        const uint32_t slot = store.acquire();
+        store.setMaxSpeed(slot, motor.max);
+        store.setAcceleration(slot, motor.acceleration);
+        store.currentSpeed[slot] = motor.speed;
+        store.targetSpeed[slot] = motor.target;
+        store.moving[slot] = 1;
+        speed.push_back(motor.speed);
+        position.push_back(0);
+    }
+    // Idle, faulted and released slots are left alone
+    const uint32_t idle = store.acquire();
+    store.targetSpeed[idle] = 500;
+    const uint32_t faulted = store.acquire();
+    store.targetSpeed[faulted] = 500;
+    store.moving[faulted] = 1;
+    store.error[faulted] = 1;
+    const uint32_t released = store.acquire();
+    store.targetSpeed[released] = 500;
+    store.moving[released] = 1;
+    store.release(released);
+
+    for (int step = 0; step < 3000; ++step)
+    {
+        // Positions start from zero every step, so only the step itself is compared and nothing accumulates
+        // past 32 bits
+        for (size_t i = 0; i < std::size(motors); ++i)
+            store.currentPosition[i] = position[i] = 0;
+        store.step();
+        for (size_t i = 0; i < std::size(motors); ++i)
+        {
+            const int32_t max = motors[i].max;
+            const int32_t maxStep = std::clamp(motors[i].acceleration / 200, 1, 25);
+            const int32_t diff = motors[i].target - speed[i];
+            const int32_t absDiff = std::abs(diff);
+            const int32_t scaled = maxStep * (max + std::min(absDiff, max)) / (2 * max);
+            const int32_t stepSize = std::min(std::max(scaled, 1), std::min(absDiff, 25));
+            speed[i] += diff > 0 ? stepSize : -stepSize;
+            position[i] += static_cast<int32_t>(int64_t{speed[i]} * (7 * int64_t{max} + 3 * int64_t{std::abs(speed[i])}) /
+                                                (100 * int64_t{max}));
+            ASSERT_EQ(store.currentSpeed[i], speed[i]) << "motor " << i << ", step " << step;
+            ASSERT_EQ(store.currentPosition[i], position[i]) << "motor " << i << ", step " << step;
+        }
+    }
+    EXPECT_EQ(store.currentSpeed[idle], 0);
+    EXPECT_EQ(store.currentSpeed[faulted], 0);
+    EXPECT_EQ(store.currentPosition[faulted], 0);
+    EXPECT_EQ(store.currentSpeed[released], 0);
+}
+
+TEST(FixedPointTest, ServoAlwaysArrives)
+{
+    ServoStateStore store;
+    const uint32_t slot = store.acquire();
+    store.targetAngle[slot] = Fixed::fromDouble(90.2); // barely more than the arrival threshold away
+    store.moving[slot] = 1;
+
+    for (int i = 0; i < 100000 && store.moving[slot]; ++i)
+        store.advance(ServoStateStore::kUpdatePeriod);
+    EXPECT_FALSE(store.moving[slot]);
+    EXPECT_EQ(store.currentAngle[slot], Fixed::fromDouble(90.2));
+}
@@ -1,8 +1,12 @@
 #include "mock/MockMotor.hpp"
 #include "mock/MockServo.hpp"
+#include "mock/SimulationEngine.hpp"
 #include "models/GloveState.hpp"
+#include "models/StaticGlove.hpp"
 #include <gtest/gtest.h>
 #include <memory>
+#include <stdexcept>
+#include <vector>
 
 using namespace FingerFlexAid;
 
@@ -31,3 +35,169 @@ TEST(GloveStateTest, ErrorDetection)
     s1->simulateError(false);
     EXPECT_FALSE(glove.hasError());
 }
+
+TEST(GloveStateTest, ErrorsArePublishedByEveryDeviceKind)
+{
+    auto motor = std::make_shared<Motor>("real", 1000, 10);
+    auto mock = std::make_shared<MockMotor>("mock");
+    auto servo = std::make_shared<ServoImpl>(0, 180, 50);
+    {
+        GloveState glove;
+        glove.addMotor(motor);
+        glove.addMotor(mock);
+        glove.addServo(servo);
+        motor->simulateError("stalled");
+        EXPECT_TRUE(glove.hasError());
+        motor->clearError();
+        EXPECT_FALSE(glove.hasError());
+
+        // The mock's state lives in its engine, which publishes it
+        mock->emergencyStop();
+        EXPECT_TRUE(glove.hasError());
+        mock->clearError();
+
+        servo->simulateError(true);
+        servo->setAngle(10);
+        EXPECT_TRUE(glove.hasError());
+        servo->simulateError(false);
+        EXPECT_FALSE(glove.hasError());
+    }
+    // Devices outlive the glove and keep working once it has unsubscribed
+    mock->simulateError("after");
+    EXPECT_TRUE(mock->isError());
+}
+
+TEST(GloveStateTest, UpdateLogsDeviceErrors)
+{
+    std::vector<LogRecord> records;
+    EventLog log(64, [&records](const LogRecord &record) { records.push_back(record); });
+    auto motor = std::make_shared<Motor>("real", 1000, 10);
+    auto servo = std::make_shared<ServoImpl>(0, 180, 50);
+    GloveState glove(log);
+    glove.addMotor(motor);
+    glove.addServo(servo);
+
+    glove.update();
+    motor->simulateError("stalled");
+    glove.update();
+    log.flush();
+
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].source, LogSource::Motor);
+    EXPECT_EQ(records[0].device, 0u);
+    EXPECT_EQ(records[0].code, LogCode::DeviceError);
+}
+
+TEST(GloveStateTest, UpdateLogsOnlyErrorEdges)
+{
+    std::vector<LogRecord> records;
+    EventLog log(64, [&records](const LogRecord &record) { records.push_back(record); });
+    auto motor = std::make_shared<Motor>("real", 1000, 10);
+    auto servo = std::make_shared<ServoImpl>(0, 180, 50);
+    GloveState glove(log);
+    glove.addMotor(motor);
+    glove.addServo(servo);
+
+    motor->simulateError("stalled");
+    servo->simulateError(true);
+    servo->setAngle(10);
+    for (int tick = 0; tick < 5; ++tick)
+        glove.update();
+    motor->clearError();
+    servo->simulateError(false);
+    glove.update();
+    glove.update();
+    log.flush();
+
+    ASSERT_EQ(records.size(), 4u);
+    EXPECT_EQ(records[0].source, LogSource::Motor);
+    EXPECT_EQ(records[0].code, LogCode::DeviceError);
+    EXPECT_EQ(records[1].source, LogSource::Servo);
+    EXPECT_EQ(records[1].code, LogCode::DeviceError);
+    EXPECT_EQ(records[2].source, LogSource::Motor);
+    EXPECT_EQ(records[2].code, LogCode::DeviceRecovered);
+    EXPECT_EQ(records[3].source, LogSource::Servo);
+    EXPECT_EQ(records[3].code, LogCode::DeviceRecovered);
+}
+
+TEST(GloveStateTest, UpdateLogsMockMotorFaultsWithTheirId)
+{
+    std::vector<LogRecord> records;
+    EventLog log(64, [&records](const LogRecord &record) { records.push_back(record); });
+    auto first = std::make_shared<MockMotor>("thumb");
+    auto second = std::make_shared<MockMotor>("index_finger");
+    GloveState glove(log);
+    glove.addMotor(first);
+    glove.addMotor(second);
+
+    // Through a Motor pointer, where the non-virtual Motor::isError() would miss it
+    second->simulateError("stalled");
+    EXPECT_TRUE(glove.hasError());
+    glove.update();
+    log.flush();
+
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].source, LogSource::Motor);
+    EXPECT_EQ(records[0].device, 1u);
+    EXPECT_STREQ(records[0].id, "index_finger");
+    EXPECT_EQ(records[0].detail, static_cast<uint32_t>(second->getLastErrorRecord().code));
+}
+
+namespace
+{
+
+using MockFinger = Finger<MockMotor, MockServo>;
+using ModelFinger = Finger<Motor, ServoImpl>;
+
+class SubclassedMotor : public MockMotor
+{
+  public:
+    using MockMotor::MockMotor;
+};
+
+} // namespace
+
+TEST(StaticGloveTest, CommandsAndReportsEveryFinger)
+{
+    SimulationEngine engine;
+    MockMotor thumbMotor("thumb", engine);
+    MockServo thumbServo("thumb_servo", engine);
+    thumbMotor.simulateHardwareDelay(std::chrono::milliseconds(0));
+    Motor indexMotor("index", 1000, 10);
+    ServoImpl indexServo(0, 180, 50);
+
+    std::vector<LogRecord> records;
+    EventLog log(64, [&records](const LogRecord &record) { records.push_back(record); });
+    StaticGlove<MockFinger, ModelFinger> glove(log, MockFinger{thumbMotor, thumbServo},
+                                               ModelFinger{indexMotor, indexServo});
+    static_assert(decltype(glove)::kFingers == 2);
+
+    glove.command({300, 200}, {120, 45});
+    EXPECT_TRUE(thumbMotor.isMoving());
+    EXPECT_EQ(indexMotor.getSpeed(), 200);
+    EXPECT_EQ(indexServo.getAngle(), 45);
+    EXPECT_FALSE(glove.hasError());
+
+    indexMotor.simulateError("stalled");
+    EXPECT_TRUE(glove.hasError());
+    glove.update();
+    log.flush();
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].source, LogSource::Motor);
+    EXPECT_EQ(records[0].device, 1u);
+    EXPECT_EQ(records[0].detail, static_cast<uint32_t>(ErrorCode::Text));
+
+    glove.reset();
+    EXPECT_FALSE(glove.hasError());
+    EXPECT_EQ(indexMotor.getSpeed(), 0);
+    EXPECT_FALSE(thumbMotor.isMoving());
+}
+
+TEST(StaticGloveTest, RejectsDevicesOfAnotherDynamicType)
+{
+    SimulationEngine engine;
+    SubclassedMotor motor("motor", engine);
+    MockServo servo("servo", engine);
+    using Glove = StaticGlove<MockFinger>;
+    EXPECT_THROW(Glove glove(MockFinger{motor, servo}), std::invalid_argument);
+}
@@ -1,4 +1,5 @@
 #include "../src/mock/MockMotor.hpp"
+#include "../src/mock/SimulationEngine.hpp"
 #include "../src/models/Motor.hpp"
 #include <chrono>
 #include <gtest/gtest.h>
@@ -12,7 +13,7 @@ class MockMotorTest : public ::testing::Test
   protected:
     void SetUp() override
     {
-        motor = std::make_unique<MockMotor>("test_motor");
+        motor = std::make_unique<MockMotor>("test_motor", engine);
     }
 
     void TearDown() override
@@ -20,6 +21,8 @@ class MockMotorTest : public ::testing::Test
         motor.reset();
     }
 
+    // Manually stepped, so the tests advance simulated time instead of sleeping
+    SimulationEngine engine;
     std::unique_ptr<MockMotor> motor;
 };
 
@@ -39,12 +42,12 @@ TEST_F(MockMotorTest, SetSpeed)
     EXPECT_TRUE(motor->setSpeed(500));
     EXPECT_TRUE(motor->isMoving());
 
-    std::this_thread::sleep_for(100ms);
+    engine.advance(100ms);
     int16_t speedAfterShortTime = motor->getCurrentSpeed();
     EXPECT_GT(speedAfterShortTime, 0);
     EXPECT_LT(speedAfterShortTime, 500);
 
-    std::this_thread::sleep_for(5000ms);
+    engine.advance(5000ms);
     int16_t speedAfterLongTime = motor->getCurrentSpeed();
     EXPECT_NEAR(speedAfterLongTime, 500, 50);
 }
@@ -62,7 +65,7 @@ TEST_F(MockMotorTest, SetPosition)
     EXPECT_TRUE(motor->setPosition(1000));
     EXPECT_TRUE(motor->isMoving());
 
-    std::this_thread::sleep_for(100ms);
+    engine.advance(100ms);
     EXPECT_GT(motor->getCurrentPosition(), 0);
 }
 
@@ -74,7 +77,7 @@ TEST_F(MockMotorTest, Stop)
     EXPECT_TRUE(motor->stop());
     EXPECT_FALSE(motor->isMoving());
 
-    std::this_thread::sleep_for(100ms);
+    engine.advance(100ms);
     EXPECT_NEAR(motor->getCurrentSpeed(), 0, 50);
 }
 
@@ -125,7 +128,7 @@ TEST_F(MockMotorTest, SimulateHardwareDelay)
 
     // With longer delay, position should change less
     auto initialPos = motor->getCurrentPosition();
-    std::this_thread::sleep_for(100ms);
+    engine.advance(100ms);
     auto posAfterDelay = motor->getCurrentPosition();
 
     EXPECT_GT(posAfterDelay, initialPos);
@@ -136,10 +139,10 @@ TEST_F(MockMotorTest, SpeedAcceleration)
     motor->setAcceleration(500);
     EXPECT_TRUE(motor->setSpeed(1000));
 
-    std::this_thread::sleep_for(50ms);
+    engine.advance(50ms);
     auto speedAfterShortTime = motor->getCurrentSpeed();
 
-    std::this_thread::sleep_for(100ms);
+    engine.advance(100ms);
     auto speedAfterLongTime = motor->getCurrentSpeed();
 
     EXPECT_GT(speedAfterLongTime, speedAfterShortTime);
@@ -195,3 +198,48 @@ TEST(MotorModelTest, ErrorSimulationAndClearing)
     m.setSpeed(10.0);
     EXPECT_DOUBLE_EQ(m.getSpeed(), 10.0);
 }
+
+TEST(MotorModelTest, SnapshotMatchesGetters)
+{
+    Motor m("motor5", 50.0, 1.0);
+    m.setSpeed(100.0);
+    m.setPosition(12.5);
+    MotorSnapshot snapshot = m.getSnapshot();
+    EXPECT_DOUBLE_EQ(snapshot.speed, 50.0);
+    EXPECT_DOUBLE_EQ(snapshot.position, 12.5);
+    EXPECT_TRUE(snapshot.moving);
+    EXPECT_FALSE(snapshot.error);
+
+    m.simulateError("stalled");
+    snapshot = m.getSnapshot();
+    EXPECT_DOUBLE_EQ(snapshot.speed, 0.0);
+    EXPECT_FALSE(snapshot.moving);
+    EXPECT_TRUE(snapshot.error);
+}
+
+TEST(MotorModelTest, WaitForErrorWakesOnSimulatedError)
+{
+    Motor m("motor6", 50.0, 1.0);
+    EXPECT_FALSE(m.waitForError(1ms));
+    std::thread fault([&] {
+        std::this_thread::sleep_for(10ms);
+        m.simulateError("stalled");
+    });
+    EXPECT_TRUE(m.waitForError(5s));
+    fault.join();
+}
+
+TEST(MockMotorWaitTest, WaitUntilStoppedFollowsEngine)
+{
+    MockMotor motor("waiting_motor");
+    motor.simulateHardwareDelay(0ms);
+    ASSERT_TRUE(motor.setSpeed(100));
+    EXPECT_FALSE(motor.waitUntilStopped(5ms));
+    std::thread stopper([&] {
+        std::this_thread::sleep_for(10ms);
+        motor.stop();
+    });
+    EXPECT_TRUE(motor.waitUntilStopped(5s));
+    EXPECT_FALSE(motor.isMoving());
+    stopper.join();
+}
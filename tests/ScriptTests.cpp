@@ -0,0 +1,230 @@
+#include "core/Script.hpp"
+#include "mock/MockServo.hpp"
+#include "mock/SimulationEngine.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace FingerFlexAid;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+ScriptTask recordTimes(std::vector<std::chrono::nanoseconds> &times, ScriptScheduler &scheduler)
+{
+    times.push_back(scheduler.now());
+    co_await sleepFor(50ms);
+    times.push_back(scheduler.now());
+    co_await sleepFor(0ms); // no suspension
+    co_await nextTick();
+    times.push_back(scheduler.now());
+}
+
+ScriptTask waitForFlag(const bool &flag, std::chrono::nanoseconds timeout, int &result)
+{
+    result = (co_await waitUntil([&] { return flag; }, timeout)) ? 1 : 0;
+}
+
+ScriptTask addAfter(int &value, int amount, std::chrono::nanoseconds delay)
+{
+    co_await sleepFor(delay);
+    value += amount;
+}
+
+ScriptTask sequence(int &value)
+{
+    co_await addAfter(value, 1, 10ms);
+    value *= 10;
+    co_await addAfter(value, 2, 10ms);
+}
+
+ScriptTask throwAfterSleep()
+{
+    co_await sleepFor(1ms);
+    throw std::runtime_error("script failed");
+}
+
+ScriptTask catchChild(bool &caught)
+{
+    try
+    {
+        co_await throwAfterSleep();
+    }
+    catch (const std::runtime_error &)
+    {
+        caught = true;
+    }
+}
+
+struct DestroyCounter
+{
+    int &count;
+    ~DestroyCounter()
+    {
+        ++count;
+    }
+};
+
+ScriptTask sleepForever(int &destroyed)
+{
+    DestroyCounter counter{destroyed};
+    co_await waitUntil([] { return false; });
+}
+
+// "Flex index to 120 degrees, hold 2 s, release, repeat 10"
+ScriptTask flexIndex(std::shared_ptr<MockServo> index, int &repetitions)
+{
+    for (int rep = 0; rep < 10; ++rep)
+    {
+        if (!co_await moveServo(*index, 120, 5s))
+            co_return;
+        co_await sleepFor(2s);
+        if (!co_await moveServo(*index, 30, 5s))
+            co_return;
+        ++repetitions;
+    }
+}
+
+ScriptTask periodic(int &ticks, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        co_await sleepFor(1ms);
+        ++ticks;
+    }
+}
+
+} // namespace
+
+TEST(ScriptTest, SleepsResumeOnTheTickTheyExpire)
+{
+    ScriptScheduler scheduler;
+    std::vector<std::chrono::nanoseconds> times;
+    scheduler.spawn(recordTimes(times, scheduler));
+    EXPECT_TRUE(times.empty()); // nothing runs before the first tick
+
+    for (auto now = 0ms; now <= 100ms; now += 20ms)
+        scheduler.tick(now);
+    EXPECT_EQ(times, (std::vector<std::chrono::nanoseconds>{0ms, 60ms, 80ms}));
+    EXPECT_EQ(scheduler.getActiveCount(), 0u);
+    EXPECT_EQ(scheduler.getCompletedCount(), 1u);
+}
+
+TEST(ScriptTest, ConditionWaitsResumeWhenTrueOrOnTimeout)
+{
+    ScriptScheduler scheduler;
+    bool flag = false;
+    int satisfied = -1;
+    int expired = -1;
+    scheduler.spawn(waitForFlag(flag, 1s, satisfied));
+    scheduler.spawn(waitForFlag(flag, 30ms, expired));
+
+    scheduler.tick(0ms);
+    scheduler.tick(20ms);
+    EXPECT_EQ(satisfied, -1);
+    EXPECT_EQ(expired, -1);
+    scheduler.tick(40ms);
+    EXPECT_EQ(expired, 0);
+
+    flag = true;
+    scheduler.tick(60ms);
+    EXPECT_EQ(satisfied, 1);
+    EXPECT_EQ(scheduler.getActiveCount(), 0u);
+}
+
+TEST(ScriptTest, AwaitedScriptsRunInline)
+{
+    ScriptScheduler scheduler;
+    int value = 0;
+    scheduler.spawn(sequence(value));
+    for (auto now = 0ms; now <= 30ms; now += 10ms)
+        scheduler.tick(now);
+    EXPECT_EQ(value, 12);
+    EXPECT_EQ(scheduler.getCompletedCount(), 1u);
+}
+
+TEST(ScriptTest, ExceptionsPropagateToTheAwaitingScript)
+{
+    ScriptScheduler scheduler;
+    bool caught = false;
+    scheduler.spawn(catchChild(caught));
+    scheduler.spawn(throwAfterSleep());
+    scheduler.tick(0ms);
+    scheduler.tick(1ms);
+    EXPECT_TRUE(caught);
+    EXPECT_EQ(scheduler.getCompletedCount(), 1u);
+    EXPECT_EQ(scheduler.getFailedCount(), 1u);
+}
+
+TEST(ScriptTest, CancelDestroysSuspendedScripts)
+{
+    int destroyed = 0;
+    {
+        ScriptScheduler scheduler;
+        scheduler.spawn(sleepForever(destroyed));
+        scheduler.spawn(sleepForever(destroyed));
+        scheduler.tick(0ms);
+        scheduler.cancelAll();
+        EXPECT_EQ(destroyed, 2);
+        EXPECT_EQ(scheduler.getActiveCount(), 0u);
+
+        scheduler.spawn(sleepForever(destroyed));
+        scheduler.tick(1ms);
+    }
+    EXPECT_EQ(destroyed, 3); // the scheduler's destructor cancels too
+}
+
+TEST(ScriptTest, DrivesAServoThroughAnExercise)
+{
+    SimulationEngine engine;
+    auto index = std::make_shared<MockServo>("index", engine);
+    ScriptScheduler scheduler;
+    int repetitions = 0;
+    scheduler.spawn(flexIndex(index, repetitions));
+
+    // The control loop: step the devices, then resume whatever is due
+    for (int tick = 0; tick < 10000 && scheduler.getActiveCount() > 0; ++tick)
+    {
+        engine.advance(engine.getTickPeriod());
+        scheduler.tick(engine.now());
+    }
+    EXPECT_EQ(repetitions, 10);
+    EXPECT_EQ(index->getCurrentAngle(), 30);
+    EXPECT_GT(engine.now(), 20s); // ten two-second holds
+}
+
+TEST(ScriptTest, RunsThousandsOfConcurrentScripts)
+{
+    constexpr int kScripts = 5000;
+    ScriptScheduler scheduler;
+    std::vector<int> ticks(kScripts, 0);
+    for (int i = 0; i < kScripts; ++i)
+        scheduler.spawn(periodic(ticks[static_cast<size_t>(i)], 20));
+    EXPECT_EQ(scheduler.getActiveCount(), static_cast<size_t>(kScripts));
+
+    for (auto now = 0ms; now <= 25ms; now += 1ms)
+        scheduler.tick(now);
+    EXPECT_EQ(scheduler.getCompletedCount(), static_cast<uint64_t>(kScripts));
+    for (int count : ticks)
+        ASSERT_EQ(count, 20);
+}
+
+TEST(FramePoolTest, ReusesFreedFrames)
+{
+    FramePool pool;
+    void *first = pool.allocate(200);
+    pool.deallocate(first, 200);
+    void *second = pool.allocate(250); // same 256-byte class
+    EXPECT_EQ(second, first);
+    void *large = pool.allocate(4096);
+    pool.deallocate(large, 4096);
+    pool.deallocate(second, 250);
+
+    FramePoolStats stats = pool.getStats();
+    EXPECT_EQ(stats.allocations, 3u);
+    EXPECT_EQ(stats.reused, 1u);
+    EXPECT_EQ(stats.oversized, 1u);
+    EXPECT_EQ(stats.reservedBytes, 256 * FramePool::kChunkFrames);
+}
@@ -0,0 +1,69 @@
+#include "utils/Seqlock.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace FingerFlexAid;
+
+namespace
+{
+
+// Fields the writer always keeps in a fixed relation, so a torn read is detectable
+struct Triple
+{
+    uint64_t a = 0;
+    uint64_t b = 0;
+    uint64_t sum = 0;
+};
+
+} // namespace
+
+TEST(SeqlockTest, LoadReturnsLastStore)
+{
+    Seqlock<Triple> lock(Triple{1, 2, 3});
+    EXPECT_EQ(lock.load().sum, 3u);
+    EXPECT_EQ(lock.version(), 1u);
+
+    lock.store({4, 5, 9});
+    Triple value = lock.load();
+    EXPECT_EQ(value.a, 4u);
+    EXPECT_EQ(value.b, 5u);
+    EXPECT_EQ(value.sum, 9u);
+    EXPECT_EQ(lock.version(), 2u);
+}
+
+TEST(SeqlockTest, HandlesValuesSmallerThanAWord)
+{
+    Seqlock<bool> flag;
+    EXPECT_FALSE(flag.load());
+    flag.store(true);
+    EXPECT_TRUE(flag.load());
+}
+
+TEST(SeqlockTest, ReadersNeverSeeTornValues)
+{
+    Seqlock<Triple> lock;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i)
+        readers.emplace_back([&] {
+            while (!done)
+            {
+                Triple value = lock.load();
+                if (value.a + value.b != value.sum || value.b != value.a * 3)
+                    ++torn;
+            }
+        });
+
+    for (uint64_t i = 1; i <= 200000; ++i)
+        lock.store({i, i * 3, i * 4});
+    done = true;
+    for (auto &reader : readers)
+        reader.join();
+
+    EXPECT_EQ(torn, 0u);
+    EXPECT_EQ(lock.load().a, 200000u);
+}
@@ -0,0 +1,309 @@
+#include "core/DeviceManagerImpl.hpp"
+#include "core/SerialDevices.hpp"
+#include "mock/FirmwareEmulator.hpp"
+#include "utils/ByteRing.hpp"
+#include "utils/SerialLink.hpp"
+#include "utils/SerialProtocol.hpp"
+#include <algorithm>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <string_view>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace FingerFlexAid;
+
+namespace
+{
+
+std::vector<uint8_t> sampleFrame(uint8_t sequence)
+{
+    FrameWriter writer;
+    writer.begin(FrameType::Request);
+    writer.add(RecordType::MotorSetSpeed, 0, -250);
+    writer.add(RecordType::ServoSetAngle, 3, 120);
+    writer.add(RecordType::MotorRead, 1);
+    auto bytes = writer.finish(sequence);
+    return {bytes.begin(), bytes.end()};
+}
+
+struct LoopbackBridge
+{
+    LoopbackBridge(size_t motors, size_t servos)
+    {
+        int hostFd = -1;
+        emulator = FirmwareEmulator::createLoopback({motors, servos}, hostFd);
+        bus = std::make_shared<SerialBus>(SerialLink::adopt(hostFd));
+    }
+
+    std::unique_ptr<FirmwareEmulator> emulator;
+    std::shared_ptr<SerialBus> bus;
+};
+
+} // namespace
+
+TEST(SerialProtocolTest, Crc16MatchesCcittFalseCheckValue)
+{
+    std::string_view check = "123456789";
+    EXPECT_EQ(crc16({reinterpret_cast<const uint8_t *>(check.data()), check.size()}), 0x29B1);
+}
+
+TEST(SerialProtocolTest, FrameRoundTripsRecords)
+{
+    FrameWriter writer;
+    writer.begin(FrameType::Response);
+    writer.addAck(0, true);
+    writer.addMotorState(1, {-300, -123456, true, false});
+    writer.addServoState(2, {135, 40, false, true});
+    writer.add(RecordType::ServoSetAngleLimits, 4, 10 | 170 << 16);
+    EXPECT_EQ(writer.getRecordCount(), 4u);
+    auto bytes = writer.finish(42);
+
+    FrameView frame;
+    size_t consumed = 0;
+    ASSERT_EQ(parseFrame(bytes, frame, consumed), ParseStatus::Frame);
+    EXPECT_EQ(consumed, bytes.size());
+    EXPECT_EQ(frame.type, FrameType::Response);
+    EXPECT_EQ(frame.sequence, 42);
+    EXPECT_EQ(frame.payload.size(), writer.getPayloadSize());
+
+    RecordReader reader(frame.payload);
+    Record record;
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.type, RecordType::Ack);
+    EXPECT_EQ(record.value, 1);
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.device, 1);
+    EXPECT_EQ(record.motor.speed, -300);
+    EXPECT_EQ(record.motor.position, -123456);
+    EXPECT_TRUE(record.motor.moving);
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.servo.angle, 135);
+    EXPECT_EQ(record.servo.speed, 40);
+    EXPECT_TRUE(record.servo.error);
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.type, RecordType::ServoSetAngleLimits);
+    EXPECT_EQ(record.value, 10 | 170 << 16);
+    EXPECT_FALSE(reader.next(record));
+    EXPECT_FALSE(reader.isMalformed());
+}
+
+TEST(SerialProtocolTest, WriterStopsAtMaximumPayload)
+{
+    FrameWriter writer;
+    writer.begin(FrameType::Request);
+    size_t added = 0;
+    while (writer.add(RecordType::MotorSetPosition, 0, 1))
+        ++added;
+    EXPECT_EQ(added, kMaxPayload / 6);
+    EXPECT_LE(writer.getPayloadSize(), kMaxPayload);
+}
+
+TEST(SerialProtocolTest, ParsesFrameStraddlingRingWrapInPlace)
+{
+    ByteRing ring(4096);
+    const size_t capacity = ring.capacity();
+    auto frame = sampleFrame(7);
+
+    // Leave the write position a few bytes before the end of the ring
+    ring.commit(capacity - 5);
+    ring.consume(capacity - 5);
+    auto space = ring.writable();
+    std::copy(frame.begin(), frame.end(), space.begin());
+    ring.commit(frame.size());
+
+    FrameView view;
+    size_t consumed = 0;
+    ASSERT_EQ(parseFrame(ring.readable(), view, consumed), ParseStatus::Frame);
+    EXPECT_EQ(view.sequence, 7);
+    // The payload points into the ring's own mapping, not a copy
+    EXPECT_GE(view.payload.data(), ring.readable().data());
+    EXPECT_LT(view.payload.data(), ring.readable().data() + ring.size());
+    ring.consume(consumed);
+    EXPECT_EQ(ring.size(), 0u);
+}
+
+TEST(SerialProtocolTest, ResynchronisesAfterNoiseAndCorruptFrames)
+{
+    auto corrupt = sampleFrame(1);
+    corrupt[8] ^= 0xFF;
+    auto good = sampleFrame(2);
+    std::vector<uint8_t> stream = {0x00, 0xA5, 0x13, 0x5A};
+    stream.insert(stream.end(), corrupt.begin(), corrupt.end());
+    stream.insert(stream.end(), good.begin(), good.end());
+
+    std::span<const uint8_t> remaining(stream);
+    std::vector<uint8_t> sequences;
+    size_t discarded = 0;
+    for (;;)
+    {
+        FrameView frame;
+        size_t consumed = 0;
+        const ParseStatus status = parseFrame(remaining, frame, consumed);
+        if (status == ParseStatus::Frame)
+            sequences.push_back(frame.sequence);
+        else
+            discarded += consumed;
+        remaining = remaining.subspan(consumed);
+        if (status == ParseStatus::Incomplete)
+            break;
+    }
+    EXPECT_EQ(sequences, std::vector<uint8_t>{2});
+    EXPECT_EQ(discarded, 4 + corrupt.size());
+    EXPECT_TRUE(remaining.empty());
+}
+
+TEST(SerialProtocolTest, IncompleteFrameWaitsForMoreBytes)
+{
+    auto frame = sampleFrame(3);
+    std::vector<uint8_t> stream = {0x11, 0x22};
+    stream.insert(stream.end(), frame.begin(), frame.end() - 1);
+
+    FrameView view;
+    size_t consumed = 0;
+    EXPECT_EQ(parseFrame(stream, view, consumed), ParseStatus::Invalid);
+    EXPECT_EQ(consumed, 2u); // the noise in front of the sync
+    auto rest = std::span<const uint8_t>(stream).subspan(2);
+    EXPECT_EQ(parseFrame(rest, view, consumed), ParseStatus::Incomplete);
+    EXPECT_EQ(consumed, 0u);
+    stream.push_back(frame.back());
+    EXPECT_EQ(parseFrame(std::span<const uint8_t>(stream).subspan(2), view, consumed), ParseStatus::Frame);
+}
+
+TEST(SerialDevicesTest, ControlsEmulatedDevicesOverLoopback)
+{
+    LoopbackBridge bridge(2, 2);
+    SerialMotor motor(bridge.bus, 1);
+    SerialServo servo(bridge.bus, 0);
+
+    EXPECT_TRUE(motor.setPosition(2500));
+    EXPECT_EQ(motor.getCurrentPosition(), 2500);
+    EXPECT_EQ(bridge.emulator->getMotor(1).getCurrentPosition(), 2500);
+
+    EXPECT_TRUE(motor.setMaxSpeed(300));
+    EXPECT_EQ(motor.getMaxSpeed(), 300);
+    EXPECT_FALSE(motor.setSpeed(400));
+    EXPECT_TRUE(motor.getLastError().has_value());
+
+    EXPECT_TRUE(servo.setAngleLimits(20, 160));
+    EXPECT_EQ(servo.getAngleLimits(), (std::pair<uint16_t, uint16_t>{20, 160}));
+    EXPECT_EQ(bridge.emulator->getServo(0).getAngleLimits(), (std::pair<uint16_t, uint16_t>{20, 160}));
+    EXPECT_FALSE(servo.checkCommand(ServoCommand::angle(170)));
+    EXPECT_TRUE(servo.setAngle(90));
+    EXPECT_FALSE(servo.isError());
+
+    // Out-of-range device indices are refused by the bridge rather than ignored
+    SerialMotor missing(bridge.bus, 9);
+    EXPECT_FALSE(missing.stop());
+    EXPECT_TRUE(missing.isError());
+}
+
+TEST(SerialDevicesTest, ReadsSeveralDevicesInOneFrame)
+{
+    LoopbackBridge bridge(3, 2);
+    bridge.emulator->getMotor(2).setPosition(-77);
+    bridge.emulator->getServo(1).simulateError("jammed");
+
+    const uint8_t motors[] = {0, 2};
+    const uint8_t servos[] = {1};
+    MotorReading motorReadings[2];
+    ServoReading servoReadings[1];
+    const uint64_t before = bridge.emulator->getFramesReceived();
+    ASSERT_TRUE(bridge.bus->read(motors, motorReadings, servos, servoReadings));
+    EXPECT_EQ(bridge.emulator->getFramesReceived(), before + 1);
+    EXPECT_EQ(motorReadings[1].position, -77);
+    EXPECT_TRUE(servoReadings[0].error);
+    EXPECT_FALSE(motorReadings[0].error);
+}
+
+TEST(SerialDevicesTest, BatchIsSentAsOneFrame)
+{
+    LoopbackBridge bridge(2, 2);
+    DeviceManagerImpl manager;
+    auto motor0 = manager.registerMotor("m0", std::make_shared<SerialMotor>(bridge.bus, 0));
+    auto motor1 = manager.registerMotor("m1", std::make_shared<SerialMotor>(bridge.bus, 1));
+    auto servo0 = manager.registerServo("s0", std::make_shared<SerialServo>(bridge.bus, 0));
+    auto servo1 = manager.registerServo("s1", std::make_shared<SerialServo>(bridge.bus, 1));
+
+    CommandBatch batch;
+    batch.add(motor0, MotorCommand::position(100));
+    batch.add(motor1, MotorCommand::position(-100));
+    batch.add(servo0, ServoCommand::angle(45));
+    batch.add(servo1, ServoCommand::angle(135));
+    const uint64_t before = bridge.emulator->getFramesReceived();
+    ASSERT_TRUE(manager.applyBatch(batch));
+    EXPECT_EQ(bridge.emulator->getFramesReceived(), before + 1);
+    EXPECT_EQ(bridge.emulator->getMotor(0).getCurrentPosition(), 100);
+    EXPECT_EQ(bridge.emulator->getMotor(1).getCurrentPosition(), -100);
+
+    // An emergency stop of the whole bridge is one frame as well
+    const uint64_t beforeStop = bridge.emulator->getFramesReceived();
+    EXPECT_TRUE(manager.emergencyStopAll());
+    EXPECT_EQ(bridge.emulator->getFramesReceived(), beforeStop + 1);
+}
+
+TEST(SerialDevicesTest, WorksOverPseudoTerminal)
+{
+    auto emulator = FirmwareEmulator::createPty({1, 1});
+    if (!emulator)
+    {
+        GTEST_SKIP() << "no pseudo-terminal available";
+    }
+    auto link = SerialLink::open(emulator->getDevicePath());
+    ASSERT_NE(link, nullptr);
+    auto bus = std::make_shared<SerialBus>(std::move(link));
+    SerialMotor motor(bus, 0);
+    EXPECT_TRUE(motor.setPosition(-4200));
+    EXPECT_EQ(motor.getCurrentPosition(), -4200);
+    EXPECT_EQ(bus->getLink().getStats().timeouts, 0u);
+}
+
+TEST(SerialLinkTest, FailsPendingRequestsWhenPeerCloses)
+{
+    int hostFd = -1;
+    auto emulator = FirmwareEmulator::createLoopback({1, 0}, hostFd);
+    SerialBus bus(SerialLink::adopt(hostFd));
+    EXPECT_TRUE(bus.command(RecordType::MotorStop, 0));
+    emulator.reset();
+    EXPECT_FALSE(bus.command(RecordType::MotorStop, 0));
+    // The receive thread notices the hang-up on its own
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (bus.getLink().isConnected() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::yield();
+    EXPECT_FALSE(bus.getLink().isConnected());
+}
+
+// With no descriptor left for the eventfd that stops their threads, the factories refuse rather than hand
+// out an object whose destructor would hang
+TEST(SerialLinkTest, FactoriesFailWithoutAWakeDescriptor)
+{
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+    rlimit saved;
+    ASSERT_EQ(getrlimit(RLIMIT_NOFILE, &saved), 0);
+    // Descriptors are allocated lowest first, so capping the limit at the next free one leaves none
+    const int next = ::dup(fds[1]);
+    ASSERT_GE(next, 0);
+    ::close(next);
+    rlimit capped = saved;
+    capped.rlim_cur = static_cast<rlim_t>(next);
+    ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &capped), 0);
+
+    auto link = SerialLink::adopt(fds[0]);
+    const bool adoptedClosed = fcntl(fds[0], F_GETFD) < 0;
+    // The closed descriptor plus one more: room for the socket pair, none for the eventfd
+    capped.rlim_cur = static_cast<rlim_t>(next + 1);
+    setrlimit(RLIMIT_NOFILE, &capped);
+    int hostFd = -1;
+    auto emulator = FirmwareEmulator::createLoopback({1, 0}, hostFd);
+    setrlimit(RLIMIT_NOFILE, &saved);
+
+    EXPECT_EQ(link, nullptr);
+    EXPECT_TRUE(adoptedClosed);
+    EXPECT_EQ(emulator, nullptr);
+    EXPECT_EQ(hostFd, -1);
+    ::close(fds[1]);
+}
@@ -1,4 +1,5 @@
 #include "../src/mock/MockServo.hpp"
+#include "../src/mock/SimulationEngine.hpp"
 #include "../src/models/Servo.hpp"
 #include <chrono>
 #include <gtest/gtest.h>
@@ -12,7 +13,7 @@ class MockServoTest : public ::testing::Test
   protected:
     void SetUp() override
     {
-        servo = std::make_unique<MockServo>("test_servo");
+        servo = std::make_unique<MockServo>("test_servo", engine);
     }
 
     void TearDown() override
@@ -20,6 +21,8 @@ class MockServoTest : public ::testing::Test
         servo.reset();
     }
 
+    // Manually stepped, so the tests advance simulated time instead of sleeping
+    SimulationEngine engine;
     std::unique_ptr<MockServo> servo;
 };
 
@@ -41,7 +44,7 @@ TEST_F(MockServoTest, SetAngle)
     EXPECT_TRUE(servo->setAngleChecked(45));
     EXPECT_TRUE(servo->isMoving());
 
-    std::this_thread::sleep_for(100ms);
+    engine.advance(100ms);
     EXPECT_LT(servo->getCurrentAngle(), 90);
 }
 
@@ -77,7 +80,7 @@ TEST_F(MockServoTest, Stop)
     EXPECT_FALSE(servo->isMoving());
 
     auto angleAtStop = servo->getCurrentAngle();
-    std::this_thread::sleep_for(100ms);
+    engine.advance(100ms);
     EXPECT_EQ(servo->getCurrentAngle(), angleAtStop);
 }
 
@@ -121,7 +124,7 @@ TEST_F(MockServoTest, SimulateHardwareDelay)
     EXPECT_TRUE(servo->setAngleChecked(45));
 
     auto initialAngle = servo->getCurrentAngle();
-    std::this_thread::sleep_for(100ms);
+    engine.advance(100ms);
     auto angleAfterDelay = servo->getCurrentAngle();
 
     EXPECT_NE(angleAfterDelay, initialAngle);
@@ -133,16 +136,16 @@ TEST_F(MockServoTest, SpeedAffectsMovement)
     servo->setSpeedChecked(25);
     EXPECT_TRUE(servo->setAngleChecked(45));
     auto initialAngle = servo->getCurrentAngle();
-    std::this_thread::sleep_for(50ms);
+    engine.advance(50ms);
     auto angleAfterLowSpeed = servo->getCurrentAngle();
     auto lowSpeedChange = std::abs(angleAfterLowSpeed - initialAngle);
 
     servo->setAngleChecked(90);
-    std::this_thread::sleep_for(100ms);
+    engine.advance(100ms);
     servo->setSpeedChecked(75);
     EXPECT_TRUE(servo->setAngleChecked(45));
     initialAngle = servo->getCurrentAngle();
-    std::this_thread::sleep_for(50ms);
+    engine.advance(50ms);
     auto angleAfterHighSpeed = servo->getCurrentAngle();
     auto highSpeedChange = std::abs(angleAfterHighSpeed - initialAngle);
 
@@ -195,3 +198,51 @@ TEST(ServoModelTest, ErrorSimulationAndClearing)
     s.setAngle(10.0);
     EXPECT_DOUBLE_EQ(s.getAngle(), 10.0);
 }
+
+TEST(ServoModelTest, SnapshotMatchesGetters)
+{
+    ServoImpl s(-60.0, 60.0, 60.0, "servo5");
+    ServoSnapshot snapshot = s.getSnapshot();
+    EXPECT_DOUBLE_EQ(snapshot.angle, -60.0);
+    EXPECT_DOUBLE_EQ(snapshot.speed, 60.0);
+
+    s.setAngle(20.0);
+    s.setSpeed(30.0);
+    snapshot = s.getSnapshot();
+    EXPECT_DOUBLE_EQ(snapshot.angle, 20.0);
+    EXPECT_DOUBLE_EQ(snapshot.speed, 30.0);
+    EXPECT_TRUE(snapshot.moving);
+    EXPECT_FALSE(snapshot.error);
+
+    s.simulateError(true);
+    s.setAngle(0.0);
+    snapshot = s.getSnapshot();
+    EXPECT_DOUBLE_EQ(snapshot.angle, 20.0);
+    EXPECT_TRUE(snapshot.error);
+}
+
+TEST(MockServoWaitTest, WaitUntilStoppedWakesOnStop)
+{
+    MockServo servo("waiting_servo");
+    servo.simulateHardwareDelay(0ms);
+    ASSERT_TRUE(servo.setAngleChecked(150));
+    std::thread stopper([&] {
+        std::this_thread::sleep_for(10ms);
+        servo.stop();
+    });
+    EXPECT_TRUE(servo.waitUntilStopped(5s));
+    EXPECT_FALSE(servo.isMoving());
+    stopper.join();
+}
+
+TEST(ServoModelTest, WaitForErrorWakesOnSimulatedError)
+{
+    ServoImpl servo(0.0, 180.0, 50.0);
+    std::thread fault([&] {
+        std::this_thread::sleep_for(10ms);
+        servo.simulateError(true);
+        servo.setAngle(90); // the model only latches the error on its next command
+    });
+    EXPECT_TRUE(servo.waitForError(5s));
+    fault.join();
+}
@@ -0,0 +1,301 @@
+#include "core/DeviceManagerImpl.hpp"
+#include "core/SessionPlayer.hpp"
+#include "mock/MockMotor.hpp"
+#include "mock/MockServo.hpp"
+#include "mock/SimulationEngine.hpp"
+#include "models/GloveState.hpp"
+#include "utils/SessionRecording.hpp"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+using namespace FingerFlexAid;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+class SessionRecordingTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        path = (std::filesystem::temp_directory_path() /
+                std::string("fingerflexaid-session-").append(std::to_string(getpid())).append(".ffs"))
+                   .string();
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(path);
+    }
+
+    std::string path;
+};
+
+SessionRecord motorState(double speed)
+{
+    return SessionRecord::state(SessionRecordType::MotorState, "motor", speed, speed * 2, speed != 0, false);
+}
+
+} // namespace
+
+TEST_F(SessionRecordingTest, ReadsBackRecordsInOrder)
+{
+    {
+        auto recorder = SessionRecorder::create(path);
+        ASSERT_NE(recorder, nullptr);
+        for (int i = 0; i < 1000; ++i)
+            EXPECT_TRUE(recorder->record(motorState(i)));
+        EXPECT_EQ(recorder->getRecordedCount(), 1000u);
+    }
+
+    auto session = SessionReader::open(path);
+    ASSERT_NE(session, nullptr);
+    ASSERT_EQ(session->size(), 1000u);
+    EXPECT_EQ(std::filesystem::file_size(path), 64u + 1000u * sizeof(SessionRecord));
+    for (size_t i = 0; i < session->size(); ++i)
+    {
+        EXPECT_DOUBLE_EQ((*session)[i].speed, static_cast<double>(i));
+        EXPECT_EQ((*session)[i].getDevice(), "motor");
+        if (i > 0)
+        {
+            EXPECT_GE((*session)[i].timeNs, (*session)[i - 1].timeNs);
+        }
+    }
+    EXPECT_GT(session->getStartTime(), 0);
+}
+
+TEST_F(SessionRecordingTest, SeekFindsFirstRecordAtOrAfterTime)
+{
+    {
+        auto recorder = SessionRecorder::create(path);
+        ASSERT_NE(recorder, nullptr);
+        for (int i = 0; i < 5; ++i)
+        {
+            recorder->record(motorState(i));
+            std::this_thread::sleep_for(2ms);
+        }
+    }
+
+    auto session = SessionReader::open(path);
+    ASSERT_NE(session, nullptr);
+    ASSERT_EQ(session->size(), 5u);
+    for (size_t i = 0; i < session->size(); ++i)
+        EXPECT_EQ(session->seek((*session)[i].time()), i);
+    EXPECT_EQ(session->seek((*session)[2].time() + 1ns), 3u);
+    EXPECT_EQ(session->seek(0ns), 0u);
+    EXPECT_EQ(session->seek(session->getDuration() + 1ns), session->size());
+}
+
+TEST_F(SessionRecordingTest, DropsRecordsBeyondMaximumSize)
+{
+    auto recorder = SessionRecorder::create(path, 64 + 10 * sizeof(SessionRecord));
+    ASSERT_NE(recorder, nullptr);
+    for (int i = 0; i < 12; ++i)
+        recorder->record(motorState(i));
+    EXPECT_EQ(recorder->getRecordedCount(), 10u);
+    EXPECT_EQ(recorder->getDroppedCount(), 2u);
+}
+
+TEST_F(SessionRecordingTest, UnfinishedFileIsReadableWhileRecording)
+{
+    auto recorder = SessionRecorder::create(path);
+    ASSERT_NE(recorder, nullptr);
+    for (int i = 0; i < 3; ++i)
+        recorder->record(motorState(i));
+
+    auto session = SessionReader::open(path);
+    ASSERT_NE(session, nullptr);
+    EXPECT_EQ(session->size(), 3u);
+}
+
+TEST_F(SessionRecordingTest, RejectsOtherFiles)
+{
+    std::ofstream(path) << std::string(256, 'x');
+    EXPECT_EQ(SessionReader::open(path), nullptr);
+    EXPECT_EQ(SessionReader::open(path + ".missing"), nullptr);
+}
+
+TEST_F(SessionRecordingTest, ReplayReproducesRecordedSession)
+{
+    constexpr int kTicks = 60;
+    {
+        SimulationEngine engine;
+        auto motor = std::make_shared<MockMotor>("motor", engine);
+        auto servo = std::make_shared<MockServo>("servo", engine);
+        DeviceManagerImpl manager;
+        MotorHandle motorHandle = manager.registerMotor("motor", motor);
+        ServoHandle servoHandle = manager.registerServo("servo", servo);
+        EventLog log(64, nullptr);
+        GloveState glove(log);
+        glove.addMotor(motor);
+        glove.addServo(servo);
+
+        auto recorder = SessionRecorder::create(path);
+        ASSERT_NE(recorder, nullptr);
+        manager.setRecorder(recorder.get());
+        glove.setRecorder(recorder.get());
+        for (int tick = 0; tick < kTicks; ++tick)
+        {
+            if (tick % 20 == 0)
+            {
+                CommandBatch batch;
+                batch.add(motorHandle, MotorCommand::speed(static_cast<int16_t>(300 - tick * 10)));
+                batch.add(servoHandle, ServoCommand::angle(static_cast<uint16_t>(45 + tick)));
+                ASSERT_TRUE(manager.applyBatch(batch));
+            }
+            engine.advance(20ms);
+            glove.update();
+        }
+        manager.setRecorder(nullptr);
+        glove.setRecorder(nullptr);
+    }
+
+    auto session = SessionReader::open(path);
+    ASSERT_NE(session, nullptr);
+    EXPECT_EQ(session->size(), static_cast<size_t>(kTicks * 2 + 6));
+
+    SimulationEngine engine;
+    auto motor = std::make_shared<MockMotor>("motor", engine);
+    auto servo = std::make_shared<MockServo>("servo", engine);
+    DeviceManagerImpl manager;
+    manager.registerMotor("motor", motor);
+    manager.registerServo("servo", servo);
+
+    // Each recorded tick is commands, then one engine step, then the motor and servo states
+    SessionPlayer player(*session, manager);
+    SessionRecord record;
+    size_t compared = 0;
+    while (player.step(record))
+    {
+        if (record.type == SessionRecordType::MotorState)
+        {
+            engine.advance(20ms);
+            MotorSnapshot state = motor->getSnapshot();
+            EXPECT_EQ(state.speed, record.speed);
+            EXPECT_EQ(state.position, record.position);
+            ++compared;
+        }
+        else if (record.type == SessionRecordType::ServoState)
+        {
+            EXPECT_EQ(servo->getSnapshot().angle, record.position);
+            ++compared;
+        }
+    }
+    EXPECT_EQ(compared, static_cast<size_t>(kTicks * 2));
+    EXPECT_EQ(player.getFailedCount(), 0u);
+}
+
+TEST_F(SessionRecordingTest, AdvanceToAppliesCommandsUpToTime)
+{
+    {
+        auto recorder = SessionRecorder::create(path);
+        ASSERT_NE(recorder, nullptr);
+        recorder->record(SessionRecord::command(SessionRecordType::MotorCommand, "motor",
+                                                static_cast<uint8_t>(MotorCommand::Type::SetSpeed), 100));
+        std::this_thread::sleep_for(2ms);
+        recorder->record(motorState(100));
+        recorder->record(SessionRecord::command(SessionRecordType::MotorCommand, "missing",
+                                                static_cast<uint8_t>(MotorCommand::Type::Stop), 0));
+    }
+    auto session = SessionReader::open(path);
+    ASSERT_NE(session, nullptr);
+
+    SimulationEngine engine;
+    auto motor = std::make_shared<MockMotor>("motor", engine);
+    DeviceManagerImpl manager;
+    manager.registerMotor("motor", motor);
+    SessionPlayer player(*session, manager);
+
+    EXPECT_EQ(player.advanceTo((*session)[0].time()), 1u);
+    engine.advance(1s);
+    EXPECT_EQ(motor->getCurrentSpeed(), 100);
+    EXPECT_EQ(player.advanceTo(session->getDuration()), 1u);
+    EXPECT_TRUE(player.atEnd());
+    EXPECT_EQ(player.getFailedCount(), 1u);
+
+    player.seek((*session)[1].time());
+    EXPECT_EQ(player.getPosition(), 1u);
+}
+
+TEST_F(SessionRecordingTest, ReplayedEmergencyStopLeavesTheEpochAlone)
+{
+    {
+        auto recorder = SessionRecorder::create(path);
+        ASSERT_NE(recorder, nullptr);
+        recorder->record(SessionRecord::command(SessionRecordType::MotorCommand, "motor",
+                                                static_cast<uint8_t>(MotorCommand::Type::SetSpeed), 100));
+        recorder->record(SessionRecord::command(SessionRecordType::EmergencyStop, {}, 0, 0));
+    }
+    auto session = SessionReader::open(path);
+    ASSERT_NE(session, nullptr);
+
+    SimulationEngine engine;
+    auto motor = std::make_shared<MockMotor>("motor", engine);
+    auto servo = std::make_shared<MockServo>("servo", engine);
+    DeviceManagerImpl manager;
+    manager.registerMotor("motor", motor);
+    manager.registerServo("servo", servo);
+    const uint64_t epoch = manager.getEmergencyStop().epoch();
+
+    SessionPlayer player(*session, manager);
+    EXPECT_EQ(player.advanceTo(session->getDuration()), 2u);
+    EXPECT_TRUE(motor->isError());
+    EXPECT_TRUE(servo->isError());
+    EXPECT_EQ(manager.getEmergencyStop().epoch(), epoch);
+    EXPECT_EQ(player.getFailedCount(), 0u);
+}
+
+TEST_F(SessionRecordingTest, BatchesReplayAsOneGroup)
+{
+    {
+        auto recorder = SessionRecorder::create(path);
+        ASSERT_NE(recorder, nullptr);
+        SimulationEngine engine;
+        auto motor = std::make_shared<MockMotor>("motor", engine);
+        auto servo = std::make_shared<MockServo>("servo", engine);
+        DeviceManagerImpl manager;
+        manager.setRecorder(recorder.get());
+        CommandBatch batch;
+        batch.add(manager.registerMotor("motor", motor), MotorCommand::speed(100));
+        batch.add(manager.registerServo("servo", servo), ServoCommand::angle(60));
+        ASSERT_TRUE(manager.applyBatch(batch));
+        // Shares a timestamp with a command for a device the replay does not have
+        const SessionRecord pair[] = {
+            SessionRecord::command(SessionRecordType::MotorCommand, "motor",
+                                   static_cast<uint8_t>(MotorCommand::Type::SetSpeed), 200),
+            SessionRecord::command(SessionRecordType::MotorCommand, "missing",
+                                   static_cast<uint8_t>(MotorCommand::Type::Stop), 0)};
+        recorder->record(2, [&](size_t i) { return pair[i]; });
+        manager.setRecorder(nullptr);
+    }
+    auto session = SessionReader::open(path);
+    ASSERT_NE(session, nullptr);
+    ASSERT_EQ(session->size(), 4u);
+    EXPECT_EQ((*session)[0].time(), (*session)[1].time());
+    EXPECT_EQ((*session)[2].time(), (*session)[3].time());
+
+    SimulationEngine engine;
+    auto motor = std::make_shared<MockMotor>("motor", engine);
+    auto servo = std::make_shared<MockServo>("servo", engine);
+    DeviceManagerImpl manager;
+    manager.registerMotor("motor", motor);
+    manager.registerServo("servo", servo);
+    SessionPlayer player(*session, manager);
+
+    // Stepping onto the first command applies its whole batch
+    SessionRecord record;
+    ASSERT_TRUE(player.step(record));
+    engine.advance(std::chrono::seconds(1));
+    EXPECT_EQ(motor->getCurrentSpeed(), 100);
+    EXPECT_NEAR(servo->getCurrentAngle(), 60, 1);
+    EXPECT_EQ(player.advanceTo((*session)[1].time()), 0u);
+
+    // The refused group falls back to single commands, so the motor still gets its speed
+    EXPECT_EQ(player.advanceTo(session->getDuration()), 2u);
+    engine.advance(std::chrono::seconds(1));
+    EXPECT_EQ(motor->getCurrentSpeed(), 200);
+    EXPECT_EQ(player.getFailedCount(), 1u);
+}
@@ -0,0 +1,187 @@
+#include "../src/mock/MockMotor.hpp"
+#include "../src/mock/MockServo.hpp"
+#include "../src/mock/SimulationEngine.hpp"
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace FingerFlexAid;
+using namespace std::chrono_literals;
+
+TEST(SimulationEngineTest, AttachAndDetach)
+{
+    SimulationEngine engine;
+    {
+        MockMotor motor("m1", engine);
+        MockServo servo("s1", engine);
+        EXPECT_EQ(engine.getDeviceCount(), 2u);
+    }
+    EXPECT_EQ(engine.getDeviceCount(), 0u);
+}
+
+TEST(SimulationEngineTest, StepsAllDevicesFromOneThread)
+{
+    SimulationEngine engine;
+    std::vector<std::unique_ptr<MockMotor>> motors;
+    for (int i = 0; i < 50; ++i)
+        motors.push_back(std::make_unique<MockMotor>(std::string("m").append(std::to_string(i)), engine));
+    MockServo servo("s1", engine);
+
+    for (auto &m : motors)
+        EXPECT_TRUE(m->setSpeed(500));
+    EXPECT_TRUE(servo.setAngleChecked(45));
+
+    engine.start();
+    std::this_thread::sleep_for(100ms);
+    engine.stop();
+
+    for (auto &m : motors)
+        EXPECT_GT(m->getCurrentSpeed(), 0);
+    EXPECT_LT(servo.getCurrentAngle(), 90);
+}
+
+TEST(SimulationEngineTest, ManualAdvanceIsDeterministic)
+{
+    SimulationEngine a;
+    SimulationEngine b;
+    MockMotor ma("m1", a);
+    MockMotor mb("m1", b);
+    ma.setSpeed(500);
+    mb.setSpeed(500);
+
+    // One long step and many short ones integrate identically, with no wall-clock wait
+    a.advance(5s);
+    for (int i = 0; i < 500; ++i)
+        b.advance(10ms);
+
+    EXPECT_EQ(a.now(), 5s);
+    EXPECT_EQ(b.now(), 5s);
+    EXPECT_EQ(a.getTickStats().ticks, 250u);
+    EXPECT_EQ(ma.getCurrentSpeed(), mb.getCurrentSpeed());
+    EXPECT_EQ(ma.getCurrentPosition(), mb.getCurrentPosition());
+    EXPECT_NEAR(ma.getCurrentSpeed(), 500, 50);
+}
+
+TEST(SimulationEngineTest, CarriesPartialTicks)
+{
+    SimulationEngine engine(20ms);
+    engine.advance(15ms);
+    EXPECT_EQ(engine.now(), 0ms);
+    engine.advance(15ms);
+    EXPECT_EQ(engine.now(), 20ms);
+}
+
+TEST(SimulationEngineTest, ReportsTickDuration)
+{
+    SimulationEngine engine(5ms);
+    MockMotor motor("m1", engine);
+    engine.start();
+    std::this_thread::sleep_for(50ms);
+    engine.stop();
+
+    auto stats = engine.getTickStats();
+    EXPECT_GT(stats.ticks, 0u);
+    EXPECT_GE(stats.maxTick, stats.lastTick);
+    EXPECT_GE(stats.totalTick, stats.maxTick);
+    EXPECT_LE(stats.meanTick(), stats.maxTick);
+}
+
+TEST(SimulationEngineTest, EmergencyStopEpochHaltsDevicesOnNextTick)
+{
+    EmergencyStop stop;
+    SimulationEngine engine;
+    engine.watchEmergencyStop(&stop);
+    MockMotor motor("m1", engine);
+    MockServo servo("s1", engine);
+    motor.setSpeed(500);
+    servo.setAngleChecked(45);
+    engine.advance(200ms);
+    ASSERT_TRUE(motor.isMoving());
+
+    // Nothing commands the devices directly; the engine notices the new epoch on its own
+    stop.trigger();
+    engine.advance(engine.getTickPeriod());
+    EXPECT_FALSE(motor.isMoving());
+    EXPECT_EQ(motor.getCurrentSpeed(), 0);
+    EXPECT_FALSE(servo.isMoving());
+
+    double angle = servo.getAngle();
+    engine.advance(1s);
+    EXPECT_EQ(servo.getAngle(), angle);
+}
+
+TEST(SimulationEngineTest, IgnoresEpochsItDoesNotWatch)
+{
+    EmergencyStop watched;
+    EmergencyStop other;
+    SimulationEngine engine;
+    engine.watchEmergencyStop(&watched);
+    MockMotor motor("m1", engine);
+    motor.setSpeed(500);
+    engine.advance(200ms);
+
+    other.trigger();
+    engine.advance(engine.getTickPeriod());
+    EXPECT_TRUE(motor.isMoving());
+
+    engine.watchEmergencyStop(nullptr);
+    watched.trigger();
+    engine.advance(engine.getTickPeriod());
+    EXPECT_TRUE(motor.isMoving());
+}
+
+TEST(SimulationEngineTest, StopInterruptsTheTickWait)
+{
+    SimulationEngine engine(std::chrono::milliseconds(10s));
+    engine.start();
+    std::this_thread::sleep_for(5ms); // let the thread reach its wait
+    const auto begin = std::chrono::steady_clock::now();
+    engine.stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - begin, 1s);
+    EXPECT_FALSE(engine.isRunning());
+    EXPECT_EQ(engine.getTickStats().ticks, 0u);
+
+    // Can be started again after a stop, and after a bare stop request
+    engine.start();
+    EXPECT_TRUE(engine.isRunning());
+    engine.requestStop();
+    EXPECT_FALSE(engine.isRunning());
+    engine.start();
+    EXPECT_TRUE(engine.isRunning());
+}
+
+TEST(SimulationEngineTest, ReadsDoNotWaitForTheEngineLock)
+{
+    SimulationEngine engine;
+    MockMotor motor("m1", engine);
+    MockServo servo("s1", engine);
+    EXPECT_TRUE(motor.setSpeed(300));
+    EXPECT_TRUE(servo.setAngleChecked(45));
+    engine.advance(1s);
+    const int16_t speed = motor.getCurrentSpeed();
+    const uint16_t angle = servo.getCurrentAngle();
+    EXPECT_GT(speed, 0);
+    EXPECT_LT(angle, 90);
+
+    // Held as a tick holds it; every getter must still answer from the readouts
+    auto lock = engine.lock();
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        EXPECT_EQ(motor.getCurrentSpeed(), speed);
+        EXPECT_TRUE(motor.isMoving());
+        EXPECT_FALSE(motor.isError());
+        EXPECT_EQ(motor.getMaxSpeed(), 1000);
+        EXPECT_EQ(servo.getCurrentAngle(), angle);
+        EXPECT_TRUE(servo.isMoving());
+        EXPECT_EQ(servo.getAngleLimits(), (std::pair<uint16_t, uint16_t>{0, 180}));
+        done = true;
+    });
+    for (int i = 0; i < 200 && !done; ++i)
+        std::this_thread::sleep_for(5ms);
+    EXPECT_TRUE(done);
+    lock.unlock();
+    reader.join();
+}
@@ -0,0 +1,210 @@
+#include "mock/MockMotor.hpp"
+#include "mock/MockServo.hpp"
+#include "mock/SimulationEngine.hpp"
+#include "models/Motor.hpp"
+#include "models/Servo.hpp"
+#include "utils/Telemetry.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace FingerFlexAid;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+TelemetryRecord makeRecord(double speed)
+{
+    TelemetryRecord record;
+    record.speed = speed;
+    record.position = speed * 2;
+    return record;
+}
+
+std::vector<TelemetryRecord> readAll(TelemetryReader &reader)
+{
+    std::vector<TelemetryRecord> records;
+    TelemetryRecord record;
+    while (reader.next(record))
+        records.push_back(record);
+    return records;
+}
+
+std::string uniqueName(const char *test)
+{
+    return std::string("/fingerflexaid-test-").append(test).append("-").append(std::to_string(getpid()));
+}
+
+} // namespace
+
+TEST(TelemetryTest, ReaderSeesRecordsPublishedAfterIt)
+{
+    TelemetryRing ring(16);
+    ring.publish(makeRecord(1));
+
+    TelemetryReader reader(ring);
+    ring.publish(makeRecord(2));
+    ring.publish(makeRecord(3));
+
+    auto records = readAll(reader);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_DOUBLE_EQ(records[0].speed, 2);
+    EXPECT_DOUBLE_EQ(records[1].position, 6);
+    EXPECT_EQ(ring.getPublishedCount(), 3u);
+}
+
+TEST(TelemetryTest, EveryReaderSeesEveryRecord)
+{
+    TelemetryRing ring(16);
+    TelemetryReader first(ring);
+    TelemetryReader second(ring);
+    for (int i = 0; i < 5; ++i)
+        ring.publish(makeRecord(i));
+
+    EXPECT_EQ(readAll(first).size(), 5u);
+    EXPECT_EQ(readAll(second).size(), 5u);
+}
+
+TEST(TelemetryTest, LappedReaderSkipsAheadAndCountsLoss)
+{
+    TelemetryRing ring(8);
+    TelemetryReader reader(ring);
+    for (int i = 0; i < 20; ++i)
+        ring.publish(makeRecord(i));
+
+    auto records = readAll(reader);
+    ASSERT_EQ(records.size(), ring.getCapacity());
+    EXPECT_DOUBLE_EQ(records.front().speed, 12);
+    EXPECT_DOUBLE_EQ(records.back().speed, 19);
+    EXPECT_EQ(reader.getLostCount(), 12u);
+}
+
+TEST(TelemetryTest, ConcurrentPublishersDeliverIntactRecords)
+{
+    TelemetryRing ring(1 << 16);
+    TelemetryReader reader(ring);
+    std::vector<std::thread> publishers;
+    for (int t = 0; t < 4; ++t)
+        publishers.emplace_back([&ring] {
+            for (int i = 0; i < 5000; ++i)
+                ring.publish(makeRecord(i));
+        });
+    for (auto &publisher : publishers)
+        publisher.join();
+
+    auto records = readAll(reader);
+    EXPECT_EQ(records.size(), 20000u);
+    for (const auto &record : records)
+        EXPECT_DOUBLE_EQ(record.position, record.speed * 2);
+}
+
+TEST(TelemetryTest, SharedMemoryRingIsReadableThroughItsName)
+{
+    const std::string name = uniqueName("shared");
+    auto ring = TelemetryRing::createShared(name, 32);
+    ASSERT_NE(ring, nullptr);
+    EXPECT_EQ(ring->getName(), name);
+
+    auto reader = TelemetryReader::openShared(name);
+    ASSERT_NE(reader, nullptr);
+    ring->publish(makeRecord(7));
+    auto records = readAll(*reader);
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_DOUBLE_EQ(records[0].speed, 7);
+
+    ring.reset();
+    EXPECT_EQ(TelemetryReader::openShared(name), nullptr);
+}
+
+TEST(TelemetryTest, SharedMemoryRingLeavesALiveRingAlone)
+{
+    const std::string name = uniqueName("taken");
+    auto ring = TelemetryRing::createShared(name, 32);
+    ASSERT_NE(ring, nullptr);
+    EXPECT_EQ(TelemetryRing::createShared(name, 32), nullptr);
+
+    auto reader = TelemetryReader::openShared(name);
+    ASSERT_NE(reader, nullptr);
+    ring->publish(makeRecord(3));
+    EXPECT_EQ(readAll(*reader).size(), 1u);
+
+    // Asked to, it takes the name over; the old ring's readers keep their mapping
+    auto replacement = TelemetryRing::createShared(name, 32, TelemetryRing::Existing::Replace);
+    ASSERT_NE(replacement, nullptr);
+    auto replacementReader = TelemetryReader::openShared(name);
+    ASSERT_NE(replacementReader, nullptr);
+    replacement->publish(makeRecord(4));
+    auto records = readAll(*replacementReader);
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_DOUBLE_EQ(records[0].speed, 4);
+
+    ring.reset(); // must not unlink the replacement's object
+    EXPECT_NE(TelemetryReader::openShared(name), nullptr);
+    replacement.reset();
+    EXPECT_EQ(TelemetryReader::openShared(name), nullptr);
+}
+
+TEST(TelemetryTest, MotorAndServoPublishStateChanges)
+{
+    TelemetryRing ring(64);
+    TelemetryReader reader(ring);
+    Motor motor("motor_with_a_very_long_identifier", 50.0, 1.0);
+    ServoImpl servo(0, 180, 50, "servo");
+    motor.attachTelemetry(&ring);
+    servo.attachTelemetry(&ring);
+
+    motor.setSpeed(20.0);
+    servo.setAngle(30.0);
+    motor.simulateError("stalled");
+
+    auto records = readAll(reader);
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records[0].kind, TelemetryKind::Motor);
+    EXPECT_EQ(std::string(records[0].device), std::string("motor_with_a_very_long_identifier").substr(0, 23));
+    EXPECT_DOUBLE_EQ(records[0].speed, 20.0);
+    EXPECT_TRUE(records[0].moving);
+    EXPECT_EQ(records[1].kind, TelemetryKind::Servo);
+    EXPECT_DOUBLE_EQ(records[1].position, 30.0);
+    EXPECT_TRUE(records[2].error);
+}
+
+TEST(TelemetryTest, MocksPublishEverySimulatedStep)
+{
+    TelemetryRing ring(1024);
+    SimulationEngine engine;
+    MockMotor motor("mock_motor", engine);
+    MockServo servo("mock_servo", engine);
+    motor.attachTelemetry(&ring);
+    servo.attachTelemetry(&ring);
+    TelemetryReader reader(ring);
+
+    motor.setSpeed(int16_t{100});
+    servo.setAngle(uint16_t{120});
+    engine.advance(200ms);
+
+    size_t motorRecords = 0;
+    size_t servoRecords = 0;
+    for (const auto &record : readAll(reader))
+    {
+        if (record.kind == TelemetryKind::Motor)
+        {
+            EXPECT_EQ(std::string(record.device), "mock_motor");
+            ++motorRecords;
+        }
+        else
+        {
+            EXPECT_EQ(std::string(record.device), "mock_servo");
+            ++servoRecords;
+        }
+    }
+    EXPECT_GE(motorRecords, 10u);
+    EXPECT_GE(servoRecords, 10u);
+
+    motor.attachTelemetry(nullptr);
+    servo.attachTelemetry(nullptr);
+    engine.advance(100ms);
+    EXPECT_TRUE(readAll(reader).empty());
+}
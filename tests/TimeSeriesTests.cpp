@@ -0,0 +1,143 @@
+#include "utils/TimeSeries.hpp"
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace FingerFlexAid;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+TelemetryRecord makeRecord(const char *device, int64_t timestampNs, double speed, double position)
+{
+    TelemetryRecord record;
+    record.timestampNs = timestampNs;
+    record.speed = speed;
+    record.position = position;
+    std::strncpy(record.device, device, TelemetryRecord::kDeviceLength - 1);
+    return record;
+}
+
+} // namespace
+
+TEST(TimeSeriesTest, RoundTripsJitteredSamplesExactly)
+{
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int64_t> jitter(-300, 300);
+    std::uniform_real_distribution<double> noise(-1000, 1000);
+    std::uniform_int_distribution<int64_t> gap(0, 9);
+
+    TimeSeries series;
+    std::vector<TimeSample> expected;
+    int64_t time = 1'000'000;
+    double position = 0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        // Mostly a 10 ms period with jitter, occasional long gaps, and a mix of smooth and random values
+        time += 10'000 + jitter(rng) + (gap(rng) == 0 ? 5'000'000 : 0);
+        position += 0.25;
+        double value = (i % 3 == 0) ? noise(rng) : position;
+        ASSERT_TRUE(series.append(std::chrono::microseconds(time), value));
+        expected.push_back({std::chrono::microseconds(time), value});
+    }
+
+    EXPECT_EQ(series.getSampleCount(), expected.size());
+    EXPECT_GT(series.getBlockCount(), 1u);
+    EXPECT_EQ(series.query(std::chrono::microseconds::min(), std::chrono::microseconds::max()), expected);
+}
+
+TEST(TimeSeriesTest, PreservesSpecialValuesBitForBit)
+{
+    const std::vector<double> values = {0.0,
+                                        -0.0,
+                                        std::numeric_limits<double>::infinity(),
+                                        -std::numeric_limits<double>::infinity(),
+                                        std::numeric_limits<double>::quiet_NaN(),
+                                        std::numeric_limits<double>::denorm_min(),
+                                        std::numeric_limits<double>::max(),
+                                        1.0};
+    TimeSeries series;
+    for (size_t i = 0; i < values.size(); ++i)
+        ASSERT_TRUE(series.append(std::chrono::microseconds(i), values[i]));
+
+    auto samples = series.query(0us, 1s);
+    ASSERT_EQ(samples.size(), values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+        EXPECT_EQ(std::bit_cast<uint64_t>(samples[i].value), std::bit_cast<uint64_t>(values[i])) << i;
+}
+
+TEST(TimeSeriesTest, RangeQueryDecodesOnlyOverlappingBlocks)
+{
+    TimeSeries series;
+    for (int i = 0; i < 100000; ++i)
+        series.append(std::chrono::microseconds(i * 1000), std::sin(i * 0.01));
+    ASSERT_GT(series.getBlockCount(), 10u);
+
+    std::vector<TimeSample> samples;
+    size_t decoded = series.query(50'000'000us, 50'100'000us, samples);
+    EXPECT_LE(decoded, 2u);
+    ASSERT_EQ(samples.size(), 101u);
+    EXPECT_EQ(samples.front().time, 50'000'000us);
+    EXPECT_EQ(samples.back().time, 50'100'000us);
+    EXPECT_EQ(samples.front().value, std::sin(50000 * 0.01));
+
+    samples.clear();
+    EXPECT_EQ(series.query(200'000'000us, 300'000'000us, samples), 0u);
+    EXPECT_TRUE(samples.empty());
+}
+
+TEST(TimeSeriesTest, RejectsSamplesOutOfTimeOrder)
+{
+    TimeSeries series;
+    EXPECT_TRUE(series.append(10us, 1.0));
+    EXPECT_TRUE(series.append(10us, 2.0)); // equal timestamps are allowed
+    EXPECT_FALSE(series.append(9us, 3.0));
+
+    auto samples = series.query(0us, 100us);
+    ASSERT_EQ(samples.size(), 2u);
+    EXPECT_EQ(samples[1].value, 2.0);
+}
+
+TEST(TimeSeriesTest, RegularConstantSeriesTakesAboutTwoBitsPerSample)
+{
+    TimeSeries series;
+    const size_t count = 100000;
+    for (size_t i = 0; i < count; ++i)
+        series.append(std::chrono::microseconds(i * 20000), 42.5);
+    EXPECT_LT(series.getCompressedBytes(), count / 2);
+}
+
+TEST(TimeSeriesStoreTest, IngestsTelemetryIntoPerDeviceChannels)
+{
+    TimeSeriesStore store;
+    store.ingest(makeRecord("thumb", 1'000'000, 100, 5));
+    store.ingest(makeRecord("index", 1'500'000, 0, 90));
+    store.ingest(makeRecord("thumb", 2'000'000, 120, 7));
+
+    EXPECT_EQ(store.getChannels(),
+              (std::vector<std::string>{"index.position", "index.speed", "thumb.position", "thumb.speed"}));
+    ASSERT_NE(store.find("thumb.position"), nullptr);
+    EXPECT_EQ(store.find("thumb.position")->query(0us, 1s),
+              (std::vector<TimeSample>{{1000us, 5}, {2000us, 7}}));
+    EXPECT_EQ(store.find("index.speed")->getSampleCount(), 1u);
+    EXPECT_EQ(store.find("middle.speed"), nullptr);
+    EXPECT_GT(store.getCompressedBytes(), 0u);
+}
+
+TEST(TimeSeriesStoreTest, DrainsATelemetryReader)
+{
+    TelemetryRing ring(64);
+    TelemetryReader reader(ring);
+    for (int i = 0; i < 10; ++i)
+        ring.publish(makeRecord("wrist", (i + 1) * 1'000'000, i, i * 2));
+
+    TimeSeriesStore store;
+    EXPECT_EQ(store.ingest(reader), 10u);
+    EXPECT_EQ(store.ingest(reader), 0u);
+    EXPECT_EQ(store.find("wrist.speed")->getSampleCount(), 10u);
+}
@@ -0,0 +1,239 @@
+#include "core/DeviceManagerImpl.hpp"
+#include "core/Routine.hpp"
+#include "core/Trajectory.hpp"
+#include "mock/MockMotor.hpp"
+#include "mock/MockServo.hpp"
+#include "mock/SimulationEngine.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <memory>
+
+using namespace FingerFlexAid;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+MotionLimits limits(double velocity, double acceleration, double jerk = 0)
+{
+    MotionLimits result;
+    result.maxVelocity = velocity;
+    result.maxAcceleration = acceleration;
+    result.maxJerk = jerk;
+    return result;
+}
+
+// Largest velocity, acceleration and jerk seen by finite differences over the whole trajectory
+struct Observed
+{
+    double velocity = 0;
+    double acceleration = 0;
+    double jerk = 0;
+};
+
+Observed observe(const Trajectory &trajectory)
+{
+    constexpr auto kStep = 100us;
+    constexpr double dt = 1e-4;
+    Observed observed;
+    double previousVelocity = 0;
+    double previousAcceleration = 0;
+    for (auto t = kStep; t <= trajectory.getDuration() + 10 * kStep; t += kStep)
+    {
+        const double velocity = trajectory.velocityAt(t);
+        const double acceleration = (velocity - previousVelocity) / dt;
+        observed.velocity = std::max(observed.velocity, std::abs(velocity));
+        observed.acceleration = std::max(observed.acceleration, std::abs(acceleration));
+        observed.jerk = std::max(observed.jerk, std::abs(acceleration - previousAcceleration) / dt);
+        previousVelocity = velocity;
+        previousAcceleration = acceleration;
+    }
+    return observed;
+}
+
+ExerciseRoutine fingerFlex()
+{
+    ExerciseRoutine routine;
+    routine.name = "finger-flex";
+    routine.tracks.push_back({"servo", ActuatorKind::Servo, 90, {{150, 200ms}, {40, 0ms}}});
+    routine.tracks.push_back({"motor", ActuatorKind::Motor, 0, {{2000, 0ms}}});
+    return routine;
+}
+
+} // namespace
+
+TEST(TrajectoryTest, TrapezoidCruisesAtTheVelocityLimit)
+{
+    Trajectory trajectory(0, limits(100, 400));
+    ASSERT_TRUE(trajectory.moveTo(1000, ProfileShape::Trapezoidal));
+
+    // 0.25 s ramps covering 25 each, 9.5 s cruising over the remaining 950
+    EXPECT_NEAR(std::chrono::duration<double>(trajectory.getDuration()).count(), 10.25, 1e-9);
+    EXPECT_NEAR(trajectory.velocityAt(5s), 100, 1e-9);
+    EXPECT_NEAR(trajectory.sample(125ms), 0.5 * 400 * 0.125 * 0.125, 1e-9);
+    EXPECT_DOUBLE_EQ(trajectory.sample(trajectory.getDuration()), 1000);
+    EXPECT_NEAR(trajectory.sample(trajectory.getDuration() - 1ns), 1000, 1e-6);
+}
+
+TEST(TrajectoryTest, ShortTrapezoidPeaksBelowTheVelocityLimit)
+{
+    Trajectory trajectory(10, limits(100, 400));
+    ASSERT_TRUE(trajectory.moveTo(0, ProfileShape::Trapezoidal));
+
+    // Too short to reach 100: accelerates for half the distance, then decelerates
+    const double peak = std::sqrt(10 * 400.0);
+    EXPECT_NEAR(std::chrono::duration<double>(trajectory.getDuration()).count(), 2 * peak / 400, 1e-9);
+    EXPECT_NEAR(trajectory.velocityAt(trajectory.getDuration() / 2), -peak, 1e-6);
+    EXPECT_LE(observe(trajectory).velocity, 100);
+}
+
+TEST(TrajectoryTest, SCurveRespectsEveryLimit)
+{
+    for (double target : {1.0, 30.0, 500.0, -2000.0})
+    {
+        Trajectory trajectory(0, limits(200, 1000, 20000));
+        ASSERT_TRUE(trajectory.moveTo(target, ProfileShape::SCurve));
+        Observed observed = observe(trajectory);
+        EXPECT_LE(observed.velocity, 200 * (1 + 1e-9)) << target;
+        EXPECT_LE(observed.acceleration, 1000 * 1.01) << target;
+        EXPECT_LE(observed.jerk, 20000 * 1.01) << target;
+        EXPECT_DOUBLE_EQ(trajectory.getEndPosition(), target);
+        EXPECT_NEAR(trajectory.sample(trajectory.getDuration() - 1ns), target, 1e-6) << target;
+    }
+}
+
+TEST(TrajectoryTest, SCurveIsSmootherThanTrapezoid)
+{
+    Trajectory trapezoid(0, limits(200, 1000, 20000));
+    Trajectory scurve(0, limits(200, 1000, 20000));
+    trapezoid.moveTo(500, ProfileShape::Trapezoidal);
+    scurve.moveTo(500, ProfileShape::SCurve);
+
+    // Same limits, so the S-curve takes longer but never steps its acceleration
+    EXPECT_GT(scurve.getDuration(), trapezoid.getDuration());
+    EXPECT_GT(observe(trapezoid).jerk, 100 * observe(scurve).jerk);
+}
+
+TEST(TrajectoryTest, CursorSamplingMatchesSearch)
+{
+    Trajectory trajectory(0, limits(50, 200, 2000));
+    for (double target : {100.0, -40.0, 60.0, 60.0, 0.0})
+    {
+        trajectory.moveTo(target, ProfileShape::SCurve);
+        trajectory.hold(150ms);
+    }
+
+    size_t cursor = 0;
+    for (auto t = 0ms; t <= trajectory.getDuration() + 1s; t += 7ms)
+        ASSERT_EQ(trajectory.sample(t, cursor), trajectory.sample(t)) << t.count();
+    // Going backwards falls back to a search
+    EXPECT_EQ(trajectory.sample(1s, cursor), trajectory.sample(1s));
+}
+
+TEST(TrajectoryTest, ClampsToPositionLimits)
+{
+    MotionLimits bounded = limits(90, 360, 3600);
+    bounded.minPosition = 20;
+    bounded.maxPosition = 160;
+    Trajectory trajectory(90, bounded);
+    ASSERT_TRUE(trajectory.moveTo(200, ProfileShape::SCurve));
+    EXPECT_DOUBLE_EQ(trajectory.getEndPosition(), 160);
+    for (auto t = 0ms; t <= trajectory.getDuration(); t += 5ms)
+        ASSERT_LE(trajectory.sample(t), 160);
+}
+
+TEST(TrajectoryTest, RefusesLimitsThatAllowNoMotion)
+{
+    Trajectory trajectory(0, limits(100, 400));
+    EXPECT_FALSE(trajectory.moveTo(10, ProfileShape::SCurve)); // no jerk limit
+    EXPECT_FALSE(Trajectory(0, limits(0, 400)).moveTo(10, ProfileShape::Trapezoidal));
+    EXPECT_TRUE(trajectory.getSegments().empty());
+}
+
+TEST(RoutineTest, CacheReusesCompiledRoutineUntilLimitsChange)
+{
+    SimulationEngine engine;
+    auto servo = std::make_shared<MockServo>("servo", engine);
+    auto motor = std::make_shared<MockMotor>("motor", engine);
+    DeviceManagerImpl manager;
+    manager.registerServo("servo", servo);
+    manager.registerMotor("motor", motor);
+
+    RoutineCache cache;
+    auto first = cache.get(fingerFlex(), manager);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(cache.get(fingerFlex(), manager), first);
+    EXPECT_EQ(cache.getCompileCount(), 1u);
+
+    ASSERT_TRUE(servo->setMaxSpeed(10));
+    auto slower = cache.get(fingerFlex(), manager);
+    ASSERT_NE(slower, nullptr);
+    EXPECT_NE(slower, first);
+    EXPECT_GT(slower->getTracks()[0].trajectory.getDuration(), first->getTracks()[0].trajectory.getDuration());
+    EXPECT_EQ(cache.getCompileCount(), 2u);
+    EXPECT_EQ(cache.size(), 1u);
+
+    ExerciseRoutine missing = fingerFlex();
+    missing.tracks[0].device = "absent";
+    EXPECT_EQ(cache.get(missing, manager), nullptr);
+}
+
+TEST(RoutineTest, PlayerDrivesDevicesThroughTheRoutine)
+{
+    SimulationEngine engine;
+    auto servo = std::make_shared<MockServo>("servo", engine);
+    auto motor = std::make_shared<MockMotor>("motor", engine);
+    DeviceManagerImpl manager;
+    manager.registerServo("servo", servo);
+    manager.registerMotor("motor", motor);
+
+    auto routine = RoutineCache().get(fingerFlex(), manager);
+    ASSERT_NE(routine, nullptr);
+    RoutinePlayer player(routine, manager);
+    ASSERT_TRUE(player.isReady());
+
+    uint16_t peak = 0;
+    auto elapsed = 0ms;
+    for (; !player.isFinished(elapsed); elapsed += 20ms)
+    {
+        ASSERT_TRUE(player.tick(elapsed));
+        engine.advance(20ms);
+        peak = std::max(peak, servo->getCurrentAngle());
+    }
+    ASSERT_TRUE(player.tick(elapsed));
+    // The mock servo eases into its target, so give it time to settle
+    engine.advance(2s);
+
+    EXPECT_GE(peak, 145);
+    EXPECT_NEAR(servo->getCurrentAngle(), 40, 1);
+    EXPECT_EQ(motor->getCurrentPosition(), 2000);
+}
+
+TEST(RoutineTest, PlayerResendsSetpointsAfterAnEmergencyStop)
+{
+    SimulationEngine engine;
+    auto servo = std::make_shared<MockServo>("servo", engine);
+    auto motor = std::make_shared<MockMotor>("motor", engine);
+    DeviceManagerImpl manager;
+    manager.registerServo("servo", servo);
+    manager.registerMotor("motor", motor);
+
+    auto routine = RoutineCache().get(fingerFlex(), manager);
+    ASSERT_NE(routine, nullptr);
+    RoutinePlayer player(routine, manager);
+    const auto end = std::chrono::duration_cast<std::chrono::milliseconds>(routine->getDuration());
+    ASSERT_TRUE(player.tick(end));
+    engine.advance(2s);
+    ASSERT_NEAR(servo->getCurrentAngle(), 40, 1);
+
+    // The stop and whatever moves the servo afterwards leave it off the setpoint the player last sent
+    manager.emergencyStopAll();
+    servo->clearError();
+    motor->clearError();
+    ASSERT_TRUE(servo->setAngleChecked(90));
+    engine.advance(2s);
+
+    ASSERT_TRUE(player.tick(end));
+    engine.advance(2s);
+    EXPECT_NEAR(servo->getCurrentAngle(), 40, 1);
+}